@@ -31,6 +31,7 @@
 #include "taskbar.h"
 #include "log.h"
 #include "calladmin-client.h"
+#include "resources.h"
 
 
 // WX
@@ -101,11 +102,7 @@ AboutPanel::AboutPanel(wxNotebook* note) : wxPanel(note, wxID_ANY)
 
 
 	// Banner
-	#if defined(__WXMSW__)
-		sizerTop->Add(new wxStaticBitmap(this, wxID_ANY, wxBitmap(wxImage("calladmin_banner", wxBITMAP_TYPE_RESOURCE))), flags);
-	#else
-		sizerTop->Add(new wxStaticBitmap(this, wxID_ANY, wxBitmap(wxImage(getAppPath("resources/calladmin_banner.bmp")))), flags);
-	#endif
+	sizerTop->Add(new wxStaticBitmap(this, wxID_ANY, getResourceBitmap("calladmin_banner")), flags);
 
 
 	// Box for Current Version
@@ -203,7 +200,7 @@ AboutPanel::AboutPanel(wxNotebook* note) : wxPanel(note, wxID_ANY)
 void AboutPanel::OnUpdate(wxCommandEvent& WXUNUSED(event))
 {
 	// Log Action
-	LogAction("Check for a new Update");
+	LOG(LOG_CATEGORY_UPDATE, LOG_LEVEL_INFO, "Check for a new Update");
 
 	checkUpdate();
 }
@@ -215,7 +212,7 @@ void AboutPanel::OnUpdate(wxCommandEvent& WXUNUSED(event))
 void AboutPanel::OnDownload(wxCommandEvent& WXUNUSED(event))
 {
 	// Log Action
-	LogAction("Download new Update");
+	LOG(LOG_CATEGORY_UPDATE, LOG_LEVEL_INFO, "Download new Update");
 
 
 	// Open Update Dialog
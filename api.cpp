@@ -0,0 +1,723 @@
+/**
+ * -----------------------------------------------------
+ * File        api.cpp
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+// c++ libs
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+// Parsers
+#include "tinyxml2/tinyxml2.h"
+#include "json.h"
+
+// Project
+#include "api.h"
+#include "codec.h"
+
+
+
+// We need something to print for a XML Error!
+static const char* XMLErrorString[20] =
+{
+	"XML_NO_ERROR",
+
+	"XML_NO_ATTRIBUTE",
+	"XML_WRONG_ATTRIBUTE_TYPE",
+
+	"XML_ERROR_FILE_NOT_FOUND",
+	"XML_ERROR_FILE_COULD_NOT_BE_OPENED",
+	"XML_ERROR_FILE_READ_ERROR",
+	"XML_ERROR_ELEMENT_MISMATCH",
+	"XML_ERROR_PARSING_ELEMENT",
+	"XML_ERROR_PARSING_ATTRIBUTE",
+	"XML_ERROR_IDENTIFYING_TAG",
+	"XML_ERROR_PARSING_TEXT",
+	"XML_ERROR_PARSING_CDATA",
+	"XML_ERROR_PARSING_COMMENT",
+	"XML_ERROR_PARSING_DECLARATION",
+	"XML_ERROR_PARSING_UNKNOWN",
+	"XML_ERROR_EMPTY_DOCUMENT",
+	"XML_ERROR_MISMATCHED_ELEMENT",
+	"XML_ERROR_PARSING",
+
+	"XML_CAN_NOT_CONVERT_TEXT",
+	"XML_NO_TEXT_NODE"
+};
+
+
+
+// Receives the content of a response, whatever format it came in
+//
+// A response is a root with values (<error>, <foundRows>, ...) and records
+// (<singleReport>, ...) holding fields
+class ApiHandler
+{
+public:
+	virtual ~ApiHandler() {}
+
+	// Value directly below the root
+	virtual void onValue(const char* name, const char* value) = 0;
+
+	// Field of the n-th record below the root
+	virtual void onField(int record, const char* name, const char* value) = 0;
+
+	// Body in the binary format, behind the magic
+	virtual bool onBinary(char*, size_t, ApiResponse& response)
+	{
+		response.error = "BINARY_ERROR_UNSUPPORTED";
+
+		return false;
+	}
+};
+
+
+
+
+// Walk a xml response
+static bool walkXML(char* body, size_t length, ApiHandler& handler, ApiResponse& response)
+{
+	tinyxml2::XMLDocument doc;
+
+	// Parse the xml data in place, body[length] is ours to terminate
+	tinyxml2::XMLError parseError = doc.ParseInSitu(body, length);
+
+	if (parseError != tinyxml2::XML_SUCCESS)
+	{
+		response.error = (parseError >= 0 && parseError < 20) ? XMLErrorString[parseError] : "XML_ERROR_PARSING";
+
+		return false;
+	}
+
+	tinyxml2::XMLElement *root = doc.RootElement();
+
+	// Empty answer
+	if (root == NULL)
+	{
+		return true;
+	}
+
+
+	int record = 0;
+
+	for (tinyxml2::XMLElement *child = root->FirstChildElement(); child; child = child->NextSiblingElement())
+	{
+		// Record?
+		if (child->FirstChildElement() != NULL)
+		{
+			for (tinyxml2::XMLElement *field = child->FirstChildElement(); field; field = field->NextSiblingElement())
+			{
+				// Values point into the body, so they outlive the document
+				const char* text = field->GetText();
+
+				handler.onField(record, field->Name(), text ? text : "");
+			}
+
+			record++;
+		}
+		else
+		{
+			const char* text = child->GetText();
+
+			handler.onValue(child->Name(), text ? text : "");
+		}
+	}
+
+	return true;
+}
+
+
+
+
+// Is the token a plain value?
+static inline bool isScalar(JSON_TOKEN token)
+{
+	return token == JSON_STRING || token == JSON_NUMBER || token == JSON_TRUE || token == JSON_FALSE || token == JSON_NULL;
+}
+
+
+
+// Read the fields of a record object
+static bool readJsonRecord(JsonReader& reader, ApiHandler& handler, int record)
+{
+	JSON_TOKEN token;
+
+	while ((token = reader.next()) == JSON_KEY)
+	{
+		const char* name = reader.getValue();
+
+		token = reader.next();
+
+		if (isScalar(token))
+		{
+			handler.onField(record, name, reader.getValue());
+		}
+		else if (token != JSON_OBJECT_START && token != JSON_ARRAY_START)
+		{
+			return false;
+		}
+		else if (!reader.skip())
+		{
+			// Nothing nested is known
+			return false;
+		}
+	}
+
+	return token == JSON_OBJECT_END;
+}
+
+
+
+// Walk a json response
+static bool walkJSON(char* body, size_t length, ApiHandler& handler, ApiResponse& response)
+{
+	JsonReader reader(body, length);
+
+	JSON_TOKEN token = reader.next();
+
+	// We need an object as root
+	if (token != JSON_OBJECT_START)
+	{
+		response.error = (token == JSON_ERROR) ? reader.getError() : "JSON_ERROR_EXPECTED_OBJECT";
+
+		return false;
+	}
+
+
+	int record = 0;
+	bool valid = true;
+
+	while (valid && (token = reader.next()) == JSON_KEY)
+	{
+		const char* name = reader.getValue();
+
+		token = reader.next();
+
+		if (isScalar(token))
+		{
+			handler.onValue(name, reader.getValue());
+		}
+		else if (token == JSON_OBJECT_START)
+		{
+			valid = readJsonRecord(reader, handler, record++);
+		}
+		else if (token == JSON_ARRAY_START)
+		{
+			// Repeated elements
+			while (valid && (token = reader.next()) != JSON_ARRAY_END)
+			{
+				if (isScalar(token))
+				{
+					handler.onValue(name, reader.getValue());
+				}
+				else if (token == JSON_OBJECT_START)
+				{
+					valid = readJsonRecord(reader, handler, record++);
+				}
+				else if (token == JSON_ARRAY_START)
+				{
+					valid = reader.skip();
+				}
+				else
+				{
+					valid = false;
+				}
+			}
+		}
+		else
+		{
+			valid = false;
+		}
+	}
+
+	// Properly closed?
+	if (!valid || token != JSON_OBJECT_END || reader.next() != JSON_END)
+	{
+		response.error = (*reader.getError() != '\0') ? reader.getError() : "JSON_ERROR_INVALID_STRUCTURE";
+
+		return false;
+	}
+
+	return true;
+}
+
+
+
+
+// Walk a response in whatever format it is
+static bool walkResponse(char* body, size_t length, ApiHandler& handler, ApiResponse& response)
+{
+	const size_t magic = strlen(API_BINARY_MAGIC);
+
+	// Binary feed?
+	if (length >= magic && memcmp(body, API_BINARY_MAGIC, magic) == 0)
+	{
+		response.format = API_FORMAT_BINARY;
+
+		return handler.onBinary(body + magic, length - magic, response);
+	}
+
+	// Detect the format
+	size_t start = 0;
+
+	while (start < length && (body[start] == ' ' || body[start] == '\t' || body[start] == '\r' || body[start] == '\n'))
+	{
+		start++;
+	}
+
+	if (start < length && body[start] == '{')
+	{
+		response.format = API_FORMAT_JSON;
+
+		return walkJSON(body, length, handler, response);
+	}
+
+	response.format = API_FORMAT_XML;
+
+	return walkXML(body, length, handler, response);
+}
+
+
+
+
+// A string of the binary format in place, its end is remembered
+static const char* readSpan(CodecReader& reader, char* data, std::vector<size_t>& ends)
+{
+	size_t length;
+	const char* span = reader.readSpan(length);
+
+	if (span == NULL)
+	{
+		return "";
+	}
+
+	ends.push_back((size_t)(span - data) + length);
+
+	return span;
+}
+
+
+// Decode a binary notice.php
+//
+// Strings are used in place. They're only terminated at the end, by
+// overwriting the byte behind them, which is the start of the next field.
+static bool decodeNoticeBinary(char* data, size_t length, ApiNotice& notice)
+{
+	CodecReader reader(data, length);
+
+	// Ends of the strings
+	std::vector<size_t> ends;
+
+	notice.foundRows = (int)reader.readVarint();
+
+	size_t errorLength;
+	const char* error = reader.readSpan(errorLength);
+
+	if (error != NULL && errorLength > 0)
+	{
+		notice.error = error;
+
+		ends.push_back((size_t)(error - data) + errorLength);
+	}
+
+	unsigned long long count = reader.readVarint();
+
+	// Every call needs at least 24 bytes, don't trust the count any further
+	if (!reader.hasFailed() && count <= length / 24)
+	{
+		notice.calls.resize((size_t)count);
+
+		ends.reserve((size_t)count * 6);
+	}
+
+	for (size_t i=0; i < notice.calls.size() && !reader.hasFailed(); i++)
+	{
+		ApiCall& call = notice.calls[i];
+
+		call.callID = readSpan(reader, data, ends);
+		call.fullIP = readSpan(reader, data, ends);
+		call.serverName = readSpan(reader, data, ends);
+		call.targetName = readSpan(reader, data, ends);
+		call.targetID = reader.readU64();
+		call.targetReason = readSpan(reader, data, ends);
+		call.clientName = readSpan(reader, data, ends);
+		call.clientID = reader.readU64();
+		call.reportedAt = (long)reader.readVarint();
+		call.handled = (reader.readByte() & 1) != 0;
+
+		call.found = API_CALL_FIELDS;
+	}
+
+	if (reader.hasFailed() || !reader.atEnd() || notice.calls.size() != count)
+	{
+		notice.calls.clear();
+		notice.error = "BINARY_ERROR_INVALID_STRUCTURE";
+
+		return false;
+	}
+
+	// Everything is read, the body itself is terminated behind its end
+	for (size_t i=0; i < ends.size(); i++)
+	{
+		data[ends[i]] = '\0';
+	}
+
+	return true;
+}
+
+
+
+// Handler for notice.php
+class NoticeHandler : public ApiHandler
+{
+private:
+	ApiNotice& notice;
+
+public:
+	NoticeHandler(ApiNotice& result) : notice(result) {}
+
+	virtual void onValue(const char* name, const char* value)
+	{
+		if (strcmp(name, "error") == 0)
+		{
+			notice.error = value;
+		}
+		else if (strcmp(name, "foundRows") == 0)
+		{
+			notice.foundRows = atoi(value);
+		}
+	}
+
+	virtual bool onBinary(char* data, size_t length, ApiResponse&)
+	{
+		return decodeNoticeBinary(data, length, notice);
+	}
+
+	virtual void onField(int record, const char* name, const char* value)
+	{
+		if ((int)notice.calls.size() <= record)
+		{
+			notice.calls.resize(record + 1);
+		}
+
+		ApiCall& call = notice.calls[record];
+
+		if (strcmp(name, "callID") == 0) call.callID = value;
+		else if (strcmp(name, "fullIP") == 0) call.fullIP = value;
+		else if (strcmp(name, "serverName") == 0) call.serverName = value;
+		else if (strcmp(name, "targetName") == 0) call.targetName = value;
+		else if (strcmp(name, "targetID") == 0) call.targetID = parseSteamID(value);
+		else if (strcmp(name, "targetReason") == 0) call.targetReason = value;
+		else if (strcmp(name, "clientName") == 0) call.clientName = value;
+		else if (strcmp(name, "clientID") == 0) call.clientID = parseSteamID(value);
+		else if (strcmp(name, "reportedAt") == 0) call.reportedAt = strtol(value, NULL, 10);
+		else if (strcmp(name, "callHandled") == 0) call.handled = (strcmp(value, "1") == 0);
+		else return;
+
+		call.found++;
+	}
+};
+
+
+
+// Handler for trackers.php
+class TrackersHandler : public ApiHandler
+{
+private:
+	ApiTrackers& trackers;
+
+public:
+	TrackersHandler(ApiTrackers& result) : trackers(result) {}
+
+	virtual void onValue(const char* name, const char* value)
+	{
+		if (strcmp(name, "error") == 0)
+		{
+			trackers.error = value;
+		}
+	}
+
+	virtual void onField(int, const char* name, const char* value)
+	{
+		if (strcmp(name, "trackerID") == 0)
+		{
+			trackers.trackerIDs.push_back(value);
+		}
+	}
+};
+
+
+
+// Handler for takeover.php
+class TakeoverHandler : public ApiHandler
+{
+private:
+	ApiTakeover& takeover;
+
+public:
+	TakeoverHandler(ApiTakeover& result) : takeover(result) {}
+
+	virtual void onValue(const char* name, const char* value)
+	{
+		if (strcmp(name, "error") == 0)
+		{
+			takeover.error = value;
+		}
+		else if (strcmp(name, "success") == 0)
+		{
+			takeover.success = true;
+		}
+	}
+
+	virtual void onField(int, const char*, const char*) {}
+};
+
+
+
+
+// Decode any response
+static API_STATUS decodeResponse(const char* curlError, std::vector<char>& body, ApiHandler& handler, ApiResponse& response)
+{
+	// Transfer failed
+	if (curlError != NULL && *curlError != '\0')
+	{
+		response.status = API_CONNECTION_ERROR;
+		response.error = curlError;
+	}
+
+	// Got nothing, a body is never without its terminator
+	else if (body.size() <= 1)
+	{
+		response.status = API_CONNECTION_ERROR;
+		response.error = "Couldn't init. CURL connection";
+	}
+
+	else if (!walkResponse(&body[0], body.size() - 1, handler, response))
+	{
+		response.status = API_PARSE_ERROR;
+	}
+
+	else if (response.error != NULL)
+	{
+		response.status = API_ERROR;
+	}
+
+	return response.status;
+}
+
+
+
+// Decode notice.php
+API_STATUS decodeNotice(const char* curlError, std::vector<char>& body, ApiNotice& notice)
+{
+	NoticeHandler handler(notice);
+
+	return decodeResponse(curlError, body, handler, notice);
+}
+
+
+// Decode trackers.php
+API_STATUS decodeTrackers(const char* curlError, std::vector<char>& body, ApiTrackers& trackers)
+{
+	TrackersHandler handler(trackers);
+
+	return decodeResponse(curlError, body, handler, trackers);
+}
+
+
+// Decode takeover.php
+API_STATUS decodeTakeover(const char* curlError, std::vector<char>& body, ApiTakeover& takeover)
+{
+	TakeoverHandler handler(takeover);
+
+	return decodeResponse(curlError, body, handler, takeover);
+}
+
+
+
+// Kind of the error
+const char* ApiResponse::getErrorType() const
+{
+	switch (status)
+	{
+		case API_CONNECTION_ERROR:
+			return "CURL";
+
+		case API_PARSE_ERROR:
+			return getFormatName(format);
+
+		case API_ERROR:
+			return "API";
+
+		default:
+			return "";
+	}
+}
+
+
+
+
+// Number to a string
+static std::string toString(long value)
+{
+	char buffer[32];
+
+	sprintf(buffer, "%ld", value);
+
+	return buffer;
+}
+
+
+
+
+// Parameter asking for a format, XML is what every webscript answers without
+static std::string formatParameter(API_FORMAT format)
+{
+	switch (format)
+	{
+		case API_FORMAT_JSON:
+			return "&format=json";
+
+		case API_FORMAT_BINARY:
+			return "&format=binary";
+
+		default:
+			return "";
+	}
+}
+
+
+// URL of notice.php
+std::string buildURL(const std::string& page, const std::string& key, const ApiNoticeRequest& request)
+{
+	std::string url = page + "/notice.php?";
+
+	if (request.initial)
+	{
+		url += "from=0&from_type=unixtime&key=" + key + "&sort=desc&limit=" + toString(request.limit);
+	}
+	else
+	{
+		url += "from=" + toString(request.interval) + "&from_type=interval&key=" + key + "&sort=asc&handled=" + toString(request.handled);
+	}
+
+	// Store Player
+	if (!request.storeSteamID.empty())
+	{
+		url += "&store=1&steamid=" + request.storeSteamID;
+	}
+
+	return url + formatParameter(request.format);
+}
+
+
+// URL of trackers.php
+std::string buildURL(const std::string& page, const std::string& key, const ApiTrackersRequest& request)
+{
+	return page + "/trackers.php?from=" + toString(request.interval) + "&from_type=interval&key=" + key + formatParameter(request.format);
+}
+
+
+// URL of takeover.php
+std::string buildURL(const std::string& page, const std::string& key, const ApiTakeoverRequest& request)
+{
+	return page + "/takeover.php?callid=" + request.callID + "&key=" + key + formatParameter(request.format);
+}
+
+
+
+// Name of a format
+const char* getFormatName(API_FORMAT format)
+{
+	switch (format)
+	{
+		case API_FORMAT_JSON:
+			return "JSON";
+
+		case API_FORMAT_BINARY:
+			return "Binary";
+
+		default:
+			return "XML";
+	}
+}
+
+
+
+
+// Offset of 64bit SteamIDs of individual accounts
+#define STEAMID64_BASE 76561197960265728ULL
+
+
+// STEAM_X:Y:Z to a 64bit SteamID
+unsigned long long parseSteamID(const char* steamid)
+{
+	// Skip universe
+	const char* pos = strchr(steamid, ':');
+
+	if (pos == NULL || (pos[1] != '0' && pos[1] != '1') || pos[2] != ':')
+	{
+		return 0;
+	}
+
+	unsigned long long server = pos[1] - '0';
+	unsigned long long authID = 0;
+
+	// Account number
+	for (pos += 3; *pos >= '0' && *pos <= '9'; pos++)
+	{
+		authID = authID * 10 + (*pos - '0');
+
+		if (authID > 0x7FFFFFFF)
+		{
+			return 0;
+		}
+	}
+
+	// Wrong Format
+	if (authID == 0)
+	{
+		return 0;
+	}
+
+	return STEAMID64_BASE + authID * 2 + server;
+}
+
+
+
+// 64bit SteamID to STEAM_0:Y:Z
+void formatSteamID(unsigned long long steamid, char* buffer, size_t size)
+{
+	char result[32] = "";
+
+	if (steamid > STEAMID64_BASE && steamid - STEAMID64_BASE <= 0xFFFFFFFFULL)
+	{
+		unsigned long account = (unsigned long)(steamid - STEAMID64_BASE);
+
+		sprintf(result, "STEAM_0:%lu:%lu", account & 1, account >> 1);
+	}
+
+	strncpy(buffer, result, size);
+	buffer[size - 1] = '\0';
+}
@@ -0,0 +1,247 @@
+#ifndef API_H
+#define API_H
+
+/**
+ * -----------------------------------------------------
+ * File        api.h
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#pragma once
+
+
+// c++ libs
+#include <string>
+#include <vector>
+
+
+
+// Number of fields of a complete call
+#define API_CALL_FIELDS 10
+
+
+
+// Formats the web API can answer in
+//
+// XML is what every webscript speaks. With format=json a newer one answers
+// with an object mirroring the XML: elements below the root become keys,
+// repeated elements become arrays. The format is detected from the body, so
+// old webscripts simply keep answering in XML.
+//
+// notice.php may also answer format=binary with a compact call feed:
+//
+//   "CAB1"                          magic
+//   varint  foundRows
+//   string  error                   empty if none
+//   varint  number of calls
+//   per call:
+//     string callID, fullIP, serverName, targetName
+//     u64    targetID               64bit SteamID
+//     string targetReason, clientName
+//     u64    clientID               64bit SteamID
+//     varint reportedAt             unix time
+//     u8     flags                  bit 0: handled
+//
+// varint is an unsigned LEB128, u64 is little endian, a string is a varint
+// length followed by the bytes.
+enum API_FORMAT
+{
+	API_FORMAT_XML = 0,
+	API_FORMAT_JSON,
+	API_FORMAT_BINARY,
+};
+
+
+// Magic of the binary format
+#define API_BINARY_MAGIC "CAB1"
+
+
+
+// Result of a request
+enum API_STATUS
+{
+	API_OK = 0,
+
+	// Curl failed or nothing was received
+	API_CONNECTION_ERROR,
+
+	// Body couldn't be parsed
+	API_PARSE_ERROR,
+
+	// The API answered with an error
+	API_ERROR,
+};
+
+
+
+// Base of every response
+struct ApiResponse
+{
+	API_STATUS status;
+	API_FORMAT format;
+
+	// Description of the error, NULL if none
+	const char* error;
+
+	ApiResponse() : status(API_OK), format(API_FORMAT_XML), error(NULL) {}
+
+	// Kind of the error for messages: CURL, XML, JSON, Binary or API
+	const char* getErrorType() const;
+
+	// Description of the error, never NULL
+	const char* getErrorText() const {return (error != NULL) ? error : "";}
+
+	// Both for the user: "<type> Error: <text>"
+	std::string getErrorMessage() const {return (std::string)getErrorType() + " Error: " + getErrorText();}
+};
+
+
+
+// A call as delivered by notice.php
+// All strings point into the response body, SteamIDs and the time are
+// already converted
+struct ApiCall
+{
+	const char* callID;
+	const char* fullIP;
+	const char* serverName;
+	const char* targetName;
+	unsigned long long targetID;
+	const char* targetReason;
+	const char* clientName;
+	unsigned long long clientID;
+	long reportedAt;
+	bool handled;
+
+	// Fields found, a complete call has API_CALL_FIELDS
+	int found;
+
+	ApiCall() : callID(""), fullIP(""), serverName(""), targetName(""), targetID(0), targetReason(""), clientName(""), clientID(0), reportedAt(0), handled(false), found(0) {}
+};
+
+
+// notice.php
+struct ApiNotice : public ApiResponse
+{
+	int foundRows;
+	std::vector<ApiCall> calls;
+
+	ApiNotice() : foundRows(0) {}
+};
+
+
+// trackers.php
+struct ApiTrackers : public ApiResponse
+{
+	std::vector<const char*> trackerIDs;
+};
+
+
+// takeover.php
+struct ApiTakeover : public ApiResponse
+{
+	bool success;
+
+	ApiTakeover() : success(false) {}
+};
+
+
+
+// notice.php
+struct ApiNoticeRequest
+{
+	// First fetch: the last calls by time, otherwise the calls of an interval
+	bool initial;
+
+	// Calls to fetch on the first fetch
+	int limit;
+
+	// Interval in seconds
+	long interval;
+
+	// Also report calls handled in the last seconds
+	long handled;
+
+	// Store this player as available admin, empty for none
+	std::string storeSteamID;
+
+	// Format to ask for, webscripts not knowing it answer in XML
+	API_FORMAT format;
+
+	ApiNoticeRequest() : initial(false), limit(0), interval(0), handled(0), format(API_FORMAT_JSON) {}
+};
+
+
+// trackers.php
+struct ApiTrackersRequest
+{
+	// Trackers active in the last seconds
+	long interval;
+
+	// Format to ask for, there's no binary one
+	API_FORMAT format;
+
+	ApiTrackersRequest() : interval(0), format(API_FORMAT_JSON) {}
+};
+
+
+// takeover.php
+struct ApiTakeoverRequest
+{
+	std::string callID;
+
+	// Format to ask for, there's no binary one
+	API_FORMAT format;
+
+	ApiTakeoverRequest() : format(API_FORMAT_JSON) {}
+};
+
+
+
+// URL of a request
+std::string buildURL(const std::string& page, const std::string& key, const ApiNoticeRequest& request);
+std::string buildURL(const std::string& page, const std::string& key, const ApiTrackersRequest& request);
+std::string buildURL(const std::string& page, const std::string& key, const ApiTakeoverRequest& request);
+
+
+
+// Decode a response in place, the body has to outlive the result
+// The body holds the response followed by a NUL which isn't part of it, so
+// the parsers can terminate the last value inside the buffer. An empty
+// vector means nothing was received.
+// curlError is the error of the transfer, empty if it succeeded
+// Sets and returns the status of the response
+API_STATUS decodeNotice(const char* curlError, std::vector<char>& body, ApiNotice& notice);
+API_STATUS decodeTrackers(const char* curlError, std::vector<char>& body, ApiTrackers& trackers);
+API_STATUS decodeTakeover(const char* curlError, std::vector<char>& body, ApiTakeover& takeover);
+
+// Name of a format for messages
+const char* getFormatName(API_FORMAT format);
+
+
+// STEAM_X:Y:Z to a 64bit SteamID, 0 if invalid
+unsigned long long parseSteamID(const char* steamid);
+
+// 64bit SteamID to STEAM_0:Y:Z, buffer needs at least 32 chars
+void formatSteamID(unsigned long long steamid, char* buffer, size_t size);
+
+
+#endif
@@ -26,6 +26,7 @@
 // c++ libs
 #include <string>
 #include <ctime>
+#include <vector>
 #include <stdlib.h>
 
 // Includes Project
@@ -36,6 +37,7 @@
 #include "log.h"
 #include "taskbar.h"
 #include "calladmin-client.h"
+#include "resources.h"
 
 // wx
 #include <wx/statline.h>
@@ -44,11 +46,8 @@
 // curl
 #include <curl/curl.h>
 
-// xml parser
-#include "tinyxml2/tinyxml2.h"
-
-// Call Dialogs
-CallDialog *call_dialogs[MAXCALLS];
+// API responses
+#include "api.h"
 
 
 
@@ -78,15 +77,100 @@ END_EVENT_TABLE()
 
 
 
-// start the Call
-void CallDialog::startCall(bool show)
+// The one window of all calls, if calls share it
+static CallDialog* callWindow = NULL;
+
+
+
+// Is a client on the friendlist?
+static bool isFriend(CSteamID* id)
+{
+	return steamConnected && steamFriends != NULL && id->IsValid() && steamFriends->GetFriendRelationship(*id) == k_EFriendRelationshipFriend;
+}
+
+
+
+// Create the dialog, a call is set with setCall
+CallDialog::CallDialog() : wxDialog(NULL, wxID_ANY, "Call", wxDefaultPosition, wxDefaultSize, wxDEFAULT_DIALOG_STYLE | wxMINIMIZE_BOX)
+{
+	// Initialize vars
+	record = NULL;
+	panel = NULL;
+	sizerTop = NULL;
+	clientDetails = NULL;
+	targetDetails = NULL;
+	serverText = NULL;
+	timeText = NULL;
+	doneText = NULL;
+	clientAvatar = NULL;
+	clientName = NULL;
+	clientSteamID = NULL;
+	contactClient = NULL;
+	reasonText = NULL;
+	targetAvatar = NULL;
+	targetName = NULL;
+	targetSteamID = NULL;
+	contactTarget = NULL;
+	ID = INVALID_CALL;
+	takeover = NULL;
+	contactTrackers = NULL;
+	avatarTimer = NULL;
+}
+
+
+
+// Dialog closed
+CallDialog::~CallDialog()
+{
+	// The timer writes to our avatars
+	detach();
+
+	if (callWindow == this)
+	{
+		callWindow = NULL;
+	}
+}
+
+
+
+// Forget the call, its avatars aren't loaded anymore
+void CallDialog::detach()
+{
+	stopAvatars();
+
+	if (record != NULL)
+	{
+		record->dialog = NULL;
+		record = NULL;
+	}
+}
+
+
+
+// Stop loading the avatars
+void CallDialog::stopAvatars()
+{
+	if (avatarTimer != NULL)
+	{
+		avatarTimer->Stop();
+
+		delete avatarTimer;
+
+		avatarTimer = NULL;
+	}
+}
+
+
+
+// Create the controls, they are filled by setCall
+void CallDialog::createWindow()
 {
 	
 	// Create Box
 	sizerTop = new wxBoxSizer(wxVERTICAL);
 
 	// Panel
-	wxPanel* panel = new wxPanel(this, wxID_ANY);
+	panel = new wxPanel(this, wxID_ANY);
 
 
 	// Valid?
@@ -98,15 +182,13 @@ void CallDialog::startCall(bool show)
 
 	// Border and Center
 	wxSizerFlags flags;
-	wxStaticText* text;
-	wxTextCtrl* text2;
 
 	// Border and Centre
 	flags.Border(wxALL, 10);
 	flags.Centre();
 
 
-	// ToolTip for Contact friend 
+	// ToolTip for Contact friend
 	wxToolTip* contactTooltip = new wxToolTip("This will open a Steam chat with this client.");
 
 
@@ -121,54 +203,36 @@ void CallDialog::startCall(bool show)
 	contactTooltip->Enable(true);
 
 
-	// Time
-	char buffer[80];
-
-	// But first we need a Time
-	time_t tt = (time_t)getTime();
-
-	struct tm* dt = localtime(&tt);
-
-	strftime(buffer, sizeof(buffer), "%c", dt);
+	// Default avatar, shown until Steam has the real one
+	defaultAvatar = getResourceBitmap("calladmin_avatar", avatarSize);
 
 
 	// New Call
-	text = new wxStaticText(panel, wxID_ANY, wxString::FromUTF8(serverName));
+	serverText = new wxStaticText(panel, wxID_ANY, "");
 
-	text->SetFont(wxFont(16, FONT_FAMILY, wxFONTSTYLE_NORMAL, FONT_WEIGHT_BOLD));
+	serverText->SetFont(wxFont(16, FONT_FAMILY, wxFONTSTYLE_NORMAL, FONT_WEIGHT_BOLD));
 
 
 	// Add it
-	sizerTop->Add(text, flags.Border(wxALL &~ wxBOTTOM, 20));
+	sizerTop->Add(serverText, flags.Border(wxALL &~ wxBOTTOM, 20));
 
 
 	// New Call At
-	text = new wxStaticText(panel, wxID_ANY, "at " + (std::string)buffer);
+	timeText = new wxStaticText(panel, wxID_ANY, "");
 
-	text->SetFont(wxFont(16, FONT_FAMILY, wxFONTSTYLE_NORMAL, FONT_WEIGHT_BOLD));
+	timeText->SetFont(wxFont(16, FONT_FAMILY, wxFONTSTYLE_NORMAL, FONT_WEIGHT_BOLD));
 
 
 
 	// Add it
-	sizerTop->Add(text, flags.Border(wxALL &~ wxTOP &~ wxBOTTOM, 20));
-
+	sizerTop->Add(timeText, flags.Border(wxALL &~ wxTOP &~ wxBOTTOM, 20));
 
 
-	// New Call At
-	if (!isHandled)
-	{
-		doneText = new wxStaticText(panel, wxID_ANY, "Unfinished");
 
-		doneText->SetFont(wxFont(16, FONT_FAMILY, wxFONTSTYLE_NORMAL, FONT_WEIGHT_BOLD));
-		doneText->SetForegroundColour(wxColor("red"));
-	}
-	else
-	{
-		doneText = new wxStaticText(panel, wxID_ANY, "Finished");
+	// Finished or not
+	doneText = new wxStaticText(panel, wxID_ANY, "Unfinished");
 
-		doneText->SetFont(wxFont(16, FONT_FAMILY, wxFONTSTYLE_NORMAL, FONT_WEIGHT_BOLD));
-		doneText->SetForegroundColour(wxColour(34, 139, 34));
-	}
+	doneText->SetFont(wxFont(16, FONT_FAMILY, wxFONTSTYLE_NORMAL, FONT_WEIGHT_BOLD));
 
 
 	// Add it
@@ -189,49 +253,39 @@ void CallDialog::startCall(bool show)
 
 
 	wxSizer* const clientLayout = new wxBoxSizer(wxHORIZONTAL);
-	wxSizer* const clientDetails = new wxBoxSizer(wxVERTICAL);
+	clientDetails = new wxBoxSizer(wxVERTICAL);
 
 
 	// Avatar
-	#if defined(__WXMSW__)
-		clientAvatar = new wxStaticBitmap(panel, wxID_ANY, wxBitmap(wxImage("calladmin_avatar", wxBITMAP_TYPE_RESOURCE).Rescale(avatarSize, avatarSize)));
-	#else
-		clientAvatar = new wxStaticBitmap(panel, wxID_ANY, wxBitmap(wxImage(getAppPath("resources/calladmin_avatar.bmp")).Rescale(avatarSize, avatarSize)));
-	#endif
+	clientAvatar = new wxStaticBitmap(panel, wxID_ANY, defaultAvatar);
 
 	clientLayout->Add(clientAvatar, flags);
 
 
 
 	// Caller Name
-	text = new wxStaticText(panel, wxID_ANY, wxString::FromUTF8(client));
-	text->SetFont(wxFont(16, FONT_FAMILY, wxFONTSTYLE_NORMAL, FONT_WEIGHT_BOLD));
+	clientName = new wxStaticText(panel, wxID_ANY, "");
+	clientName->SetFont(wxFont(16, FONT_FAMILY, wxFONTSTYLE_NORMAL, FONT_WEIGHT_BOLD));
 	
-	clientDetails->Add(text, flags);
+	clientDetails->Add(clientName, flags);
 	
 	
-	if (steamConnected && steamFriends != NULL && getClientCID() != NULL && getClientCID()->IsValid())
-	{
-		if (steamFriends->GetFriendRelationship(*getClientCID()) == k_EFriendRelationshipFriend)
-		{
-			// Add Contact Friend button
-			wxButton *contactClient = new wxButton(panel, wxID_ContactClient, "Contact Friend");
+	// Contact Friend button, only shown for friends
+	contactClient = new wxButton(panel, wxID_ContactClient, "Contact Friend");
 
-			contactClient->SetToolTip(contactTooltip);
+	contactClient->SetToolTip(contactTooltip);
 
-			clientDetails->Add(contactClient, 0, wxALL &~ wxTOP | wxALIGN_CENTER_HORIZONTAL, 5);
-		}
-	}
+	clientDetails->Add(contactClient, 0, wxALL &~ wxTOP | wxALIGN_CENTER_HORIZONTAL, 5);
 
 
 
 
 	// Steamid
-	text2 = new wxTextCtrl(panel, wxID_ANY, clientID, wxDefaultPosition, wxSize(220, -1), wxTE_CENTRE | wxTE_READONLY);
+	clientSteamID = new wxTextCtrl(panel, wxID_ANY, "", wxDefaultPosition, wxSize(220, -1), wxTE_CENTRE | wxTE_READONLY);
 
-	text2->SetFont(wxFont(14, FONT_FAMILY, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+	clientSteamID->SetFont(wxFont(14, FONT_FAMILY, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
 
-	clientDetails->Add(text2, 0, wxEXPAND | wxALL | wxHORIZONTAL, 10);
+	clientDetails->Add(clientSteamID, 0, wxEXPAND | wxALL | wxHORIZONTAL, 10);
 
 
 	clientLayout->Add(clientDetails, flags);
@@ -246,10 +300,10 @@ void CallDialog::startCall(bool show)
 
 
 	// Reason
-	text = new wxStaticText(panel, wxID_ANY, wxString::FromUTF8("\xe2\x96\xbc") + " reported because of reason: \"" + wxString::FromUTF8(reason) + "\" " + wxString::FromUTF8("\xe2\x96\xbc"));
-	text->SetFont(wxFont(14, FONT_FAMILY, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+	reasonText = new wxStaticText(panel, wxID_ANY, "");
+	reasonText->SetFont(wxFont(14, FONT_FAMILY, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
 
-	sizerTop->Add(text, flags);
+	sizerTop->Add(reasonText, flags);
 
 
 
@@ -260,47 +314,39 @@ void CallDialog::startCall(bool show)
 
 
 	wxSizer* const targetLayout = new wxBoxSizer(wxHORIZONTAL);
-	wxSizer* const targetDetails = new wxBoxSizer(wxVERTICAL);
+	targetDetails = new wxBoxSizer(wxVERTICAL);
 	
 	// Avatar
-	#if defined(__WXMSW__)
-		targetAvatar = new wxStaticBitmap(panel, wxID_ANY, wxBitmap(wxImage("calladmin_avatar", wxBITMAP_TYPE_RESOURCE).Rescale(avatarSize, avatarSize)));
-	#else
-		targetAvatar = new wxStaticBitmap(panel, wxID_ANY, wxBitmap(wxImage(getAppPath("resources/calladmin_avatar.bmp")).Rescale(avatarSize, avatarSize)));
-	#endif
+	targetAvatar = new wxStaticBitmap(panel, wxID_ANY, defaultAvatar);
 
 	targetLayout->Add(targetAvatar, flags);
 
 
 
 	// Target Name
-	text = new wxStaticText(panel, wxID_ANY, wxString::FromUTF8(target));
-	text->SetFont(wxFont(16, FONT_FAMILY, wxFONTSTYLE_NORMAL, FONT_WEIGHT_BOLD));
+	targetName = new wxStaticText(panel, wxID_ANY, "");
+	targetName->SetFont(wxFont(16, FONT_FAMILY, wxFONTSTYLE_NORMAL, FONT_WEIGHT_BOLD));
 
-	targetDetails->Add(text, flags);
+	targetDetails->Add(targetName, flags);
 	
 	
-	if (steamConnected && steamFriends != NULL && getTargetCID() != NULL && getTargetCID()->IsValid())
-	{
-		if (steamFriends->GetFriendRelationship(*getTargetCID()) == k_EFriendRelationshipFriend)
-		{
-			// Add Contact Friend button
-			wxButton *contactTarget = new wxButton(panel, wxID_ContactTarget, "Contact Friend");
+	// Contact Friend button, only shown for friends
+	wxToolTip* contactTargetTooltip = new wxToolTip("This will open a Steam chat with this client.");
 
-			contactTarget->SetToolTip(contactTooltip);
+	contactTarget = new wxButton(panel, wxID_ContactTarget, "Contact Friend");
 
-			targetDetails->Add(contactTarget, 0, wxALL &~ wxTOP | wxALIGN_CENTER_HORIZONTAL, 5);
-		}
-	}
+	contactTarget->SetToolTip(contactTargetTooltip);
+
+	targetDetails->Add(contactTarget, 0, wxALL &~ wxTOP | wxALIGN_CENTER_HORIZONTAL, 5);
 
 
 
 	// Steamid
-	text2 = new wxTextCtrl(panel, wxID_ANY, targetID, wxDefaultPosition, wxSize(220, -1), wxTE_CENTRE | wxTE_READONLY);
+	targetSteamID = new wxTextCtrl(panel, wxID_ANY, "", wxDefaultPosition, wxSize(220, -1), wxTE_CENTRE | wxTE_READONLY);
 
-	text2->SetFont(wxFont(14, FONT_FAMILY, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+	targetSteamID->SetFont(wxFont(14, FONT_FAMILY, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
 
-	targetDetails->Add(text2, 0, wxEXPAND | wxALL | wxHORIZONTAL, 10);
+	targetDetails->Add(targetSteamID, 0, wxEXPAND | wxALL | wxHORIZONTAL, 10);
 
 
 	targetLayout->Add(targetDetails, flags);
@@ -309,13 +355,6 @@ void CallDialog::startCall(bool show)
 
 
 
-	// Start the Timers
-	avatarTimer = new AvatarTimer(getClientCID(), getTargetCID(), clientAvatar, targetAvatar);
-
-	avatarTimer->startTimer();
-
-
-
 	// Static line
 	sizerTop->Add(new wxStaticLine(panel, wxID_ANY), 0, wxEXPAND | wxALL, 5);
 
@@ -348,7 +387,6 @@ void CallDialog::startCall(bool show)
 
 	// Contect trackers button
 	contactTrackers = new wxButton(panel, wxID_ContactTrackers, "Contact Trackers");
-	contactTrackers->Enable(true);
 	contactTrackers->SetToolTip(contactTrackersTooltip);
 
 
@@ -366,78 +404,295 @@ void CallDialog::startCall(bool show)
 
 	
 	// Auto Size
-	panel->SetSizerAndFit(sizerTop, true);
+	panel->SetSizer(sizerTop);
 
 
-	// Fit
-	this->Fit();
+	// Set Icon
+	SetIcon(getResourceIcon("calladmin_icon"));
+}
 
-	// Centre to Screen
-	Centre();
 
-	// Set Icon
-	#if defined(__WXMSW__)
-		SetIcon(wxIcon("calladmin_icon", wxBITMAP_TYPE_ICO_RESOURCE));
-	#else
-		wxLogNull nolog;
 
-		SetIcon(wxIcon(getAppPath("resources/calladmin_icon.ico"), wxBITMAP_TYPE_ICON));
-	#endif
+// Show a call, only the data changes
+void CallDialog::setCall(CallHandle id, CallRecord* call)
+{
+	// Not built or nothing to show
+	if (panel == NULL || call == NULL)
+	{
+		return;
+	}
+
+	bool first = (ID == INVALID_CALL);
+
+	// The call before doesn't have a dialog anymore
+	if (record != call)
+	{
+		detach();
+	}
+
+	record = call;
+	ID = id;
+
+	record->dialog = this;
+
+	clientCID.SetFromUint64(record->clientID);
+	targetCID.SetFromUint64(record->targetID);
+
+
+	// Time
+	char buffer[80];
+
+	// But first we need a Time
+	time_t tt = (time_t)record->reportedAt;
+
+	struct tm* dt = localtime(&tt);
+
+	strftime(buffer, sizeof(buffer), "%H:%M", dt);
+
+	// Title with the time
+	SetTitle("Call At " + (wxString)buffer);
+
+	strftime(buffer, sizeof(buffer), "%c", dt);
+
+
+	// Texts of the call
+	serverText->SetLabel(getDisplayString(record->serverName));
+	timeText->SetLabel("at " + (std::string)buffer);
+
+	if (!record->handled)
+	{
+		doneText->SetLabelText("Unfinished");
+		doneText->SetForegroundColour(wxColor("red"));
+	}
+	else
+	{
+		doneText->SetLabelText("Finished");
+		doneText->SetForegroundColour(wxColour(34, 139, 34));
+	}
+
+	clientName->SetLabel(getDisplayString(record->clientName));
+	clientSteamID->ChangeValue(steamIDtoString(record->clientID));
+
+	reasonText->SetLabel(wxString::FromUTF8("\xe2\x96\xbc") + " reported because of reason: \"" + getDisplayString(record->targetReason) + "\" " + wxString::FromUTF8("\xe2\x96\xbc"));
+
+	targetName->SetLabel(getDisplayString(record->targetName));
+	targetSteamID->ChangeValue(steamIDtoString(record->targetID));
+
+
+	// Only friends can be contacted
+	clientDetails->Show(contactClient, isFriend(getClientCID()));
+	targetDetails->Show(contactTarget, isFriend(getTargetCID()));
+
+
+	// Buttons
+	takeover->Enable(!record->handled);
+	contactTrackers->Enable(true);
+
+
+
+	// The avatars of the call before aren't needed anymore
+	stopAvatars();
+
+	clientAvatar->SetBitmap(defaultAvatar);
+	targetAvatar->SetBitmap(defaultAvatar);
+
+	// Start the Timers
+	avatarTimer = new AvatarTimer(getClientCID(), getTargetCID(), clientAvatar, targetAvatar);
+
+	avatarTimer->startTimer();
+
 
 
-	// Show the Window
-	Show(show);
+	// Fit around the new texts
+	sizerTop->SetSizeHints(panel);
+
+	this->Fit();
+
+	// Centre to Screen
+	if (first)
+	{
+		Centre();
+	}
 }
 
 
 
 
 // We need the 64bit int id
-CSteamID CallDialog::steamIDtoCSteamID (char* steamid)
+CSteamID CallDialog::steamIDtoCSteamID (const char* steamid)
 {
 	CSteamID csteam;
 
-	// To small
-	if (strlen(steamid) < 11)
+	uint64 uintID = parseSteamID(steamid);
+
+	// Wrong Format
+	if (uintID == 0)
 	{
 		return csteam;
 	}
 
-	int server = 0;
-	int authID = 0;
+	csteam.SetFromUint64(uintID);
+
+	// Return it
+	return csteam;
+}
+
+
 
-	// Strip the steamid
-	char *strip = strtok(steamid, ":");
 
-	while (strip)
+
+// Open the dialog of a call
+void showCall(CallHandle id)
+{
+	CallRecord* record = call_store.get(id);
+
+	if (record == NULL)
 	{
-		strip = strtok(NULL, ":");
+		return;
+	}
 
-		char *strip2 = strtok(NULL, ":");
+	CallDialog* dialog = record->dialog;
+
+	if (dialog == NULL)
+	{
+		// Calls share one window, it only shows another call
+		if (singleCallWindow && callWindow != NULL)
+		{
+			dialog = callWindow;
+		}
 
-		// Read server and authID
-		if (strip2)
+		// Build it
+		else
 		{
-			server = atoi(strip);
-			authID = atoi(strip2);
+			dialog = new CallDialog();
+
+			dialog->createWindow();
+
+			if (singleCallWindow)
+			{
+				callWindow = dialog;
+			}
 		}
+
+		dialog->setCall(id, record);
 	}
 
-	// Wrong Format
-	if (authID == 0)
+	dialog->Show(true);
+	dialog->Restore();
+}
+
+
+// A call was selected, the shared window follows if it's open
+void selectCall(CallHandle id)
+{
+	CallRecord* record = call_store.get(id);
+
+	if (record == NULL || callWindow == NULL || !callWindow->IsShown() || record->dialog != NULL)
 	{
-		return csteam;
+		return;
 	}
 
-	uint64 uintID = (uint64)authID * 2;
+	callWindow->setCall(id, record);
+}
 
-	// Convert to a uint64
-	uintID += 76561197960265728 + server;
 
-	csteam.SetFromUint64(uintID);
 
-	// Return it
-	return csteam;
+// Close and delete a call
+void removeCall(CallHandle id)
+{
+	CallRecord* record = call_store.get(id);
+
+	if (record == NULL)
+	{
+		return;
+	}
+
+	// Dialog is deleted later, so let it forget the record now
+	if (record->dialog != NULL)
+	{
+		CallDialog* dialog = record->dialog;
+
+		// Also stops the avatars of the shared window
+		dialog->detach();
+
+		// The shared window is kept for the next call
+		if (dialog == callWindow)
+		{
+			dialog->Show(false);
+		}
+		else
+		{
+			dialog->Destroy();
+		}
+	}
+
+	call_store.remove(id);
+}
+
+
+// Close and delete all calls
+void clearCalls()
+{
+	// The call list is only told once
+	call_store.beginUpdate();
+
+	while (call_store.getCount() > 0)
+	{
+		removeCall(call_store.getFirst());
+	}
+
+	call_store.endUpdate();
+
+	// Built again for the next page
+	if (callWindow != NULL)
+	{
+		callWindow->Destroy();
+		callWindow = NULL;
+	}
+}
+
+
+
+// Display strings by handle, the serial tells if the handle still has the same text
+struct DisplayString
+{
+	unsigned int serial;
+	wxString text;
+
+	DisplayString() : serial(0) {}
+};
+
+static std::vector<DisplayString> displayStrings;
+
+
+// Interned string converted for display
+const wxString& getDisplayString(const PooledString& text)
+{
+	static const wxString empty;
+
+	StringHandle handle = text.getHandle();
+
+	if (handle == EMPTY_STRING)
+	{
+		return empty;
+	}
+
+	if ((size_t)handle >= displayStrings.size())
+	{
+		displayStrings.resize(handle + 1);
+	}
+
+	DisplayString& display = displayStrings[handle];
+	unsigned int serial = call_strings.getSerial(handle);
+
+	// Not converted yet
+	if (display.serial != serial)
+	{
+		display.serial = serial;
+		display.text = wxString::FromUTF8(text.c_str());
+	}
+
+	return display.text;
 }
 
 
@@ -447,15 +702,15 @@ CSteamID CallDialog::steamIDtoCSteamID (char* steamid)
 void CallDialog::OnConnect(wxCommandEvent& WXUNUSED(event))
 {
 	// Log Action
-	LogAction("Connected to the Server " + fullIP);
+	LOG(LOG_CATEGORY_UI, LOG_LEVEL_INFO, "Connected to the Server").field("ip", record->fullIP);
 
 	#if defined(__WXMSW__)
-		ShellExecute(NULL, L"open", s2ws("steam://connect/" + fullIP).c_str(), NULL, NULL, SW_SHOWNORMAL);
+		ShellExecute(NULL, L"open", s2ws("steam://connect/" + record->fullIP).c_str(), NULL, NULL, SW_SHOWNORMAL);
 	#else
-		system(("xdg-open steam://connect/" + fullIP).c_str());
+		system(("xdg-open steam://connect/" + record->fullIP).c_str());
 	#endif
 
-	Show(false);
+	Close();
 }
 
 
@@ -465,13 +720,15 @@ void CallDialog::OnConnect(wxCommandEvent& WXUNUSED(event))
 void CallDialog::OnCheck(wxCommandEvent& WXUNUSED(event))
 {
 	// Log Action
-	LogAction("Marke call " + callID + " as finished");
+	LOG(LOG_CATEGORY_UI, LOG_LEVEL_INFO, "Mark call as finished").field("call", record->callID);
 
 	// page
-	std::string pager = (std::string)(page + "/takeover.php?callid=" + callID + "&key=" + key);
+	ApiTakeoverRequest request;
+
+	request.callID = record->callID;
 
 	// Get Page
-	getPage(onChecked, pager, ID);
+	getPage(onChecked, buildURL((std::string)page, (std::string)key, request), ID);
 }
 
 
@@ -482,7 +739,7 @@ void CallDialog::OnCheck(wxCommandEvent& WXUNUSED(event))
 void CallDialog::OnContactClient(wxCommandEvent& WXUNUSED(event))
 {
 	// Log Action
-	LogAction("Contacted Client " + (wxString)getClientCID()->Render());
+	LOG(LOG_CATEGORY_UI, LOG_LEVEL_INFO, "Contacted Client").field("steamid", getClientCID()->Render());
 
 	// Open Chat
 	#if defined(__WXMSW__)
@@ -499,7 +756,7 @@ void CallDialog::OnContactClient(wxCommandEvent& WXUNUSED(event))
 void CallDialog::OnContactTarget(wxCommandEvent& WXUNUSED(event))
 {
 	// Log Action
-	LogAction("Contacted Client " + (wxString)getTargetCID()->Render());
+	LOG(LOG_CATEGORY_UI, LOG_LEVEL_INFO, "Contacted Target").field("steamid", getTargetCID()->Render());
 
 	// Open Chat
 	#if defined(__WXMSW__)
@@ -516,7 +773,7 @@ void CallDialog::OnContactTarget(wxCommandEvent& WXUNUSED(event))
 void CallDialog::OnContactTrackers(wxCommandEvent& WXUNUSED(event))
 {
 	// Log Action
-	LogAction("Contacting current Trackers");
+	LOG(LOG_CATEGORY_NET, LOG_LEVEL_INFO, "Contacting current Trackers");
 
 
 
@@ -524,9 +781,11 @@ void CallDialog::OnContactTrackers(wxCommandEvent& WXUNUSED(event))
 	if (steamFriends != NULL && steamConnected)
 	{
 		// page
-		std::string pager = (std::string)(page + "/trackers.php?from=25&from_type=interval&key=" + key);
+		ApiTrackersRequest request;
+
+		request.interval = 25;
 
-		getPage(onGetTrackers, pager, ID);
+		getPage(onGetTrackers, buildURL((std::string)page, (std::string)key, request), ID);
 
 		return;
 	}
@@ -542,121 +801,72 @@ void CallDialog::OnContactTrackers(wxCommandEvent& WXUNUSED(event))
 
 
 // Contact Client
-void onGetTrackers(char* errors, wxString result, int x)
+void onGetTrackers(const char* errors, std::vector<char>& result, long long x)
 {
 	// Log Action
-	LogAction("Got Trackers");
+	LOG(LOG_CATEGORY_NET, LOG_LEVEL_DEBUG, "Got Trackers");
 
 	wxString error = "";
 
+	// Call still there?
+	CallRecord* record = call_store.get(x);
+
+	if (record == NULL)
+	{
+		return;
+	}
+
 
 
-	if (result != "")
+	// Decode the result in place
+	ApiTrackers trackers;
+
+	// Everything good :)
+	if (decodeTrackers(errors, result, trackers) == API_OK)
 	{
-		// Everything good :)
-		if (strcmp(errors, "") == 0)
-		{
-			// Proceed XML result!
-			tinyxml2::XMLDocument doc;
-			tinyxml2::XMLNode *node;
-			tinyxml2::XMLError parseError;
+		// found someone?
+		bool found = false;
 
-			// Parse the xml data
-			parseError = doc.Parse(result);
 
-			// Parsing good :)?
-			if (parseError == tinyxml2::XML_SUCCESS)
-			{
-				// Goto xml child
-				node = doc.FirstChild();
+		// Tracker Loop
+		for (size_t i=0; i < trackers.trackerIDs.size() && steamFriends != NULL; i++)
+		{
+			// Build csteamid
+			CSteamID steamidTracker = CallDialog::steamIDtoCSteamID(trackers.trackerIDs[i]);
 
-				// Goto CallAdmin_Trackers
-				if (node != NULL)
-				{
-					node = node->NextSibling();
-				}
+			// Are we friends and is tracker online? :))
+			if (steamidTracker.IsValid() && steamFriends->GetFriendRelationship(steamidTracker) == k_EFriendRelationshipFriend && steamFriends->GetFriendPersonaState(steamidTracker) != k_EPersonaStateOffline)
+			{
+				// Now we write a message
+				steamFriends->ReplyToFriendMessage(steamidTracker, ("Hey, i contact you because of the call from " + record->clientName.str() + " about " + record->targetName.str()).c_str());
 
-				// Found Trackers?
-				if (node != NULL)
+				// And we found someone :)
+				if (!found)
 				{
-					// found someone?
-					bool found = false;
-					
-					
-					// Tracker Loop
-					for (tinyxml2::XMLNode *node2 = node->FirstChild(); node2; node2 = node2->NextSibling())
-					{
-						// API Error?
-						if ((wxString)node2->Value() == "error")
-						{
-							error = (wxString)node2->FirstChild()->Value();
-
-							break;
-						}
-
-
-
-						// Search admin steamids
-						for (tinyxml2::XMLNode *node3 = node2->FirstChild(); node3; node3 = node3->NextSibling())
-						{
-							// Found steamid
-							if ((wxString)node3->Value() == "trackerID" && steamFriends != NULL && call_dialogs != NULL && call_dialogs[x] != NULL)
-							{
-								std::string steamidString = node3->FirstChild()->Value();
-
-								// Build csteamid
-								CSteamID steamidTracker = call_dialogs[x]->steamIDtoCSteamID((char*) steamidString.c_str());
-
-								// Are we friends and is tracker online? :))
-								if (steamidTracker.IsValid() && steamFriends->GetFriendRelationship(steamidTracker) == k_EFriendRelationshipFriend && steamFriends->GetFriendPersonaState(steamidTracker) != k_EPersonaStateOffline)
-								{
-									// Now we write a message
-									steamFriends->ReplyToFriendMessage(steamidTracker, "Hey, i contact you because of the call from " + call_dialogs[x]->getClient() + " about " + call_dialogs[x]->getTarget());
-
-									// And we found someone :)
-									if (!found)
-									{
-										found = true;
-
-										// So no contacting possible anymore
-										call_dialogs[x]->contactTrackers->Enable(false);
-									}
-								}
-							}
-						}
-					}
+					found = true;
 
-					// Have we found something?
-					if (found)
+					// So no contacting possible anymore
+					if (record->dialog != NULL)
 					{
-						// We are finished :)
-						return;
+						record->dialog->contactTrackers->Enable(false);
 					}
-
 				}
 			}
-			else
-			{
-				// XML ERROR
-				error = "XML ERROR: Couldn't parse the trackers API!";
-
-				// Log Action
-				LogAction("XML Error in trackers API");
-			}
 		}
-		else
-		{
-			// Curl error
-			error = errors;
 
-			// Log Action
-			LogAction("CURL Error " + error);
+		// Have we found something?
+		if (found)
+		{
+			// We are finished :)
+			return;
 		}
 	}
 	else
 	{
-		// Curl error
-		error = "Couldn't init. CURL connection";
+		error = trackers.getErrorMessage();
+
+		// Log Action
+		LOG((trackers.status == API_PARSE_ERROR) ? LOG_CATEGORY_PARSE : LOG_CATEGORY_NET, LOG_LEVEL_WARNING, "Couldn't get the Trackers").field("type", trackers.getErrorType()).field("error", trackers.getErrorText());
 	}
 
 
@@ -668,7 +878,7 @@ void onGetTrackers(char* errors, wxString result, int x)
 
 	if (m_taskBarIcon != NULL)
 	{
-		m_taskBarIcon->ShowMessage("Coulnd't contact trackers!", error, call_dialogs[x]);
+		m_taskBarIcon->ShowMessage("Coulnd't contact trackers!", error, record->dialog);
 	}
 }
 
@@ -677,86 +887,49 @@ void onGetTrackers(char* errors, wxString result, int x)
 
 
 // Mark checked
-void onChecked(char* errors, wxString result, int x)
+void onChecked(const char* errors, std::vector<char>& result, long long x)
 {
 	// Log Action
-	LogAction("Marked call " + call_dialogs[x]->getID() + " as finished");
+	// Call still there?
+	CallRecord* record = call_store.get(x);
 
-	wxString error = "";
-
-	if (result != "")
+	if (record == NULL)
 	{
-		// Everything good :)
-		if (strcmp(errors, "") == 0)
-		{
-			// Proceed XML result!
-			tinyxml2::XMLDocument doc;
-			tinyxml2::XMLNode *node;
-			tinyxml2::XMLError parseError;
-
-			// Parse the xml data
-			parseError = doc.Parse(result);
-
-			// Parsing good :)?
-			if (parseError == tinyxml2::XML_SUCCESS)
-			{
-				// Goto xml child
-				node = doc.FirstChild();
-
-				// Goto CallAdmin_Takeover
-				if (node != NULL)
-				{
-					node = node->NextSibling();
-				}
+		return;
+	}
 
-				// Found something?
-				if (node != NULL)
-				{
-					// Goto first child
-					node = node->FirstChild();
+	LOG(LOG_CATEGORY_NET, LOG_LEVEL_INFO, "Marked call as finished").field("call", record->callID);
 
-					// API Error?
-					if ((wxString)node->Value() == "error")
-					{
-						error = (wxString)node->FirstChild()->Value();
-					}
+	wxString error = "";
 
-					// Success?
-					if ((wxString)node->Value() == "success" && call_dialogs != NULL && call_dialogs[x] != NULL)
-					{
-						main_dialog->setHandled(x);
+	// Decode the result in place
+	ApiTakeover takeover;
 
-						return;
-					}
-				}
-			}
-			else
-			{
-				// XML ERROR
-				error = "XML ERROR: Couldn't parse the takeover API!";
-			}
-		}
-		else
+	// Everything good :)
+	if (decodeTakeover(errors, result, takeover) == API_OK)
+	{
+		// Success?
+		if (takeover.success)
 		{
-			// Curl error
-			error = errors;
+			main_dialog->setHandled(x);
+
+			return;
 		}
 	}
 	else
 	{
-		// Curl error
-		error = "Couldn't init. CURL connection";
+		error = takeover.getErrorMessage();
 	}
 
 	// Seems empty
 	if (error == "")
 	{
-		error = "Invalid XML structure!";
+		error = "Invalid API structure!";
 	}
 
 	if (m_taskBarIcon != NULL)
 	{
-		m_taskBarIcon->ShowMessage("Coulnd't take over call!", error, call_dialogs[x]);
+		m_taskBarIcon->ShowMessage("Coulnd't take over call!", error, record->dialog);
 	}
 }
 
@@ -766,7 +939,23 @@ void onChecked(char* errors, wxString result, int x)
 // Window Event -> disable Window
 void CallDialog::OnCloseWindow(wxCloseEvent& WXUNUSED(event))
 {
-	Show(false);
+	// The shared window stays for the next call, without loading avatars
+	if (this == callWindow && singleCallWindow)
+	{
+		detach();
+		Show(false);
+
+		return;
+	}
+
+	if (this == callWindow)
+	{
+		callWindow = NULL;
+	}
+
+	// Created again when the call is opened
+	detach();
+	Destroy();
 }
 
 
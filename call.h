@@ -33,7 +33,7 @@
 
 // c++ libs
 #include <string>
-#include <sstream>
+#include <vector>
 
 // We need WX
 #ifndef WX_PRECOMP
@@ -43,6 +43,7 @@
 // Steam Class
 #include "opensteam.h"
 #include "calladmin-client.h"
+#include "callstore.h"
 
 
 // Call Dialog Class
@@ -50,48 +51,61 @@ class CallDialog: public wxDialog
 {
 private:
 
-	// We need information about a call ;)
-	wxString callID;
-	wxString fullIP;
-	wxString serverName;
-	wxString target;
-	wxString targetID;
-	wxString client;
-	wxString clientID;
-	wxString reason;
-	wxString boxText;
-	std::string reportedAt;
+	// The call, owned by the call store
+	CallRecord* record;
 
 	// Layout
+	wxPanel* panel;
 	wxSizer* sizerTop;
+	wxSizer* clientDetails;
+	wxSizer* targetDetails;
+
+	// Texts of the call
+	wxStaticText* serverText;
+	wxStaticText* timeText;
+	wxStaticText* doneText;
+	wxStaticText* reasonText;
+
+	wxStaticText* clientName;
+	wxStaticText* targetName;
+	wxTextCtrl* clientSteamID;
+	wxTextCtrl* targetSteamID;
+
+	// Only shown for friends
+	wxButton* contactClient;
+	wxButton* contactTarget;
 
 	// Avatars
 	wxStaticBitmap* clientAvatar;
 	wxStaticBitmap* targetAvatar;
-	wxStaticText* doneText;
+	wxBitmap defaultAvatar;
 
 	// And for the Steam API
 	CSteamID clientCID;
 	CSteamID targetCID;
 
-	// Item List
-	int ID;
-	bool isHandled;
+	// Handle of the call
+	CallHandle ID;
+
+	// Timers
+	AvatarTimer *avatarTimer;
+
+	void stopAvatars();
 
 public:
-	CallDialog(const wxString& title) : wxDialog(NULL, wxID_ANY, title, wxDefaultPosition, wxDefaultSize, wxDEFAULT_DIALOG_STYLE | wxMINIMIZE_BOX)
-	{
-		// Initialize vars
-		sizerTop = NULL;
-		clientAvatar = NULL;
-		targetAvatar = NULL;
-		doneText = NULL;
-		ID = 0;
-		isHandled = false;
-		takeover = NULL;
-		contactTrackers = NULL;
-		avatarTimer = NULL;
-	}
+	CallDialog();
+	~CallDialog();
+
+	// Create the controls, once per dialog
+	void createWindow();
+
+	// Show a call: only texts, buttons and avatars change, so a dialog
+	// can go from call to call without building anything again
+	void setCall(CallHandle id, CallRecord* call);
+
+	// Forget the call and stop its avatars, the dialog is about to go,
+	// is hidden or shows another one
+	void detach();
 
 	// Tracker button
 	wxButton* contactTrackers;
@@ -99,65 +113,29 @@ public:
 	// take Over Button
 	wxButton* takeover;
 
-	// Privat -> set Methods
-	void setCallID(const char* ID) {callID = ID;}
-	void setIP(const char* IP) {fullIP = IP;}
-	void setName(wxString name) {serverName = name;}
-	void setTarget(const char* name) {target = name;}
-	void setTargetID(const char* steamidID) {targetID = steamidID; targetCID = steamIDtoCSteamID((char*)(steamidID));}
-	void setClient(const char* name) {client = name;}
-	void setClientID (const char* steamidID) {clientID = steamidID; clientCID = steamIDtoCSteamID((char*)(steamidID));}
-	void setReason (const char* name) {reason = name;}
-	void setID(int num) {ID = num;}
-	void setTime(const char* time) {reportedAt = time;}
-	void setBoxText(wxString text) {boxText = text;}
-	void setHandled(bool handled) {isHandled = handled;}
-
-	void setFinish() {doneText->SetLabelText("Finished"); doneText->SetForegroundColour(wxColour(34, 139, 34)); sizerTop->Layout();}
+	void setFinish() {doneText->SetLabelText("Finished"); doneText->SetForegroundColour(wxColour(34, 139, 34)); sizerTop->Layout(); takeover->Enable(false);}
 
 
 	// Convert to community ID
-	static CSteamID steamIDtoCSteamID(char* steamid);
+	static CSteamID steamIDtoCSteamID(const char* steamid);
 
-
-
-	// Return time as a int
-	inline int getTime() const 
+	// Convert community ID to STEAM_0:Y:Z
+	static wxString steamIDtoString(unsigned long long steamid)
 	{
-		int timestamp;
-		std::stringstream timeS(reportedAt);
+		char buffer[32];
 
-		timeS >> timestamp;
+		formatSteamID(steamid, buffer, sizeof(buffer));
 
-		return timestamp;
+		return buffer;
 	}
 
 
-
-	// Timers
-	AvatarTimer *avatarTimer;
-
-
 	// Methods for Details
-	wxString getTarget() const {return target;}
-	wxString getClient() const {return client;}
-	
-	wxString getID() const {return callID;}
-	wxString getServer() {return serverName;}
-	wxString getBoxText() {return boxText;}
+	CallRecord* getRecord() {return record;}
 
 	CSteamID* getClientCID() {return &clientCID;}
 	CSteamID* getTargetCID() {return &targetCID;}
 
-	bool getHandled() {return isHandled;}
-
-
-	// Start the call
-	void startCall(bool show);
-
-	// Operator overloadings
-	friend bool operator==(const CallDialog& x, const CallDialog& y) { return (x.getTime() == y.getTime() && (x.getID() == y.getID())); }
-	friend bool operator!=(const CallDialog& x, const CallDialog& y) { return !(x == y);}
 
 protected:
 	// Button Events
@@ -175,13 +153,24 @@ protected:
 
 
 
-// CURL Callbacks
-void onGetTrackers(char* errors, wxString result, int x);
-void onChecked(char* error, wxString result, int x);
+// Open the dialog of a call, creates it if needed
+// With singleCallWindow calls share one dialog, which only shows the call
+void showCall(CallHandle id);
+
+// A call was selected in the list, the shared dialog shows it if it's open
+void selectCall(CallHandle id);
 
+// Close and delete calls
+void removeCall(CallHandle id);
+void clearCalls();
 
+// Interned string converted for display, converted once per text
+const wxString& getDisplayString(const PooledString& text);
 
-// Call Dialogs
-extern CallDialog *call_dialogs[MAXCALLS];
+
+
+// CURL Callbacks
+void onGetTrackers(const char* errors, std::vector<char>& result, long long x);
+void onChecked(const char* error, std::vector<char>& result, long long x);
 
 #endif
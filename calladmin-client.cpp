@@ -27,13 +27,12 @@
 #include <string>
 #include <sstream>
 #include <ctime>
+#include <algorithm>
 
 
 // Curl
 #include <curl/curl.h>
 
-// We need a xml parser
-#include "tinyxml2/tinyxml2.h"
 
 // Command line arguments
 #include <wx/cmdline.h>
@@ -62,6 +61,12 @@
 // Only one Instance
 #include <wx/snglinst.h>
 
+// History Directory
+#include <wx/filename.h>
+
+// Debug categories
+#include <wx/tokenzr.h>
+
 
 // Project
 #include "calladmin-client.h"
@@ -72,7 +77,15 @@
 #include "trackers.h"
 #include "about.h"
 #include "call.h"
+#include "resources.h"
 #include "taskbar.h"
+#include "api.h"
+#include "history.h"
+#include "callindex.h"
+#include "callstats.h"
+#include "snapshot.h"
+#include "codec.h"
+#include "opensteam.h"
 
 
 // Timer
@@ -98,41 +111,11 @@ std::string updateURL = "http://dordnung.de/sourcemod/calladmin/version.txt";
 
 
 
-// We need something to print for a XML Error!
-wxString XMLErrorString[20] = 
-{
-	"XML_NO_ERROR",
-
-	"XML_NO_ATTRIBUTE",
-	"XML_WRONG_ATTRIBUTE_TYPE",
-
-	"XML_ERROR_FILE_NOT_FOUND",
-	"XML_ERROR_FILE_COULD_NOT_BE_OPENED",
-	"XML_ERROR_FILE_READ_ERROR",
-	"XML_ERROR_ELEMENT_MISMATCH",
-	"XML_ERROR_PARSING_ELEMENT",
-	"XML_ERROR_PARSING_ATTRIBUTE",
-	"XML_ERROR_IDENTIFYING_TAG",
-	"XML_ERROR_PARSING_TEXT",
-	"XML_ERROR_PARSING_CDATA",
-	"XML_ERROR_PARSING_COMMENT",
-	"XML_ERROR_PARSING_DECLARATION",
-	"XML_ERROR_PARSING_UNKNOWN",
-	"XML_ERROR_EMPTY_DOCUMENT",
-	"XML_ERROR_MISMATCHED_ELEMENT",
-	"XML_ERROR_PARSING",
-
-	"XML_CAN_NOT_CONVERT_TEXT",
-	"XML_NO_TEXT_NODE"
-};
-
-
-
-
 // Help for the CMDLine
 static const wxCmdLineEntryDesc g_cmdLineDesc [] =
 {
 		{wxCMD_LINE_SWITCH, "taskbar", "taskbar", "Move GUI to taskbar on Start"},
+		{wxCMD_LINE_OPTION, "debug", "debug", "Log details of categories: all or a list like net,steam"},
 		{wxCMD_LINE_NONE}
 };
 
@@ -146,11 +129,30 @@ bool timerStarted = false;
 // First fetch time
 time_t firstFetch;
 
+// First fetch got the last calls instead of the ones since the history
+bool initialFetch = false;
+
+// Format of the first fetch, JSON if its binary feed couldn't be read
+API_FORMAT backfillFormat = API_FORMAT_BINARY;
+
+
+// Snapshot of the page whose history is open
+wxString snapshotPath;
+
+// Calls came from the snapshot instead of the history
+bool fromSnapshot = false;
+
 
 // Implement the APP
 IMPLEMENT_APP(CallAdmin)
 
 
+// App Events
+BEGIN_EVENT_TABLE(CallAdmin, wxApp)
+	EVT_IDLE(CallAdmin::OnIdle)
+END_EVENT_TABLE()
+
+
 // Default no taskbar start
 bool CallAdmin::start_taskbar = false;
 
@@ -166,6 +168,10 @@ bool CallAdmin::OnInit()
 	}
 
 
+	// Time until the window is ready
+	wxStopWatch startTime;
+
+
 	// Check duplicate
 	static wxSingleInstanceChecker checkInstance("Call Admin - " + wxGetUserId());
 
@@ -177,6 +183,10 @@ bool CallAdmin::OnInit()
 	}
 
 
+	// Write the log to a file too
+	startLogFile();
+
+
 	// Create Config
 	g_config = new wxConfig("Call Admin");
 
@@ -216,13 +226,6 @@ bool CallAdmin::OnInit()
 		m_taskBarIcon = new TaskBarIcon();
 	}
 
-	// Reset Calls
-	for (int i=0; i < MAXCALLS; i++)
-	{
-		call_dialogs[i] = NULL;
-	}
-
-
 	// Delete .old file
 	remove(wxStandardPaths::Get().GetExecutablePath() + ".old");
 	remove(wxStandardPaths::Get().GetExecutablePath() + ".new");
@@ -240,6 +243,9 @@ bool CallAdmin::OnInit()
 	main_dialog->createWindow(start_taskbar);
 
 
+	// Log Action
+	LOG(LOG_CATEGORY_UI, LOG_LEVEL_INFO, "Window ready").field("ms", startTime.Time()).field("calls", call_store.getCount()).field("from", fromSnapshot ? "snapshot" : "history");
+
 	return true;
 }
 
@@ -266,16 +272,52 @@ void CallAdmin::OnInitCmdLine(wxCmdLineParser& parser)
  
 
 
-// Find -tasbar
+// Find -tasbar and -debug
 bool CallAdmin::OnCmdLineParsed(wxCmdLineParser& parser)
 {
 	start_taskbar = parser.Found("taskbar");
+
+	// Debug lines of some categories
+	wxString debug;
+
+	if (parser.Found("debug", &debug))
+	{
+		wxStringTokenizer tokens(debug, ",");
+
+		while (tokens.HasMoreTokens())
+		{
+			wxString name = tokens.GetNextToken().Trim().Trim(false);
+
+			LOG_CATEGORY category = getLogCategory((std::string)name);
+
+			for (int i=0; i < LOG_CATEGORY_COUNT; i++)
+			{
+				if (name == "all" || i == category)
+				{
+					logLevels[i] = LOG_LEVEL_DEBUG;
+				}
+			}
+		}
+	}
  
 	return true;
 }
 
 
 
+// Idle -> Show the lines logged meanwhile
+void CallAdmin::OnIdle(wxIdleEvent& event)
+{
+	if (drainLog())
+	{
+		event.RequestMore();
+	}
+
+	event.Skip();
+}
+
+
+
 
 // Timer events
 BEGIN_EVENT_TABLE(Timer, wxTimer)
@@ -287,49 +329,69 @@ END_EVENT_TABLE()
 void Timer::run(int milliSecs)
 {
 	// Log Action
-	LogAction("Start the Timer");
+	LOG(LOG_CATEGORY_APP, LOG_LEVEL_DEBUG, "Start the Timer").field("ms", milliSecs);
 
 	Start(milliSecs);
+
+	// Don't wait a whole interval for the first fetch
+	Notify();
 }
 
 // Timer executed
 void Timer::update(wxTimerEvent& WXUNUSED(event))
 {
-	// Check for Update
-	if (!timerStarted)
+	// Check for Update, not again when the first fetch is retried
+	if (!timerStarted && backfillFormat == API_FORMAT_BINARY)
 	{
 		checkUpdate();
 	}
 
 
-	std::string pager;
+	ApiNoticeRequest request;
 
 
 	// Page
 	if (!timerStarted)
 	{
-		pager = (page + "/notice.php?from=0&from_type=unixtime&key=" + key + "&sort=desc&limit=" + (wxString() << lastCalls));
+		// The first fetch can hold many calls, so it's asked for in the binary feed
+		// Webscripts without it answer in another format, which is detected
+		request.format = backfillFormat;
+
+		initialFetch = (call_history.getNewest() == 0);
+
+		if (initialFetch)
+		{
+			request.initial = true;
+			request.limit = lastCalls;
+		}
+		else
+		{
+			// Only what's new since the history, with some overlap
+			request.interval = (long)(time(0) - call_history.getNewest()) + step * 2;
+			request.handled = request.interval;
+		}
 	}
 	else
 	{
-		pager = (page + "/notice.php?from=" + (wxString() << (step * 2)) + "&from_type=interval&key=" + key + "&sort=asc&handled=" + (wxString() << (time(0) - firstFetch)));
+		request.interval = step * 2;
+		request.handled = (long)(time(0) - firstFetch);
 	}
 
 
 	// Store Player
 	if (main_dialog != NULL && main_dialog->wantStore())
 	{
-		pager = pager + "&store=1&steamid=" + steamid;
+		request.storeSteamID = steamid;
 	}
 	
 	// Get the Page
-	getPage(onNotice, pager);
+	getPage(onNotice, buildURL((std::string)page, (std::string)key, request));
 }
 
 
 
 
-void onNotice(char* error, wxString result, int WXUNUSED(x))
+void onNotice(const char* error, std::vector<char>& result, long long WXUNUSED(x))
 {
 	bool firstRun = false;
 
@@ -342,374 +404,146 @@ void onNotice(char* error, wxString result, int WXUNUSED(x))
 		firstRun = true;
 	}
 
-	// Valid result?
-	if (result != "")
+	// Decode the result in place
+	ApiNotice notice;
+
+	// Something went wrong ):
+	if (decodeNotice(error, result, notice) != API_OK)
 	{
-		// Everything good :)
-		if (strcmp(error, "") == 0)
+		attempts++;
+
+		// Log Action
+		LOG((notice.status == API_PARSE_ERROR) ? LOG_CATEGORY_PARSE : LOG_CATEGORY_NET, LOG_LEVEL_WARNING, "Couldn't get the calls").field("type", notice.getErrorType()).field("error", notice.getErrorText()).field("attempt", attempts);
+
+		// A binary feed that couldn't be read, so the first fetch is done again in JSON
+		if (firstRun && notice.status == API_PARSE_ERROR && notice.format == API_FORMAT_BINARY)
 		{
-			bool foundError = false;
-			bool foundNew = false;
+			backfillFormat = API_FORMAT_JSON;
+			timerStarted = false;
+		}
 
-			// Proceed XML result!
-			tinyxml2::XMLDocument doc;
-			tinyxml2::XMLNode *node;
-			tinyxml2::XMLError parseError;
+		// Max attempts reached?
+		if (attempts == maxAttempts)
+		{
+			// Close Dialogs and create reconnect main dialog
+			createReconnect(notice.getErrorMessage());
+		}
+		else
+		{
+			// Show the error to client
+			showError(notice.getErrorText(), notice.getErrorType());
+		}
 
-			// Parse the xml data
-			parseError = doc.Parse(result);
+		return;
+	}
 
-			// Parse Error?
-			if (parseError != tinyxml2::XML_SUCCESS)
-			{
-				foundError = true;
-				attempts++;
 
-				// Log Action
-				LogAction("Found a XML Error: " + (wxString)XMLErrorString[parseError]);
+	bool foundNew = false;
 
-				// Max attempts reached?
-				if (attempts == maxAttempts)
-				{
-					// Close Dialogs and create reconnect main dialog
-					createReconnect("XML Error: " + (wxString)XMLErrorString[parseError]);
-				}
-				else
-				{
-					// Create Parse Error
-					showError(XMLErrorString[parseError], "XML");
-				}
-			}
+	if (firstRun)
+	{
+		// Log Action
+		LOG(LOG_CATEGORY_NET, LOG_LEVEL_DEBUG, "Got the first calls").field("format", getFormatName(notice.format)).field("calls", notice.calls.size());
+	}
 
-			// No error so far, yeah!
-			if (!foundError)
-			{
-				// Goto xml child
-				node = doc.FirstChild();
 
-				// Goto CallAdmin
-				if (node != NULL)
-				{
-					node = node->NextSibling();
-				}
-				
-				// New Calls?
-				if (node != NULL)
-				{
-					// Init. Call List
-					int foundRows = 0;
-
-					// Only if first run
-					if (firstRun)
-					{
-						for (tinyxml2::XMLNode *node2 = node->FirstChild(); node2; node2 = node2->NextSibling())
-						{
-							// Search for foundRows
-							if ((wxString)node2->Value() == "foundRows")
-							{
-								// Get Rows
-								std::stringstream rows(node2->FirstChild()->Value());
-
-								rows >> foundRows;
-							
-								// Go on
-								break;
-							}
-						}
-					}
-
-
-					for (tinyxml2::XMLNode *node2 = node->FirstChild(); node2; node2 = node2->NextSibling())
-					{
-						// API Error?
-						if ((wxString)node2->Value() == "error")
-						{
-							foundError = true;
-							attempts++;
-
-							// Max attempts reached?
-							if (attempts == maxAttempts)
-							{
-								// Close Dialogs and create reconnect main dialog
-								createReconnect("API Error: " + (wxString)node2->FirstChild()->Value());
-							}
-							else
-							{
-								// API Errpr
-								showError((wxString)node2->FirstChild()->Value(), "API");
-							}
-
-							break;
-						}
-
-						// Row Count
-						if ((wxString)node2->Value() == "foundRows")
-						{
-							continue;
-						}
-
-
-						int dialog = -1;
-
-
-						// Normal Stepp
-						if (!firstRun)
-						{
-							// Look for a free place
-							for (int i=0; i < MAXCALLS; i++)
-							{
-								if (call_dialogs[i] == NULL)
-								{
-									dialog = i;
-
-									break;
-								}
-							}
-
-							// Everything is full, so clear Everything, client's problem oO, MAXCALLS is enough!
-							if (dialog == -1)
-							{
-								for (int i=0; i < MAXCALLS; i++)
-								{
-									if (call_dialogs[i] != NULL)
-									{
-										call_dialogs[i]->Destroy();
-										call_dialogs[i] = NULL;
-									}
-								}
-
-								dialog = 0;
-							}
-						}
-						else
-						{
-							// First run, update call list
-							dialog = foundRows - 1;
-						}
-
-
-						// Api is fine :)
-						int found = 0;
-
-
-						// Create the new CallDialog
-						CallDialog *newDialog = new CallDialog("New Incoming Call");
-
-
-						// Valid?
-						if (newDialog == NULL)
-						{
-							return;
-						}
-
-
-						// Put in ALL needed DATA
-						for (tinyxml2::XMLNode *node3 = node2->FirstChild(); node3; node3 = node3->NextSibling())
-						{
-							if ((wxString)node3->Value() == "callID")
-							{
-								found++;
-								newDialog->setCallID(node3->FirstChild()->Value());
-							}
-
-							if ((wxString)node3->Value() == "fullIP")
-							{
-								found++;
-								newDialog->setIP(node3->FirstChild()->Value());
-							}
-
-							if ((wxString)node3->Value() == "serverName")
-							{
-								found++;
-								newDialog->setName(node3->FirstChild()->Value());
-							}
-
-							if ((wxString)node3->Value() == "targetName")
-							{
-								found++;
-								newDialog->setTarget(node3->FirstChild()->Value());
-							}
-
-							if ((wxString)node3->Value() == "targetID")
-							{
-								found++;
-								newDialog->setTargetID(node3->FirstChild()->Value());
-							}
-
-							if ((wxString)node3->Value() == "targetReason")
-							{
-								found++;
-								newDialog->setReason(node3->FirstChild()->Value());
-							}
-
-							if ((wxString)node3->Value() == "clientName")
-							{
-								found++;
-								newDialog->setClient(node3->FirstChild()->Value());
-							}
-
-							if ((wxString)node3->Value() == "clientID")
-							{
-								found++;
-								newDialog->setClientID(node3->FirstChild()->Value());
-							}
-
-							if ((wxString)node3->Value() == "reportedAt")
-							{
-								found++;
-								newDialog->setTime(node3->FirstChild()->Value());
-							}
-
-							if ((wxString)node3->Value() == "callHandled")
-							{
-								found++;
-								newDialog->setHandled(strcmp(node3->FirstChild()->Value(), "1") == 0);
-							}
-						}
-
-						bool findDuplicate = false;
-
-
-						// Check duplicate Entries
-						for (int i=0; i < MAXCALLS; i++)
-						{
-							if (i != dialog && call_dialogs != NULL)
-							{
-								if (call_dialogs[i] != NULL)
-								{
-									// Operator overloading :)
-									if ((*call_dialogs[i]) == (*newDialog))
-									{
-										findDuplicate = true;
-
-										// Call is now handled
-										if (newDialog->getHandled() && !call_dialogs[i]->getHandled())
-										{
-											main_dialog->setHandled(i);
-										}
-
-										// That's enough
-										break;
-									}
-								}
-							}
-						}
-
-						// Found all necessary items?
-						if (found != 10 || findDuplicate)
-						{
-							// Something went wrong or duplicate
-							newDialog->Destroy();
-						}
-						else
-						{
-							// New call
-							foundNew = true;
-
-							// Add the new Call to the Call box
-							char buffer[80];
-
-							wxString text;
-
-							// But first we need a Time
-							time_t tt = (time_t)newDialog->getTime();
-
-							struct tm* dt = localtime(&tt);
-
-							strftime(buffer, sizeof(buffer), "%H:%M", dt);
-
-
-							newDialog->SetTitle("Call At " + (wxString)buffer);
-
-
-							text = (wxString)buffer + " - " + newDialog->getServer();
-
-							// Add the Text
-							newDialog->setBoxText(text);
-
-							// Now START IT!
-							newDialog->setID(dialog);
-
-
-							// Don't show calls on first Run
-							if (firstRun)
-							{
-								foundRows--;
-								newDialog->startCall(false);
-							}
-							else
-							{
-								// Log Action
-								LogAction("We have a new Call");
-								newDialog->startCall(main_dialog->isAvailable() && !isOtherInFullscreen());
-							}
-
-							newDialog->takeover->Enable(!newDialog->getHandled());
-
-							call_dialogs[dialog] = newDialog;
-						}
-					}
-				}
-			}
+	// Init. Call List
+	for (size_t i = 0; i < notice.calls.size(); i++)
+	{
+		// The initial fetch gets the newest calls first, but the store wants them by age
+		ApiCall& newCall = notice.calls[(firstRun && initialFetch) ? notice.calls.size() - 1 - i : i];
 
-			// Everything is good, set attempts to zero
-			if (!foundError && main_dialog != NULL)
-			{
-				// Reset attempts
-				attempts = 0;
 
-				// Updated Main Interface
-				main_dialog->SetTitle("Call Admin Client");
-				main_dialog->setEventText("Waiting for a new report...");
+		// Only the record, the dialog is created when the call is opened
+		CallRecord *newRecord = new CallRecord(newCall);
 
-				// Update Call List
-				if (foundNew)
-				{
-					// Update call list
-					main_dialog->updateCall();
-
-					// Play Sound
-					if (main_dialog->wantSound() && !firstRun && main_dialog->isAvailable())
-					{
-						wxSound* soundfile;
-
-						#if defined(__WXMSW__)
-							soundfile = new wxSound("calladmin_sound", true);
-						#else
-							wxLogNull nolog;
-
-							soundfile = new wxSound(getAppPath("resources/calladmin_sound.wav"), false);
-						#endif
-						
-						if (soundfile != NULL && soundfile->IsOk())
-						{
-							soundfile->Play(wxSOUND_ASYNC);
-
-							// Clean
-							delete soundfile;
-						}
-					}
-				}
-			}
+
+		// Check duplicate Entries
+		CallHandle duplicate = call_store.find(*newRecord);
+
+		// Given up by the store, but already in the history
+		bool known = (duplicate == INVALID_CALL && call_index.isKnown(*newRecord));
+
+		// Call is now handled, the history and statistics only count it once
+		if (duplicate != INVALID_CALL && newRecord->handled)
+		{
+			main_dialog->setHandled(duplicate);
 		}
-		else
+		else if (known && newRecord->handled && call_index.setHandled(*newRecord))
+		{
+			long handledAt = (long)time(0);
+
+			call_history.appendHandled(*newRecord, handledAt);
+			call_stats.addHandled(*newRecord, handledAt);
+		}
+
+		// Found all necessary items?
+		if (newCall.found != API_CALL_FIELDS || duplicate != INVALID_CALL || known)
 		{
-			// Something went wrong ):
-			attempts++;
+			// Something went wrong or duplicate
+			delete newRecord;
 
+			continue;
+		}
+
+
+		// Memory budget used up, so give up the oldest calls
+		while (call_store.getCount() > 0 && !call_store.hasRoom(*newRecord))
+		{
+			removeCall(call_store.getOldest());
+		}
+
+		// Keep it on disk, searchable and counted
+		if (call_history.append(*newRecord))
+		{
+			call_index.add((unsigned int)(call_history.getCount() - 1), *newRecord);
+		}
+
+		call_stats.addCall(*newRecord);
+
+		// New call
+		CallHandle id = call_store.add(newRecord);
+
+		foundNew = true;
+
+
+		// Don't show calls on first Run
+		if (!firstRun)
+		{
 			// Log Action
-			LogAction("New CURL Error: " + (std::string)error);
+			LOG(LOG_CATEGORY_NET, LOG_LEVEL_INFO, "We have a new Call");
 
-			// Max attempts reached?
-			if (attempts == maxAttempts)
+			if (main_dialog->isAvailable() && !isOtherInFullscreen())
 			{
-				// Create reconnect main dialog
-				createReconnect("CURL Error: " + (std::string)error);
+				showCall(id);
 			}
-			else
+		}
+	}
+
+
+	// Everything is good, set attempts to zero
+	if (main_dialog != NULL)
+	{
+		// Reset attempts
+		attempts = 0;
+
+		// Updated Main Interface
+		main_dialog->SetTitle("Call Admin Client");
+		main_dialog->setEventText("Waiting for a new report...");
+
+		// The call list already got the new calls from the store
+		if (foundNew)
+		{
+			// Play Sound
+			if (main_dialog->wantSound() && !firstRun && main_dialog->isAvailable())
 			{
-				// Show the error to client
-				showError(error, "CURL");
+				// Loaded once, kept while it plays
+				wxSound* soundfile = getResourceSound("calladmin_sound");
+
+				if (soundfile != NULL && soundfile->IsOk())
+				{
+					soundfile->Play(wxSOUND_ASYNC);
+				}
 			}
 		}
 	}
@@ -726,16 +560,18 @@ wxThread::ExitCode curlThread::Entry()
 		// Event
 		wxCommandEvent event(wxEVT_COMMAND_MENU_SELECTED, wxID_ThreadHandled);
 
-		// Response
-		std::ostringstream stream;
+		// Response, parsed in place later
+		std::vector<char> body;
 
 		// Init Curl
 		CURL *curl = curl_easy_init();
 		
 		if (curl != NULL)
 		{
-			// Error
+			// Error, curl doesn't fill it for every failure
 			char ebuf[CURL_ERROR_SIZE];
+
+			ebuf[0] = '\0';
 			
 			
 			// Configurate Curl
@@ -746,22 +582,35 @@ wxThread::ExitCode curlThread::Entry()
 			curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, timeout);
 			curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
 			curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_data);
-			curl_easy_setopt(curl, CURLOPT_WRITEDATA, &stream);
+			curl_easy_setopt(curl, CURLOPT_WRITEDATA, &body);
 
 			// Perform Curl
 			CURLcode res = curl_easy_perform(curl);
 
+			// The parsers terminate the last value behind the body
+			if (!body.empty())
+			{
+				body.push_back('\0');
+			}
+
+			ThreadData *data;
+
 			// Everything good :)
 			if (res == CURLE_OK)
 			{
-				event.SetClientObject(new ThreadData(function, stream.str(), "", x));
+				data = new ThreadData(function, "", x);
 			}
 			else
 			{
 				// Error ):
-				event.SetClientObject(new ThreadData(function, stream.str(), ebuf, x));
+				data = new ThreadData(function, (ebuf[0] != '\0') ? ebuf : curl_easy_strerror(res), x);
 			}
 
+			// Hand the body over without copying it
+			data->getContent().swap(body);
+
+			event.SetClientObject(data);
+
 			// Clean Curl
 			curl_easy_cleanup(curl);
 
@@ -774,7 +623,7 @@ wxThread::ExitCode curlThread::Entry()
 			return (wxThread::ExitCode)0;
 		}
 
-		event.SetClientObject(new ThreadData(function, "", "", x));
+		event.SetClientObject(new ThreadData(function, "", x));
 
 		// Add Event Handler
 		if (main_dialog != NULL)
@@ -792,13 +641,13 @@ wxThread::ExitCode curlThread::Entry()
 // Curl receive data -> write to buffer
 size_t write_data(void *buffer, size_t size, size_t nmemb, void *userp)
 {
-	std::ostringstream *data = (std::ostringstream*)userp;
+	std::vector<char> *data = (std::vector<char>*)userp;
 
 	if (data != NULL)
 	{
 		size_t count = size * nmemb;
 
-		data->write((char*)buffer, count);
+		data->insert(data->end(), (char*)buffer, (char*)buffer + count);
 
 		return count;
 	}
@@ -813,7 +662,7 @@ size_t write_data(void *buffer, size_t size, size_t nmemb, void *userp)
 
 
 // Get Page
-void getPage(callback function, wxString page, int x)
+void getPage(callback function, wxString page, long long x)
 {
 	new curlThread(function, page, x);
 }
@@ -834,7 +683,7 @@ void createReconnect(wxString error)
 	}
 
 	// Log Action
-	LogAction("Create a reconnect window");
+	LOG(LOG_CATEGORY_UI, LOG_LEVEL_INFO, "Create a reconnect window");
 
 	main_dialog->SetTitle("Couldn't Connect");
 	main_dialog->setEventText(error);
@@ -860,7 +709,7 @@ void createReconnect(wxString error)
 void showError(wxString error, wxString type)
 {
 	// Log Action
-	LogAction(type + " Error: " + error);
+	LOG(LOG_CATEGORY_APP, LOG_LEVEL_ERROR, "Error").field("type", type).field("error", error);
 
 	if (m_taskBarIcon != NULL)
 	{
@@ -880,6 +729,9 @@ void exitProgramm()
 		// Mark as ended
 		end = true;
 
+		// Start with this state the next time
+		saveSnapshot();
+
 		// First disappear Windows
 		if (main_dialog != NULL)
 		{
@@ -924,20 +776,9 @@ void exitProgramm()
 		}
 
 		// Calls are unimportant
-		for (int i=0; i < MAXCALLS; i++)
-		{
-			if (call_dialogs[i] != NULL)
-			{
-				// Stop Avatar Timer
-				if (call_dialogs[i]->avatarTimer != NULL && call_dialogs[i]->avatarTimer->IsRunning())
-				{
-					call_dialogs[i]->avatarTimer->Stop();
-				}
+		clearCalls();
 
-				call_dialogs[i]->Destroy();
-				call_dialogs[i] = NULL;
-			}
-		}
+		call_history.close();
 
 
 		// We don't need Steam support
@@ -953,6 +794,12 @@ void exitProgramm()
 			update_thread->Delete();
 			update_thread = NULL;
 		}
+
+		// Images nobody shows anymore
+		clearResources();
+
+		// Last lines to the log file
+		stopLogFile();
 	}
 }
 
@@ -960,6 +807,173 @@ void exitProgramm()
 
 
 
+// Write the state of the open page to its snapshot
+void saveSnapshot()
+{
+	if (!call_history.isOpen() || snapshotPath.IsEmpty())
+	{
+		return;
+	}
+
+	CallSnapshot snapshot;
+
+	snapshot.historyCount = call_history.getCount();
+	snapshot.newest = call_history.getNewest();
+	snapshot.trackers = getTrackers();
+
+	pruneAvatarCache(AVATAR_CACHE_MAX);
+
+	for (std::map<unsigned long long, long>::iterator it = avatarCache.begin(); it != avatarCache.end(); ++it)
+	{
+		snapshot.avatars.push_back(SnapshotAvatar(it->first, it->second));
+	}
+
+	if (!snapshot.write((std::string)snapshotPath, call_store, call_index, call_stats))
+	{
+		LOG(LOG_CATEGORY_APP, LOG_LEVEL_WARNING, "Couldn't write the snapshot").field("path", snapshotPath);
+	}
+}
+
+
+
+// Open the call history of the page and load its newest calls
+void loadHistory()
+{
+	call_history.close();
+	call_index.clear();
+	call_stats.clear();
+
+	snapshotPath = "";
+	fromSnapshot = false;
+
+
+	// One history per page, named by a hash of it
+	wxString dir = wxStandardPaths::Get().GetUserDataDir();
+
+	if (!wxFileName::DirExists(dir) && !wxFileName::Mkdir(dir, wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL))
+	{
+		LOG(LOG_CATEGORY_APP, LOG_LEVEL_ERROR, "Couldn't create the history directory").field("path", dir);
+
+		return;
+	}
+
+	unsigned int hash = fnv1a((std::string)page);
+
+	wxString name = dir + wxFileName::GetPathSeparator() + wxString::Format("history-%08x", hash);
+
+	if (!call_history.open((std::string)(name + ".dat"), (std::string)(name + ".idx")))
+	{
+		LOG(LOG_CATEGORY_APP, LOG_LEVEL_ERROR, "Couldn't open the call history");
+
+		return;
+	}
+
+	snapshotPath = dir + wxFileName::GetPathSeparator() + wxString::Format("snapshot-%08x.dat", hash);
+
+
+	wxStopWatch loadTime;
+
+	// State of the last run, its index and statistics cover the records before historyCount
+	CallSnapshot snapshot;
+	size_t indexed = 0;
+
+	if (snapshot.read((std::string)snapshotPath, call_index, call_stats))
+	{
+		if (snapshot.historyCount <= call_history.getCount())
+		{
+			indexed = snapshot.historyCount;
+		}
+		else
+		{
+			call_index.clear();
+			call_stats.clear();
+		}
+
+		for (size_t i=0; i < snapshot.avatars.size(); i++)
+		{
+			avatarCache[snapshot.avatars[i].steamID] = snapshot.avatars[i].loadedAt;
+		}
+
+		restoreTrackers(snapshot.trackers);
+
+		// Its calls are only current if nothing came into the history since
+		if (snapshot.historyCount == call_history.getCount() && snapshot.newest == call_history.getNewest())
+		{
+			snapshot.restore(call_store);
+
+			fromSnapshot = true;
+		}
+	}
+
+
+	// Only the newest calls fit into the store, find the first of them
+	CallRecord record;
+
+	size_t first = call_history.getCount();
+	size_t memory = 0;
+
+	while (first > 0 && !fromSnapshot)
+	{
+		if (call_history.read(first - 1, record) == HISTORY_CALL)
+		{
+			memory += CallStore::getSize(record);
+
+			if (memory > call_store.getBudget())
+			{
+				break;
+			}
+		}
+
+		first--;
+	}
+
+
+	// Index and count the calls the snapshot doesn't know and replay the newest ones, handled marks come after their call
+	for (size_t i = std::min(first, indexed); i < call_history.getCount(); i++)
+	{
+		long handledAt;
+
+		HISTORY_RECORD kind = call_history.read(i, record, &handledAt);
+
+		if (i >= indexed && kind == HISTORY_CALL)
+		{
+			call_index.add((unsigned int)i, record);
+			call_stats.addCall(record);
+		}
+		else if (i >= indexed && kind == HISTORY_HANDLED)
+		{
+			call_index.setHandled(record);
+			call_stats.addHandled(record, handledAt);
+		}
+
+		if (i < first)
+		{
+			continue;
+		}
+
+		if (kind == HISTORY_CALL && call_store.find(record) == INVALID_CALL)
+		{
+			// No dialogs yet, so the store can give them up directly
+			while (call_store.getCount() > 0 && !call_store.hasRoom(record))
+			{
+				call_store.remove(call_store.getOldest());
+			}
+
+			call_store.add(new CallRecord(record));
+		}
+		else if (kind == HISTORY_HANDLED)
+		{
+			call_store.setHandled(call_store.find(record));
+		}
+	}
+
+	// Log Action
+	LOG(LOG_CATEGORY_APP, LOG_LEVEL_INFO, "Loaded calls").field("calls", call_store.getCount()).field("from", fromSnapshot ? "snapshot" : "history").field("ms", loadTime.Time());
+}
+
+
+
+
 #if defined(__WXMSW__)
 	// Stupid Wchars...
 	std::wstring s2ws(wxString s)
@@ -1016,7 +1030,7 @@ wxString getAppPath(wxString file)
 void checkUpdate()
 {
 	// Log Action
-	LogAction("Checking for a new Update");
+	LOG(LOG_CATEGORY_UPDATE, LOG_LEVEL_INFO, "Checking for a new Update");
 
 	if (m_taskBarIcon != NULL)
 	{
@@ -1027,13 +1041,16 @@ void checkUpdate()
 
 
 // Handle Update Page
-void onUpdate(char* error, wxString result, int WXUNUSED(x))
+void onUpdate(const char* error, std::vector<char>& body, long long WXUNUSED(x))
 {
 	// Log Action
-	LogAction("Retrieve information about new version");
+	LOG(LOG_CATEGORY_UPDATE, LOG_LEVEL_DEBUG, "Retrieve information about new version");
 
 	wxString newVersion;
 
+	// Without its terminator
+	std::string result = body.empty() ? "" : std::string(body.begin(), body.end() - 1);
+
 	if (result != "")
 	{
 		// Everything good :)
@@ -1059,7 +1076,7 @@ void onUpdate(char* error, wxString result, int WXUNUSED(x))
 		else
 		{
 			// Log Action
-			LogAction("Update check failed: " + (wxString)error);
+			LOG(LOG_CATEGORY_UPDATE, LOG_LEVEL_WARNING, "Update check failed").field("error", error);
 
 			if (m_taskBarIcon != NULL)
 			{
@@ -1075,7 +1092,7 @@ void onUpdate(char* error, wxString result, int WXUNUSED(x))
 		if (newVersion != version && about != NULL && notebook != NULL)
 		{
 			// Log Action
-			LogAction("Found a new Version: " + newVersion);
+			LOG(LOG_CATEGORY_UPDATE, LOG_LEVEL_INFO, "Found a new Version").field("version", newVersion);
 
 			// Update About Panel
 			about->enableDownload(true);
@@ -1089,7 +1106,12 @@ void onUpdate(char* error, wxString result, int WXUNUSED(x))
 			}
 
 			// Goto About
-			notebook->SetSelection(4);
+			int page = notebook->FindPage(about);
+
+			if (page != wxNOT_FOUND)
+			{
+				notebook->SetSelection(page);
+			}
 
 			if (m_taskBarIcon != NULL)
 			{
@@ -1099,7 +1121,7 @@ void onUpdate(char* error, wxString result, int WXUNUSED(x))
 		else
 		{
 			// Log Action
-			LogAction("Version is up to date");
+			LOG(LOG_CATEGORY_UPDATE, LOG_LEVEL_INFO, "Version is up to date").field("version", version);
 
 			if (m_taskBarIcon != NULL)
 			{
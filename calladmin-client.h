@@ -28,15 +28,13 @@
 #pragma once
 
 
-#define MAXCALLS 200
-
-
 
 // Precomp Header
 #include <wx/wxprec.h>
 
 // c++ libs
 #include <string>
+#include <vector>
 
 // We need WX
 #ifndef WX_PRECOMP
@@ -91,6 +89,12 @@ public:
 
 	// Start in Taskbar?
 	static bool start_taskbar;
+
+protected:
+	// Nothing else to do
+	void OnIdle(wxIdleEvent& event);
+
+	DECLARE_EVENT_TABLE()
 };
 
 
@@ -114,7 +118,9 @@ public:
 
 
 // Thread for Curl Performances
-typedef void (*callback)(char*, wxString, int);
+// The response body is handed over mutable, so callbacks can parse it in place
+// It's followed by a NUL, an empty body means nothing was received
+typedef void (*callback)(const char*, std::vector<char>&, long long);
 
 class curlThread: public wxThread
 {
@@ -125,13 +131,13 @@ private:
 	// Page
 	wxString page;
 
-	// Optional Parameter
-	int x;
+	// Optional Parameter, the handle of a call
+	long long x;
 
 public:
 
 	// Create and Start
-	curlThread(callback f, wxString p, int extra) : wxThread() {function = f; page = p; x = extra; this->Create(); this->Run();}
+	curlThread(callback f, wxString p, long long extra) : wxThread() {function = f; page = p; x = extra; this->Create(); this->Run();}
 
 	virtual ExitCode Entry();
 };
@@ -145,22 +151,22 @@ private:
 	// Callback function
 	callback function;
 
-	// Callback function
-	wxString content;
+	// Response body and its terminator
+	std::vector<char> content;
 
 	// Error
-	char* error;
+	std::string error;
 
-	// Optional Parameter
-	int x;
+	// Optional Parameter, the handle of a call
+	long long x;
 
 public:
-	ThreadData(callback func, wxString cont, char* err, int extra) {function = func; content = cont, error = err, x = extra;}
+	ThreadData(callback func, const char* err, long long extra) {function = func; error = err, x = extra;}
 
 	callback getCallback() {return function;}
-	wxString getContent() {return content;}
-	char* getError() {return error;}
-	int getExtra() {return x;}
+	std::vector<char>& getContent() {return content;}
+	const char* getError() {return error.c_str();}
+	long long getExtra() {return x;}
 };
 
 
@@ -238,6 +244,12 @@ void createReconnect(wxString error);
 void showError(wxString error, wxString type);
 void exitProgramm();
 
+// Open the call history of the page and load its newest calls
+void loadHistory();
+
+// Keep the calls, trackers and avatars of the page for the next start
+void saveSnapshot();
+
 wxString getAppPath(wxString file);
 
 
@@ -249,9 +261,9 @@ wxString getAppPath(wxString file);
 
 
 // Curl Stuff
-void getPage(callback function, wxString page, int x=0);
-void onNotice(char* error, wxString result, int x);
-void onUpdate(char* error, wxString result, int x);
+void getPage(callback function, wxString page, long long x=0);
+void onNotice(const char* error, std::vector<char>& result, long long x);
+void onUpdate(const char* error, std::vector<char>& result, long long x);
 
 size_t write_data(void *buffer, size_t size, size_t nmemb, void *userp);
 
@@ -0,0 +1,613 @@
+/**
+ * -----------------------------------------------------
+ * File        callindex.cpp
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+// c++ libs
+#include <stdio.h>
+#include <algorithm>
+#include <iterator>
+
+// Project
+#include "callindex.h"
+#include "codec.h"
+
+
+
+// Index of the call history
+CallIndex call_index;
+
+
+// New terms searched one by one before they're sorted in
+#define CALL_INDEX_UNSORTED 256
+
+
+
+// Word character? Bytes of UTF-8 sequences count as well
+static bool isWordChar(unsigned char c)
+{
+	return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c >= 0x80;
+}
+
+
+// 64bit SteamID as word
+static std::string steamIDWord(unsigned long long steamid)
+{
+	char buffer[32];
+
+	sprintf(buffer, "%llu", steamid);
+
+	return buffer;
+}
+
+
+
+// Init. the index
+CallIndex::CallIndex()
+{
+	sorted = 0;
+	count = 0;
+	last = 0;
+
+	rehash();
+}
+
+
+// Remove everything
+void CallIndex::clear()
+{
+	terms.clear();
+	texts.clear();
+	order.clear();
+	known.clear();
+	handled.clear();
+
+	sorted = 0;
+	count = 0;
+	last = 0;
+
+	rehash();
+}
+
+
+
+// Split a text into lower case words
+void CallIndex::split(const std::string& text, std::vector<std::string>& words)
+{
+	std::string word;
+
+	for (size_t i=0; i <= text.size(); i++)
+	{
+		unsigned char c = (i < text.size()) ? (unsigned char)text[i] : 0;
+
+		if (isWordChar(c))
+		{
+			word += (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : (char)c;
+		}
+		else if (!word.empty())
+		{
+			words.push_back(word);
+			word.clear();
+		}
+	}
+}
+
+
+
+// Term of a word, -1 if unknown
+int CallIndex::find(const std::string& word) const
+{
+	unsigned int wordHash = fnv1a(word);
+
+	for (int i = buckets[wordHash & (buckets.size() - 1)]; i != -1; i = terms[i].next)
+	{
+		if (terms[i].hash == wordHash && terms[i].word == word)
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+
+// Build the buckets for the current terms
+void CallIndex::rehash()
+{
+	size_t capacity = 16;
+
+	while (capacity < terms.size() * 2)
+	{
+		capacity *= 2;
+	}
+
+	buckets.assign(capacity, -1);
+
+	for (int i=0; i < (int)terms.size(); i++)
+	{
+		size_t bucket = terms[i].hash & (capacity - 1);
+
+		terms[i].next = buckets[bucket];
+		buckets[bucket] = i;
+	}
+}
+
+
+
+// Add a document to a word, gives the term
+int CallIndex::addTerm(const std::string& word, unsigned int document)
+{
+	int term = find(word);
+
+	// New word
+	if (term == -1)
+	{
+		term = (int)terms.size();
+
+		terms.push_back(Term());
+
+		Term& added = terms.back();
+
+		added.word = word;
+		added.hash = fnv1a(word);
+
+		size_t bucket = added.hash & (buckets.size() - 1);
+
+		added.next = buckets[bucket];
+		buckets[bucket] = term;
+
+		order.push_back(term);
+
+		if (terms.size() > buckets.size())
+		{
+			rehash();
+		}
+	}
+
+	addPosting(term, document);
+
+	return term;
+}
+
+
+// Add a document to a term, once
+void CallIndex::addPosting(int term, unsigned int document)
+{
+	Postings& postings = terms[term].postings;
+
+	if (postings.empty() || postings.back() != document)
+	{
+		postings.push_back(document);
+	}
+}
+
+
+// Add all words of an interned text
+void CallIndex::addText(const PooledString& text, unsigned int document)
+{
+	StringHandle handle = text.getHandle();
+
+	if (handle == EMPTY_STRING)
+	{
+		return;
+	}
+
+	if ((size_t)handle >= texts.size())
+	{
+		texts.resize(handle + 1);
+	}
+
+	TextTerms& known = texts[handle];
+	unsigned int serial = call_strings.getSerial(handle);
+
+
+	// Split before
+	if (known.serial == serial)
+	{
+		for (size_t i=0; i < known.terms.size(); i++)
+		{
+			addPosting(known.terms[i], document);
+		}
+
+		return;
+	}
+
+	known.serial = serial;
+	known.terms.clear();
+
+	const std::string& value = text.str();
+
+	word.clear();
+
+	for (size_t i=0; i <= value.size(); i++)
+	{
+		unsigned char c = (i < value.size()) ? (unsigned char)value[i] : 0;
+
+		if (isWordChar(c))
+		{
+			word += (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : (char)c;
+		}
+		else if (!word.empty())
+		{
+			known.terms.push_back(addTerm(word, document));
+			word.clear();
+		}
+	}
+}
+
+
+
+// Index a call
+void CallIndex::add(unsigned int document, const CallRecord& record)
+{
+	addText(record.serverName, document);
+	addText(record.targetName, document);
+	addText(record.clientName, document);
+	addText(record.targetReason, document);
+
+	if (record.targetID != 0)
+	{
+		addTerm(steamIDWord(record.targetID), document);
+	}
+
+	if (record.clientID != 0)
+	{
+		addTerm(steamIDWord(record.clientID), document);
+	}
+
+	known.insert(callKey(record));
+
+	if (record.handled)
+	{
+		handled.insert(callKey(record));
+	}
+
+	count++;
+	last = document;
+}
+
+
+// A call was handled after it was added
+bool CallIndex::setHandled(const CallRecord& record)
+{
+	return handled.insert(callKey(record)).second;
+}
+
+
+// Key of a call: hash of the callID and reportedAt
+unsigned long long CallIndex::callKey(const CallRecord& record)
+{
+	return ((unsigned long long)fnv1a(record.callID) << 32) | (unsigned int)record.reportedAt;
+}
+
+
+
+// Words and their documents
+//
+//   varint  calls, varint last document
+//   varint  number of words, then per word
+//     string  the word
+//     varint  number of documents, then the documents ascending, each as
+//             its distance to the one before
+//   varint  number of calls, then their keys ascending as u64
+//   varint  number of handled calls, then their keys ascending as u64
+void CallIndex::write(std::string& out) const
+{
+	writeVarint(out, count);
+	writeVarint(out, last);
+	writeVarint(out, terms.size());
+
+	for (size_t i=0; i < terms.size(); i++)
+	{
+		const Postings& postings = terms[i].postings;
+
+		writeString(out, terms[i].word);
+		writeVarint(out, postings.size());
+
+		for (size_t j=0; j < postings.size(); j++)
+		{
+			writeVarint(out, postings[j] - ((j > 0) ? postings[j - 1] : 0));
+		}
+	}
+
+	const std::set<unsigned long long>* keys[] = {&known, &handled};
+
+	for (int k=0; k < 2; k++)
+	{
+		writeVarint(out, keys[k]->size());
+
+		for (std::set<unsigned long long>::const_iterator it = keys[k]->begin(); it != keys[k]->end(); ++it)
+		{
+			writeLittle(out, *it, 8);
+		}
+	}
+}
+
+
+// Read what write() wrote
+bool CallIndex::read(CodecReader& reader)
+{
+	clear();
+
+	count = (size_t)reader.readVarint();
+	last = (unsigned int)reader.readVarint();
+
+	size_t number = reader.readCount();
+
+	for (size_t i=0; i < number && !reader.hasFailed(); i++)
+	{
+		terms.push_back(Term());
+
+		Term& term = terms.back();
+
+		term.word = reader.readString();
+		term.hash = fnv1a(term.word);
+
+		size_t documents = reader.readCount();
+		unsigned int document = 0;
+
+		term.postings.reserve(documents);
+
+		for (size_t j=0; j < documents; j++)
+		{
+			document += (unsigned int)reader.readVarint();
+
+			term.postings.push_back(document);
+		}
+
+		order.push_back((int)i);
+	}
+
+	std::set<unsigned long long>* keys[] = {&known, &handled};
+
+	for (int k=0; k < 2; k++)
+	{
+		number = reader.readCount();
+
+		for (size_t i=0; i < number && !reader.hasFailed(); i++)
+		{
+			keys[k]->insert(keys[k]->end(), reader.readU64());
+		}
+	}
+
+	if (reader.hasFailed())
+	{
+		clear();
+
+		return false;
+	}
+
+	// Sorted for prefixes when they're first looked up
+	rehash();
+
+	return true;
+}
+
+
+
+// Orders terms by their word
+class CallIndex::TermOrder
+{
+private:
+	const std::deque<CallIndex::Term>& terms;
+
+public:
+	TermOrder(const std::deque<CallIndex::Term>& all) : terms(all) {}
+
+	bool operator()(int x, int y) const {return terms[x].word < terms[y].word;}
+	bool operator()(int x, const std::string& word) const {return terms[x].word < word;}
+};
+
+
+// Sort the new terms in
+void CallIndex::sortTerms() const
+{
+	std::sort(order.begin(), order.end(), TermOrder(terms));
+
+	sorted = order.size();
+}
+
+
+
+// Documents of a word
+void CallIndex::lookup(const std::string& word, bool prefix, Postings& result) const
+{
+	result.clear();
+
+	if (!prefix)
+	{
+		int term = find(word);
+
+		if (term != -1)
+		{
+			result = terms[term].postings;
+		}
+
+		return;
+	}
+
+
+	// Only a few new terms are searched one by one
+	if (order.size() - sorted > CALL_INDEX_UNSORTED)
+	{
+		sortTerms();
+	}
+
+
+	// All terms starting with it
+	std::vector<int> matching;
+
+	std::vector<int>::const_iterator it = std::lower_bound(order.begin(), order.begin() + sorted, word, TermOrder(terms));
+
+	for (; it != order.begin() + sorted && terms[*it].word.compare(0, word.size(), word) == 0; ++it)
+	{
+		matching.push_back(*it);
+	}
+
+	for (size_t i = sorted; i < order.size(); i++)
+	{
+		if (terms[order[i]].word.compare(0, word.size(), word) == 0)
+		{
+			matching.push_back(order[i]);
+		}
+	}
+
+	if (matching.size() == 1)
+	{
+		result = terms[matching[0]].postings;
+
+		return;
+	}
+
+
+	// Merge them: few documents are sorted, many are marked
+	size_t total = 0;
+
+	for (size_t i=0; i < matching.size(); i++)
+	{
+		total += terms[matching[i]].postings.size();
+	}
+
+	if (total * 8 < (size_t)last)
+	{
+		for (size_t i=0; i < matching.size(); i++)
+		{
+			result.insert(result.end(), terms[matching[i]].postings.begin(), terms[matching[i]].postings.end());
+		}
+
+		std::sort(result.begin(), result.end());
+		result.erase(std::unique(result.begin(), result.end()), result.end());
+	}
+	else
+	{
+		std::vector<bool> marks((size_t)last + 1, false);
+
+		for (size_t i=0; i < matching.size(); i++)
+		{
+			const Postings& postings = terms[matching[i]].postings;
+
+			for (size_t j=0; j < postings.size(); j++)
+			{
+				marks[postings[j]] = true;
+			}
+		}
+
+		for (size_t i=0; i < marks.size(); i++)
+		{
+			if (marks[i])
+			{
+				result.push_back((unsigned int)i);
+			}
+		}
+	}
+}
+
+
+
+// Search for calls
+void CallIndex::search(const std::string& query, std::vector<unsigned int>& results, size_t limit) const
+{
+	results.clear();
+
+
+	// Words of the query, SteamIDs as a whole
+	std::vector<std::string> words;
+	std::string part;
+
+	for (size_t i=0; i <= query.size(); i++)
+	{
+		if (i < query.size() && query[i] != ' ' && query[i] != '\t')
+		{
+			part += query[i];
+
+			continue;
+		}
+
+		if (part.empty())
+		{
+			continue;
+		}
+
+		unsigned long long steamid = 0;
+
+		if (part.size() > 6 && (part.compare(0, 6, "STEAM_") == 0 || part.compare(0, 6, "steam_") == 0))
+		{
+			steamid = parseSteamID(part.c_str());
+		}
+
+		if (steamid != 0)
+		{
+			words.push_back(steamIDWord(steamid));
+		}
+		else
+		{
+			split(part, words);
+		}
+
+		part.clear();
+	}
+
+	if (words.empty())
+	{
+		return;
+	}
+
+	// The last word may still be typed
+	bool prefix = (query[query.size() - 1] != ' ' && query[query.size() - 1] != '\t');
+
+
+	// Intersect the documents of all words
+	Postings matches;
+	Postings postings;
+	Postings merged;
+
+	for (size_t i=0; i < words.size(); i++)
+	{
+		lookup(words[i], prefix && i == words.size() - 1, postings);
+
+		if (i == 0)
+		{
+			matches.swap(postings);
+		}
+		else
+		{
+			merged.clear();
+
+			std::set_intersection(matches.begin(), matches.end(), postings.begin(), postings.end(), std::back_inserter(merged));
+
+			matches.swap(merged);
+		}
+
+		if (matches.empty())
+		{
+			return;
+		}
+	}
+
+
+	// Newest first
+	for (size_t i = matches.size(); i > 0 && results.size() < limit; i--)
+	{
+		results.push_back(matches[i - 1]);
+	}
+}
@@ -0,0 +1,163 @@
+#ifndef CALLINDEX_H
+#define CALLINDEX_H
+
+/**
+ * -----------------------------------------------------
+ * File        callindex.h
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#pragma once
+
+
+// c++ libs
+#include <deque>
+#include <set>
+#include <string>
+#include <vector>
+
+// Project
+#include "callstore.h"
+
+
+// Reads encoded data
+class CodecReader;
+
+
+
+// Full text index over the calls of the history
+//
+// Server name, player names, reason and the 64bit SteamIDs of a call are
+// split into lower case words. Every word maps to the ascending numbers of
+// the history records it appears in, so adding the newest call only
+// appends. A query is split the same way and finds the calls holding all
+// of its words; the last word also matches as a prefix while it's typed.
+// A STEAM_X:Y:Z in the query is looked up as its 64bit SteamID.
+//
+// Words are found by hash. For prefixes they're also kept sorted, new
+// words are only sorted in once there are enough of them. Texts are
+// interned, so each distinct one is only split once.
+//
+// A call is handled in a later record of the history than its own, so the
+// index also knows which calls ended up handled, by callID and reportedAt.
+// It knows every call of the history by them as well, so a fetched call
+// the store already gave up isn't taken for a new one.
+class CallIndex
+{
+private:
+	typedef std::vector<unsigned int> Postings;
+
+	struct Term
+	{
+		std::string word;
+		unsigned int hash;
+
+		// Next term of the bucket
+		int next;
+
+		Postings postings;
+	};
+
+	// A deque, so new terms don't copy the postings of the old ones
+	std::deque<Term> terms;
+	std::vector<int> buckets;
+
+	// Terms of interned texts by handle, texts repeat across calls
+	struct TextTerms
+	{
+		unsigned int serial;
+		std::vector<int> terms;
+
+		TextTerms() : serial(0) {}
+	};
+
+	std::vector<TextTerms> texts;
+
+	// Orders terms by their word
+	class TermOrder;
+
+	// Terms by word, the ones from sorted on are new
+	mutable std::vector<int> order;
+	mutable size_t sorted;
+
+	// Calls added, last document
+	size_t count;
+	unsigned int last;
+
+	// Word being split
+	std::string word;
+
+	// Keys of all calls and of the handled ones
+	std::set<unsigned long long> known;
+	std::set<unsigned long long> handled;
+
+	static unsigned long long callKey(const CallRecord& record);
+
+	int find(const std::string& word) const;
+	int addTerm(const std::string& word, unsigned int document);
+	void addPosting(int term, unsigned int document);
+	void addText(const PooledString& text, unsigned int document);
+	void rehash();
+
+	// Documents of a word, all with it as prefix if wanted
+	void lookup(const std::string& word, bool prefix, Postings& result) const;
+
+	// Sort the new terms in
+	void sortTerms() const;
+
+public:
+	CallIndex();
+
+	// Index a call, documents have to be added in ascending order
+	void add(unsigned int document, const CallRecord& record);
+	void clear();
+
+	// A call was handled after it was added, false if it was known as handled
+	bool setHandled(const CallRecord& record);
+
+	// Was a call of the history handled, in its own record or later?
+	bool isHandled(const CallRecord& record) const {return record.handled || handled.count(callKey(record)) > 0;}
+
+	// Is a call in the history already?
+	bool isKnown(const CallRecord& record) const {return known.count(callKey(record)) > 0;}
+
+	size_t getCount() const {return count;}
+	size_t getTerms() const {return terms.size();}
+
+	// Words and their documents, so the index doesn't have to be built again
+	// Reading replaces the index, it's empty if the data is broken
+	void write(std::string& out) const;
+	bool read(CodecReader& reader);
+
+	// Documents matching the query, newest first, at most limit
+	void search(const std::string& query, std::vector<unsigned int>& results, size_t limit) const;
+
+	// Lower case words of a text
+	static void split(const std::string& text, std::vector<std::string>& words);
+};
+
+
+
+// Index of the call history
+extern CallIndex call_index;
+
+
+#endif
@@ -0,0 +1,310 @@
+/**
+ * -----------------------------------------------------
+ * File        calllist.cpp
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+// c++ libs
+#include <ctime>
+
+
+// Include Project
+#include "calllist.h"
+#include "call.h"
+
+
+
+// Create the list with its columns
+CallListCtrl::CallListCtrl(wxWindow* parent, wxWindowID id, const wxSize& size) : wxListCtrl(parent, id, wxDefaultPosition, size, wxLC_REPORT | wxLC_VIRTUAL | wxLC_SINGLE_SEL | wxLC_HRULES), view(CALL_VIEW_OLDEST), restoring(false), changingRow(-1)
+{
+	handledAttr.SetTextColour(wxColour(128, 128, 128));
+
+	InsertColumn(CALL_COLUMN_TIME, "Time", wxLIST_FORMAT_LEFT, 110);
+	InsertColumn(CALL_COLUMN_SERVER, "Server", wxLIST_FORMAT_LEFT, 110);
+	InsertColumn(CALL_COLUMN_TARGET, "Target", wxLIST_FORMAT_LEFT, 90);
+	InsertColumn(CALL_COLUMN_STATE, "State", wxLIST_FORMAT_LEFT, 70);
+
+	// Changes come from the store from now on
+	call_store.setListener(this);
+}
+
+
+// Stop listening
+CallListCtrl::~CallListCtrl()
+{
+	if (call_store.getListener() == this)
+	{
+		call_store.setListener(NULL);
+	}
+}
+
+
+
+// Show the rows of the view again
+void CallListCtrl::update()
+{
+	ListState before = getState();
+
+	if (before.selectedRow != -1)
+	{
+		selectRow(before.selectedRow, false);
+	}
+
+	long count = call_store.getViewCount(view);
+
+	SetItemCount(count);
+
+
+	if (count > 0)
+	{
+		// Keep the selected call selected
+		long row = call_store.getRow(view, before.selected);
+
+		if (row != -1)
+		{
+			selectRow(row, true);
+		}
+
+		// Newest calls in sight, like the old list
+		EnsureVisible((row != -1) ? row : ((getView() == CALL_VIEW_NEWEST) ? 0 : count - 1));
+	}
+
+	Refresh();
+}
+
+
+
+// Select a row again, not a choice of the user
+void CallListCtrl::selectRow(long row, bool selected)
+{
+	restoring = true;
+
+	SetItemState(row, selected ? wxLIST_STATE_SELECTED : 0, wxLIST_STATE_SELECTED);
+
+	restoring = false;
+}
+
+
+
+// Selection and scrolling before a change
+CallListCtrl::ListState CallListCtrl::getState() const
+{
+	ListState state;
+
+	state.selectedRow = GetNextItem(-1, wxLIST_NEXT_ALL, wxLIST_STATE_SELECTED);
+	state.selected = getCall(state.selectedRow);
+
+	state.top = GetTopItem();
+	state.atEnd = (state.top + GetCountPerPage() >= call_store.getViewCount(view));
+
+	return state;
+}
+
+
+
+// A call was added
+void CallListCtrl::onCallAdded(CallHandle handle)
+{
+	long row = call_store.getRow(view, handle);
+
+	if (row == -1)
+	{
+		return;
+	}
+
+	// The store has it already, the rows of the list are one behind from its row on
+	ListState before = getState();
+
+	if (before.selectedRow >= row)
+	{
+		before.selected = getCall(before.selectedRow + 1);
+	}
+
+	before.atEnd = (before.top + GetCountPerPage() >= call_store.getViewCount(view) - 1);
+
+	// At the very top new calls should be seen, otherwise the rows in sight stay
+	applyChange(row, (before.top > 0 && row <= before.top) ? 1 : 0, before);
+}
+
+
+// A call is about to be marked handled or removed
+void CallListCtrl::onCallChanging(CallHandle handle)
+{
+	changing = getState();
+	changingRow = call_store.getRow(view, handle);
+}
+
+
+// A call was marked handled
+void CallListCtrl::onCallChanged(CallHandle handle)
+{
+	const ListState& before = changing;
+
+	long removed = changingRow;
+	long added = call_store.getRow(view, handle);
+
+	if (removed == -1 && added == -1)
+	{
+		return;
+	}
+
+	// Stays where it was
+	if (removed == added)
+	{
+		RefreshItem(added);
+
+		return;
+	}
+
+	int shift = 0;
+
+	if (removed != -1 && removed < before.top)
+	{
+		shift--;
+	}
+
+	if (added != -1 && before.top > 0 && added <= before.top)
+	{
+		shift++;
+	}
+
+	applyChange((removed == -1 || (added != -1 && added < removed)) ? added : removed, shift, before);
+}
+
+
+// A call was removed
+void CallListCtrl::onCallRemoved(CallHandle)
+{
+	const ListState& before = changing;
+
+	long row = changingRow;
+
+	if (row != -1)
+	{
+		applyChange(row, (row < before.top) ? -1 : 0, before);
+	}
+}
+
+
+
+// Rows changed from a row on
+void CallListCtrl::applyChange(long from, int shift, const ListState& before)
+{
+	long count = call_store.getViewCount(view);
+
+	SetItemCount(count);
+
+	// Only the rows behind the change show something else
+	if (from < count)
+	{
+		RefreshItems(from, count - 1);
+	}
+
+
+	// The selection belongs to the call, not to the row
+	long selectedRow = call_store.getRow(view, before.selected);
+
+	if (selectedRow != before.selectedRow)
+	{
+		if (before.selectedRow != -1 && before.selectedRow < count)
+		{
+			selectRow(before.selectedRow, false);
+		}
+
+		if (selectedRow != -1)
+		{
+			selectRow(selectedRow, true);
+		}
+	}
+
+
+	// Rows came or went above the ones in sight, scroll by them
+	wxRect rect;
+
+	if (shift != 0 && count > 0 && GetItemRect(0, rect))
+	{
+		ScrollList(0, shift * rect.GetHeight());
+	}
+
+	// Following the end of the list, show a new last row
+	else if (before.atEnd && count > 0 && from == count - 1)
+	{
+		EnsureVisible(count - 1);
+	}
+}
+
+
+
+// Text of a cell, read when it's drawn
+wxString CallListCtrl::OnGetItemText(long item, long column) const
+{
+	const CallRecord* record = call_store.get(getCall(item));
+
+	// Given up since the last update
+	if (record == NULL)
+	{
+		return "";
+	}
+
+	switch (column)
+	{
+		case CALL_COLUMN_TIME:
+		{
+			char buffer[80];
+
+			time_t tt = (time_t)record->reportedAt;
+
+			struct tm* dt = localtime(&tt);
+
+			strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M", dt);
+
+			return buffer;
+		}
+
+		case CALL_COLUMN_SERVER:
+			return getDisplayString(record->serverName);
+
+		case CALL_COLUMN_TARGET:
+			return getDisplayString(record->targetName);
+
+		case CALL_COLUMN_STATE:
+			return record->handled ? "Handled" : "Unhandled";
+
+		default:
+			return "";
+	}
+}
+
+
+
+// Style of a row
+wxListItemAttr* CallListCtrl::OnGetItemAttr(long item) const
+{
+	const CallRecord* record = call_store.get(getCall(item));
+
+	if (record != NULL && record->handled)
+	{
+		return const_cast<wxListItemAttr*>(&handledAttr);
+	}
+
+	return NULL;
+}
@@ -0,0 +1,138 @@
+#ifndef CALLLIST_H
+#define CALLLIST_H
+
+/**
+ * -----------------------------------------------------
+ * File        calllist.h
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#pragma once
+
+
+// Precomp Header
+#include <wx/wxprec.h>
+
+// We need WX
+#ifndef WX_PRECOMP
+	#include <wx/wx.h>
+#endif
+
+#include <wx/listctrl.h>
+
+// Project
+#include "callstore.h"
+
+
+
+// Columns of the call list
+enum CALL_COLUMN
+{
+	CALL_COLUMN_TIME = 0,
+	CALL_COLUMN_SERVER,
+	CALL_COLUMN_TARGET,
+	CALL_COLUMN_STATE,
+
+	CALL_COLUMNS
+};
+
+
+
+// List of the calls of a view
+//
+// The list is virtual and keeps nothing but its view: the store keeps the
+// rows of every view in order, a row's call and text are read from it when
+// the row is drawn. So filling or switching the list costs nothing, no
+// matter how many calls it has, and nothing is converted for rows which
+// are never scrolled to.
+//
+// It listens to the store and only applies what changed: a row goes in or
+// out and the rows behind it are drawn again. The selected call stays
+// selected and the rows in sight stay where they are.
+class CallListCtrl : public wxListCtrl, public CallStoreListener
+{
+private:
+	// Order of the calls
+	CALL_VIEW view;
+
+	// Handled calls are greyed out
+	wxListItemAttr handledAttr;
+
+	// Selection and scrolling before a change
+	struct ListState
+	{
+		long selectedRow;
+		CallHandle selected;
+
+		long top;
+		bool atEnd;
+	};
+
+	ListState getState() const;
+
+	// The selection is being put back after a change
+	bool restoring;
+
+	// Row of the call that is changing and the list before, -1 if it wasn't listed
+	long changingRow;
+	ListState changing;
+
+	void selectRow(long row, bool selected);
+
+	// Rows changed from a row on, shift is the rows added minus the rows
+	// removed in front of the top row
+	void applyChange(long from, int shift, const ListState& before);
+
+protected:
+	virtual wxString OnGetItemText(long item, long column) const;
+	virtual wxListItemAttr* OnGetItemAttr(long item) const;
+
+public:
+	CallListCtrl(wxWindow* parent, wxWindowID id, const wxSize& size);
+	~CallListCtrl();
+
+	// Order of the calls
+	CALL_VIEW getView() const {return view;}
+	void setView(CALL_VIEW newView) {view = newView; update();}
+
+	// Show the rows of the view again
+	void update();
+
+	// Call of a row, INVALID_CALL if none
+	CallHandle getCall(long row) const {return call_store.getAt(view, row);}
+
+	// Selected call, INVALID_CALL if none
+	CallHandle getSelectedCall() const {return getCall(GetNextItem(-1, wxLIST_NEXT_ALL, wxLIST_STATE_SELECTED));}
+
+	// Selection events while this is true come from the list itself
+	bool isRestoring() const {return restoring;}
+
+
+	// Changes of the store
+	virtual void onCallAdded(CallHandle handle);
+	virtual void onCallChanging(CallHandle handle);
+	virtual void onCallChanged(CallHandle handle);
+	virtual void onCallRemoved(CallHandle handle);
+	virtual void onCallsReset() {update();}
+};
+
+
+#endif
@@ -0,0 +1,623 @@
+/**
+ * -----------------------------------------------------
+ * File        callstats.cpp
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+// c++ libs
+#include <stdio.h>
+#include <string.h>
+#include <ctime>
+#include <algorithm>
+
+// Project
+#include "callstats.h"
+#include "codec.h"
+
+
+
+// Statistics of the calls
+CallStats call_stats;
+
+
+
+// Seeds of the sketch rows
+static const unsigned long long sketchSeeds[STATS_SKETCH_DEPTH] = {0x9E3779B97F4A7C15ULL, 0xC2B2AE3D27D4EB4FULL, 0x165667B19E3779F9ULL, 0xD6E8FEB86659FD93ULL};
+
+
+// Column of a SteamID in a row of the sketch
+static unsigned int sketchColumn(unsigned long long steamid, int row)
+{
+	unsigned long long x = (steamid ^ sketchSeeds[row]) * 0xFF51AFD7ED558CCDULL;
+
+	x ^= x >> 33;
+
+	return (unsigned int)(x % STATS_SKETCH_WIDTH);
+}
+
+
+// Average in seconds
+static unsigned long long getAverage(const CallCounts& counts)
+{
+	return (counts.timed > 0) ? counts.handleTime / counts.timed : 0;
+}
+
+
+// Quote a CSV field
+static std::string quoteCSV(const std::string& text)
+{
+	std::string result = "\"";
+
+	for (size_t i=0; i < text.size(); i++)
+	{
+		if (text[i] == '"')
+		{
+			result += '"';
+		}
+
+		result += text[i];
+	}
+
+	return result + "\"";
+}
+
+
+
+// Count a handling time
+void CallCounts::addHandled(long seconds)
+{
+	timed++;
+	handleTime += (unsigned long long)seconds;
+
+	// Bucket by minutes, powers of two
+	long minutes = seconds / 60;
+	int bucket = 0;
+
+	while (bucket < STATS_TIME_BUCKETS - 1 && minutes >= (1L << bucket))
+	{
+		bucket++;
+	}
+
+	timeBuckets[bucket]++;
+}
+
+
+
+
+// Init. the statistics
+CallStats::CallStats()
+{
+	clear();
+}
+
+
+// Forget everything
+void CallStats::clear()
+{
+	total = CallCounts();
+
+	servers.clear();
+	reasons.clear();
+	names.clear();
+
+	memset(hours, 0, sizeof(hours));
+	memset(sketch, 0, sizeof(sketch));
+
+	top.clear();
+}
+
+
+
+// Counts of a name in a group
+CallCounts& CallStats::getCounts(std::vector<CallCounts>& group, const std::string& name)
+{
+	int known = names.getCount();
+
+	StringHandle handle = names.intern(name.empty() ? "-" : name.c_str());
+
+	// Each name keeps one reference as long as the statistics
+	if (names.getCount() == known)
+	{
+		names.release(handle);
+	}
+
+	if ((size_t)handle >= group.size())
+	{
+		group.resize(handle + 1);
+	}
+
+	return group[handle];
+}
+
+
+
+// A new call
+void CallStats::addCall(const CallRecord& record)
+{
+	CallCounts& server = getCounts(servers, record.serverName.str());
+	CallCounts& reason = getCounts(reasons, record.targetReason.str());
+
+	total.calls++;
+	server.calls++;
+	reason.calls++;
+
+	// Came in handled, so it's unknown when
+	if (record.handled)
+	{
+		total.handled++;
+		server.handled++;
+		reason.handled++;
+	}
+
+	time_t tt = (time_t)record.reportedAt;
+	struct tm* dt = localtime(&tt);
+
+	if (dt != NULL)
+	{
+		hours[dt->tm_hour]++;
+	}
+
+	addPlayer(record.targetID, record.targetName.str());
+}
+
+
+
+// A call was handled
+void CallStats::addHandled(const CallRecord& record, long handledAt)
+{
+	CallCounts& server = getCounts(servers, record.serverName.str());
+	CallCounts& reason = getCounts(reasons, record.targetReason.str());
+
+	total.handled++;
+	server.handled++;
+	reason.handled++;
+
+	if (handledAt > 0 && handledAt >= record.reportedAt)
+	{
+		long seconds = handledAt - record.reportedAt;
+
+		total.addHandled(seconds);
+		server.addHandled(seconds);
+		reason.addHandled(seconds);
+	}
+}
+
+
+
+// Count a report of a player
+void CallStats::addPlayer(unsigned long long steamid, const std::string& name)
+{
+	if (steamid == 0)
+	{
+		return;
+	}
+
+
+	// Conservative update: only the lowest counters grow
+	unsigned int estimate = 0xFFFFFFFF;
+
+	for (int row=0; row < STATS_SKETCH_DEPTH; row++)
+	{
+		unsigned int count = sketch[row][sketchColumn(steamid, row)];
+
+		if (count < estimate)
+		{
+			estimate = count;
+		}
+	}
+
+	estimate++;
+
+	for (int row=0; row < STATS_SKETCH_DEPTH; row++)
+	{
+		unsigned int& count = sketch[row][sketchColumn(steamid, row)];
+
+		if (count < estimate)
+		{
+			count = estimate;
+		}
+	}
+
+
+	// Already one of the top players?
+	for (size_t i=0; i < top.size(); i++)
+	{
+		if (top[i].steamID == steamid)
+		{
+			top[i].reports = estimate;
+			top[i].name = name;
+
+			return;
+		}
+	}
+
+	ReportedPlayer player;
+
+	player.steamID = steamid;
+	player.name = name;
+	player.reports = estimate;
+
+	if (top.size() < STATS_TOP_PLAYERS)
+	{
+		top.push_back(player);
+
+		return;
+	}
+
+
+	// Takes the place of the least reported one if it overtook it
+	size_t lowest = 0;
+
+	for (size_t i=1; i < top.size(); i++)
+	{
+		if (top[i].reports < top[lowest].reports)
+		{
+			lowest = i;
+		}
+	}
+
+	if (estimate > top[lowest].reports)
+	{
+		top[lowest] = player;
+	}
+}
+
+
+
+// Counters of a group
+static void writeCounts(std::string& out, const CallCounts& counts)
+{
+	writeVarint(out, counts.calls);
+	writeVarint(out, counts.handled);
+	writeVarint(out, counts.timed);
+	writeVarint(out, counts.handleTime);
+
+	for (int i=0; i < STATS_TIME_BUCKETS; i++)
+	{
+		writeVarint(out, counts.timeBuckets[i]);
+	}
+}
+
+static void readCounts(CodecReader& reader, CallCounts& counts)
+{
+	counts.calls = (unsigned int)reader.readVarint();
+	counts.handled = (unsigned int)reader.readVarint();
+	counts.timed = (unsigned int)reader.readVarint();
+	counts.handleTime = reader.readVarint();
+
+	for (int i=0; i < STATS_TIME_BUCKETS; i++)
+	{
+		counts.timeBuckets[i] = (unsigned int)reader.readVarint();
+	}
+}
+
+
+// Names of a group with their counters
+void CallStats::writeGroup(std::string& out, const std::vector<CallCounts>& group) const
+{
+	size_t used = 0;
+
+	for (size_t i=0; i < group.size(); i++)
+	{
+		used += (group[i].calls > 0 || group[i].handled > 0) ? 1 : 0;
+	}
+
+	writeVarint(out, used);
+
+	for (size_t i=0; i < group.size(); i++)
+	{
+		if (group[i].calls > 0 || group[i].handled > 0)
+		{
+			writeString(out, names.get((StringHandle)i));
+			writeCounts(out, group[i]);
+		}
+	}
+}
+
+void CallStats::readGroup(CodecReader& reader, std::vector<CallCounts>& group)
+{
+	size_t number = reader.readCount();
+
+	for (size_t i=0; i < number && !reader.hasFailed(); i++)
+	{
+		std::string name = reader.readString();
+
+		readCounts(reader, getCounts(group, name));
+	}
+}
+
+
+
+// All counters
+//
+//   counters of all calls
+//   varint  number of servers, then per server its name and counters
+//   varint  number of reasons, the same
+//   varint  calls per hour of the day, 24 of them
+//   varint  counters of the sketch, row by row
+//   varint  number of top players, then per player
+//     u64     64bit SteamID
+//     string  name
+//     varint  estimated reports
+//
+// Counters are calls, handled, timed, the handling time in seconds and
+// the buckets of the handling time, all varints.
+void CallStats::write(std::string& out) const
+{
+	writeCounts(out, total);
+	writeGroup(out, servers);
+	writeGroup(out, reasons);
+
+	for (int i=0; i < 24; i++)
+	{
+		writeVarint(out, hours[i]);
+	}
+
+	for (int row=0; row < STATS_SKETCH_DEPTH; row++)
+	{
+		for (int column=0; column < STATS_SKETCH_WIDTH; column++)
+		{
+			writeVarint(out, sketch[row][column]);
+		}
+	}
+
+	writeVarint(out, top.size());
+
+	for (size_t i=0; i < top.size(); i++)
+	{
+		writeLittle(out, top[i].steamID, 8);
+		writeString(out, top[i].name);
+		writeVarint(out, top[i].reports);
+	}
+}
+
+
+// Read what write() wrote
+bool CallStats::read(CodecReader& reader)
+{
+	clear();
+
+	readCounts(reader, total);
+	readGroup(reader, servers);
+	readGroup(reader, reasons);
+
+	for (int i=0; i < 24; i++)
+	{
+		hours[i] = (unsigned int)reader.readVarint();
+	}
+
+	for (int row=0; row < STATS_SKETCH_DEPTH; row++)
+	{
+		for (int column=0; column < STATS_SKETCH_WIDTH; column++)
+		{
+			sketch[row][column] = (unsigned int)reader.readVarint();
+		}
+	}
+
+	size_t number = reader.readCount();
+
+	for (size_t i=0; i < number && i < STATS_TOP_PLAYERS && !reader.hasFailed(); i++)
+	{
+		ReportedPlayer player;
+
+		player.steamID = reader.readU64();
+		player.name = reader.readString();
+		player.reports = (unsigned int)reader.readVarint();
+
+		top.push_back(player);
+	}
+
+	if (reader.hasFailed() || number > STATS_TOP_PLAYERS)
+	{
+		clear();
+
+		return false;
+	}
+
+	return true;
+}
+
+
+
+// Orders names by their calls
+class CountOrder
+{
+private:
+	const std::vector<CallCounts>& group;
+
+public:
+	CountOrder(const std::vector<CallCounts>& counts) : group(counts) {}
+
+	bool operator()(int x, int y) const {return group[x].calls > group[y].calls;}
+};
+
+
+// Names of a group with calls, most calls first
+static std::vector<int> getSorted(const std::vector<CallCounts>& group)
+{
+	std::vector<int> result;
+
+	for (size_t i=0; i < group.size(); i++)
+	{
+		if (group[i].calls > 0 || group[i].handled > 0)
+		{
+			result.push_back((int)i);
+		}
+	}
+
+	std::stable_sort(result.begin(), result.end(), CountOrder(group));
+
+	return result;
+}
+
+
+// Label of a bucket of the handling time
+static std::string getBucketName(int bucket)
+{
+	char buffer[32];
+
+	if (bucket == STATS_TIME_BUCKETS - 1)
+	{
+		sprintf(buffer, ">= %ld min", 1L << (bucket - 1));
+	}
+	else
+	{
+		sprintf(buffer, "< %ld min", 1L << bucket);
+	}
+
+	return buffer;
+}
+
+
+// Orders players by their reports
+static bool moreReports(const ReportedPlayer& x, const ReportedPlayer& y)
+{
+	return x.reports > y.reports;
+}
+
+
+// Player with SteamID
+static std::string getPlayerName(const ReportedPlayer& player)
+{
+	char steamid[32];
+
+	formatSteamID(player.steamID, steamid, sizeof(steamid));
+
+	return player.name + " (" + steamid + ")";
+}
+
+
+
+// Readable report
+std::string CallStats::getReport() const
+{
+	char buffer[256];
+	std::string report;
+
+	sprintf(buffer, "Calls: %u, handled: %u, average handling time: %llu min (of %u)\n", total.calls, total.handled, getAverage(total) / 60, total.timed);
+	report += buffer;
+
+
+	report += "\nCalls by hour of the day:\n";
+
+	for (int i=0; i < 24; i++)
+	{
+		sprintf(buffer, "  %02d:00  %u\n", i, hours[i]);
+		report += buffer;
+	}
+
+
+	report += "\nHandling time:\n";
+
+	for (int i=0; i < STATS_TIME_BUCKETS; i++)
+	{
+		sprintf(buffer, "  %-12s  %u\n", getBucketName(i).c_str(), total.timeBuckets[i]);
+		report += buffer;
+	}
+
+
+	// Servers and reasons
+	const std::vector<CallCounts>* groups[] = {&servers, &reasons};
+	const char* titles[] = {"\nServers (calls, handled, average minutes):\n", "\nReasons (calls, handled, average minutes):\n"};
+
+	for (int g=0; g < 2; g++)
+	{
+		report += titles[g];
+
+		std::vector<int> sorted = getSorted(*groups[g]);
+
+		for (size_t i=0; i < sorted.size(); i++)
+		{
+			const CallCounts& counts = (*groups[g])[sorted[i]];
+
+			sprintf(buffer, "%u, %u, %llu", counts.calls, counts.handled, getAverage(counts) / 60);
+			report += "  " + names.get(sorted[i]) + ": " + buffer + "\n";
+		}
+	}
+
+
+	report += "\nMost reported players (estimated reports):\n";
+
+	std::vector<ReportedPlayer> players = top;
+
+	std::stable_sort(players.begin(), players.end(), moreReports);
+
+	for (size_t i=0; i < players.size(); i++)
+	{
+		sprintf(buffer, ": %u\n", players[i].reports);
+		report += "  " + getPlayerName(players[i]) + buffer;
+	}
+
+	return report;
+}
+
+
+
+// Everything as CSV
+std::string CallStats::getCSV() const
+{
+	char buffer[128];
+	std::string csv = "section,name,calls,handled,timed,average_seconds\n";
+
+	sprintf(buffer, "total,,%u,%u,%u,%llu\n", total.calls, total.handled, total.timed, getAverage(total));
+	csv += buffer;
+
+	for (int i=0; i < 24; i++)
+	{
+		sprintf(buffer, "hour,%02d,%u,,,\n", i, hours[i]);
+		csv += buffer;
+	}
+
+	for (int i=0; i < STATS_TIME_BUCKETS; i++)
+	{
+		sprintf(buffer, ",%u,,,\n", total.timeBuckets[i]);
+		csv += "handling_time," + quoteCSV(getBucketName(i)) + buffer;
+	}
+
+	const std::vector<CallCounts>* groups[] = {&servers, &reasons};
+	const char* sections[] = {"server,", "reason,"};
+
+	for (int g=0; g < 2; g++)
+	{
+		std::vector<int> sorted = getSorted(*groups[g]);
+
+		for (size_t i=0; i < sorted.size(); i++)
+		{
+			const CallCounts& counts = (*groups[g])[sorted[i]];
+
+			sprintf(buffer, ",%u,%u,%u,%llu\n", counts.calls, counts.handled, counts.timed, getAverage(counts));
+			csv += sections[g] + quoteCSV(names.get(sorted[i])) + buffer;
+		}
+	}
+
+	std::vector<ReportedPlayer> players = top;
+
+	std::stable_sort(players.begin(), players.end(), moreReports);
+
+	for (size_t i=0; i < players.size(); i++)
+	{
+		sprintf(buffer, ",%u,,,\n", players[i].reports);
+		csv += "player," + quoteCSV(getPlayerName(players[i])) + buffer;
+	}
+
+	return csv;
+}
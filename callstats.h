@@ -0,0 +1,152 @@
+#ifndef CALLSTATS_H
+#define CALLSTATS_H
+
+/**
+ * -----------------------------------------------------
+ * File        callstats.h
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#pragma once
+
+
+// c++ libs
+#include <string>
+#include <vector>
+
+// Project
+#include "callstore.h"
+
+
+// Reads encoded data
+class CodecReader;
+
+
+
+// Buckets of the handling time, bucket i holds up to 2^i minutes
+#define STATS_TIME_BUCKETS 12
+
+// Count-min sketch of the reported players
+#define STATS_SKETCH_DEPTH 4
+#define STATS_SKETCH_WIDTH 2048
+
+// Most reported players kept
+#define STATS_TOP_PLAYERS 10
+
+
+
+// Counts of a group of calls
+struct CallCounts
+{
+	unsigned int calls;
+	unsigned int handled;
+
+	// Calls whose handling was seen, and their time
+	unsigned int timed;
+	unsigned long long handleTime;
+	unsigned int timeBuckets[STATS_TIME_BUCKETS];
+
+	CallCounts() : calls(0), handled(0), timed(0), handleTime(0) {for (int i=0; i < STATS_TIME_BUCKETS; i++) timeBuckets[i] = 0;}
+
+	void addHandled(long seconds);
+};
+
+
+// A player reported often
+struct ReportedPlayer
+{
+	unsigned long long steamID;
+	std::string name;
+
+	// Estimate of the sketch, never too low
+	unsigned int reports;
+
+	ReportedPlayer() : steamID(0), reports(0) {}
+};
+
+
+
+// Statistics of the calls
+//
+// Every call and handling is added once as it comes in, so nothing is
+// ever rescanned: a few counters per server and per reason, calls per hour
+// of the day and a histogram of the handling time. The most reported
+// players are estimated with a count-min sketch, only the top ones are
+// kept with their names.
+class CallStats
+{
+private:
+	CallCounts total;
+
+	// By name, the pool gives the names dense handles
+	StringPool names;
+	std::vector<CallCounts> servers;
+	std::vector<CallCounts> reasons;
+
+	// Calls by hour of the day, local time
+	unsigned int hours[24];
+
+	unsigned int sketch[STATS_SKETCH_DEPTH][STATS_SKETCH_WIDTH];
+	std::vector<ReportedPlayer> top;
+
+	CallCounts& getCounts(std::vector<CallCounts>& group, const std::string& name);
+	void addPlayer(unsigned long long steamid, const std::string& name);
+
+	void writeGroup(std::string& out, const std::vector<CallCounts>& group) const;
+	void readGroup(CodecReader& reader, std::vector<CallCounts>& group);
+
+	// No copies
+	CallStats(const CallStats&);
+	CallStats& operator=(const CallStats&);
+
+public:
+	CallStats();
+
+	// A new call
+	void addCall(const CallRecord& record);
+
+	// A call was handled, handledAt is 0 if it's unknown when
+	void addHandled(const CallRecord& record, long handledAt);
+
+	void clear();
+
+	// All counters, so the statistics don't have to be counted again
+	// Reading replaces them, they're cleared if the data is broken
+	void write(std::string& out) const;
+	bool read(CodecReader& reader);
+
+	const CallCounts& getTotal() const {return total;}
+	const std::vector<ReportedPlayer>& getTopPlayers() const {return top;}
+
+	// Readable report
+	std::string getReport() const;
+
+	// Everything as CSV: section, name, calls, handled, timed, average seconds
+	std::string getCSV() const;
+};
+
+
+
+// Statistics of the calls
+extern CallStats call_stats;
+
+
+#endif
@@ -0,0 +1,851 @@
+/**
+ * -----------------------------------------------------
+ * File        callstore.cpp
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+// Project
+#include "callstore.h"
+#include "codec.h"
+
+
+
+// Strings of the calls, before the store so it outlives it
+StringPool call_strings;
+
+// Calls
+CallStore call_store;
+
+
+// Markers of the index
+#define INDEX_EMPTY -1
+#define INDEX_DELETED -2
+
+
+
+
+// Init. the store
+CallStore::CallStore()
+{
+	count = 0;
+	firstFree = -1;
+
+	memory = 0;
+	budget = CALL_MEMORY_DEFAULT * 1024 * 1024;
+
+	indexUsed = 0;
+
+	listener = NULL;
+	updating = 0;
+	changed = false;
+
+	for (int i=0; i < ORDERS; i++)
+	{
+		roots[i] = -1;
+	}
+
+	nextSerial = 0;
+	random = 2463534242U;
+
+	rehash();
+}
+
+
+// Delete everything
+CallStore::~CallStore()
+{
+	// Nobody to tell anymore
+	listener = NULL;
+
+	clear();
+}
+
+
+
+// Should the listener be told about a change now?
+bool CallStore::notify()
+{
+	if (updating > 0)
+	{
+		changed = true;
+
+		return false;
+	}
+
+	return listener != NULL;
+}
+
+
+// End of bulk changes
+void CallStore::endUpdate()
+{
+	if (updating > 0 && --updating == 0 && changed)
+	{
+		changed = false;
+
+		if (listener != NULL)
+		{
+			listener->onCallsReset();
+		}
+	}
+}
+
+
+
+// Place of a handle, -1 if the call is gone
+int CallStore::toPlace(CallHandle handle) const
+{
+	if (handle < 0)
+	{
+		return -1;
+	}
+
+	int place = (int)(handle & CALL_PLACE_MASK);
+
+	if (place >= (int)places.size() || places[place].record == NULL || places[place].generation != (unsigned int)(handle >> CALL_PLACE_BITS))
+	{
+		return -1;
+	}
+
+	return place;
+}
+
+
+
+// Record of a call
+CallRecord* CallStore::get(CallHandle handle) const
+{
+	int place = toPlace(handle);
+
+	return (place != -1) ? places[place].record : NULL;
+}
+
+
+// Next younger call
+CallHandle CallStore::getNext(CallHandle handle) const
+{
+	int place = toPlace(handle);
+
+	return (place != -1) ? toHandle(places[place].next[LINK_AGE]) : INVALID_CALL;
+}
+
+
+
+// Rows of a view
+int CallStore::getViewCount(CALL_VIEW view) const
+{
+	return (view == CALL_VIEW_UNHANDLED) ? sizeOf(ORDER_UNHANDLED, roots[ORDER_UNHANDLED]) : count;
+}
+
+
+// Call of a row of a view
+CallHandle CallStore::getAt(CALL_VIEW view, long row) const
+{
+	if (row < 0 || row >= getViewCount(view))
+	{
+		return INVALID_CALL;
+	}
+
+	int rank = (int)row;
+
+	switch (view)
+	{
+		case CALL_VIEW_NEWEST:
+			return toHandle(placeAt(ORDER_TIME, count - 1 - rank));
+
+		case CALL_VIEW_UNHANDLED:
+			return toHandle(placeAt(ORDER_UNHANDLED, rank));
+
+		case CALL_VIEW_UNHANDLED_FIRST:
+		{
+			// After the last unhandled one the handled ones follow
+			int unhandledCount = sizeOf(ORDER_UNHANDLED, roots[ORDER_UNHANDLED]);
+
+			return toHandle((rank < unhandledCount) ? placeAt(ORDER_UNHANDLED, rank) : placeAt(ORDER_HANDLED, rank - unhandledCount));
+		}
+
+		case CALL_VIEW_SERVER:
+			return toHandle(placeAt(ORDER_SERVER, rank));
+
+		case CALL_VIEW_TARGET:
+			return toHandle(placeAt(ORDER_TARGET, rank));
+
+		default:
+			return toHandle(placeAt(ORDER_TIME, rank));
+	}
+}
+
+
+// Row of a call in a view
+long CallStore::getRow(CALL_VIEW view, CallHandle handle) const
+{
+	int place = toPlace(handle);
+
+	if (place == -1)
+	{
+		return -1;
+	}
+
+	bool isHandled = places[place].record->handled;
+
+	switch (view)
+	{
+		case CALL_VIEW_NEWEST:
+			return count - 1 - rankOf(ORDER_TIME, place);
+
+		case CALL_VIEW_UNHANDLED:
+			return isHandled ? -1 : rankOf(ORDER_UNHANDLED, place);
+
+		case CALL_VIEW_UNHANDLED_FIRST:
+			return isHandled ? sizeOf(ORDER_UNHANDLED, roots[ORDER_UNHANDLED]) + rankOf(ORDER_HANDLED, place) : rankOf(ORDER_UNHANDLED, place);
+
+		case CALL_VIEW_SERVER:
+			return rankOf(ORDER_SERVER, place);
+
+		case CALL_VIEW_TARGET:
+			return rankOf(ORDER_TARGET, place);
+
+		default:
+			return rankOf(ORDER_TIME, place);
+	}
+}
+
+
+
+// Same call
+CallHandle CallStore::find(const CallRecord& record) const
+{
+	size_t mask = index.size() - 1;
+
+	for (size_t i = hash(record) & mask; index[i] != INDEX_EMPTY; i = (i + 1) & mask)
+	{
+		int place = index[i];
+
+		if (place != INDEX_DELETED && *places[place].record == record)
+		{
+			return toHandle(place);
+		}
+	}
+
+	return INVALID_CALL;
+}
+
+
+
+// Add a new call
+CallHandle CallStore::add(CallRecord* record)
+{
+	int place = firstFree;
+
+	// Need a new place
+	if (place == -1)
+	{
+		if (places.size() > (size_t)CALL_PLACE_MASK)
+		{
+			delete record;
+
+			return INVALID_CALL;
+		}
+
+		Place empty;
+
+		empty.record = NULL;
+		empty.generation = 0;
+		empty.serial = 0;
+		empty.priority = 0;
+
+		for (int i=0; i < LINKS; i++)
+		{
+			empty.prev[i] = empty.next[i] = -1;
+		}
+
+		place = (int)places.size();
+
+		places.push_back(empty);
+	}
+	else
+	{
+		firstFree = places[place].next[LINK_AGE];
+	}
+
+	places[place].record = record;
+	places[place].serial = nextSerial++;
+
+	// Xorshift, the shape of the trees only has to be random
+	random ^= random << 13;
+	random ^= random >> 17;
+	random ^= random << 5;
+
+	places[place].priority = random;
+
+	count++;
+	memory += getSize(*record);
+
+	link(all, LINK_AGE, place);
+	link(record->handled ? handled : unhandled, LINK_STATE, place);
+
+	treeInsert(ORDER_TIME, place);
+	treeInsert(record->handled ? ORDER_HANDLED : ORDER_UNHANDLED, place);
+	treeInsert(ORDER_SERVER, place);
+	treeInsert(ORDER_TARGET, place);
+
+	indexInsert(place);
+
+	if (notify())
+	{
+		listener->onCallAdded(toHandle(place));
+	}
+
+	return toHandle(place);
+}
+
+
+
+// Mark a call handled
+void CallStore::setHandled(CallHandle handle)
+{
+	int place = toPlace(handle);
+
+	if (place != -1 && !places[place].record->handled)
+	{
+		bool tell = notify();
+
+		if (tell)
+		{
+			listener->onCallChanging(handle);
+		}
+
+		// Now it's the youngest handled one
+		unlink(unhandled, LINK_STATE, place);
+		link(handled, LINK_STATE, place);
+
+		treeErase(ORDER_UNHANDLED, place);
+
+		places[place].record->handled = true;
+
+		treeInsert(ORDER_HANDLED, place);
+
+		if (tell)
+		{
+			listener->onCallChanged(handle);
+		}
+	}
+}
+
+
+
+// Delete a record
+void CallStore::remove(CallHandle handle)
+{
+	int place = toPlace(handle);
+
+	if (place == -1)
+	{
+		return;
+	}
+
+	bool tell = notify();
+
+	if (tell)
+	{
+		listener->onCallChanging(handle);
+	}
+
+	CallRecord* record = places[place].record;
+
+	indexErase(place);
+
+	unlink(all, LINK_AGE, place);
+	unlink(record->handled ? handled : unhandled, LINK_STATE, place);
+
+	treeErase(ORDER_TIME, place);
+	treeErase(record->handled ? ORDER_HANDLED : ORDER_UNHANDLED, place);
+	treeErase(ORDER_SERVER, place);
+	treeErase(ORDER_TARGET, place);
+
+	count--;
+	memory -= getSize(*record);
+
+	delete record;
+
+	// Old handles of this place are invalid now
+	places[place].record = NULL;
+	places[place].generation = (places[place].generation + 1) & CALL_GENERATION_MASK;
+
+	// Free again
+	places[place].next[LINK_AGE] = firstFree;
+	firstFree = place;
+
+	if (tell)
+	{
+		listener->onCallRemoved(handle);
+	}
+}
+
+
+// Delete all records
+void CallStore::clear()
+{
+	beginUpdate();
+
+	while (all.first != -1)
+	{
+		remove(toHandle(all.first));
+	}
+
+	endUpdate();
+}
+
+
+
+// Memory a record takes in the store
+size_t CallStore::getSize(const CallRecord& record)
+{
+	// The place with its nodes and the index entries around it
+	size_t size = sizeof(CallRecord) + sizeof(Place) + 2 * sizeof(int);
+
+	// Interned strings are counted by the pool
+	size += record.callID.capacity() + record.fullIP.capacity();
+
+	return size;
+}
+
+
+
+// Append a place to a list
+void CallStore::link(CallList& list, int type, int place)
+{
+	places[place].prev[type] = list.last;
+	places[place].next[type] = -1;
+
+	if (list.last != -1)
+	{
+		places[list.last].next[type] = place;
+	}
+	else
+	{
+		list.first = place;
+	}
+
+	list.last = place;
+}
+
+
+// Take a place out of a list
+void CallStore::unlink(CallList& list, int type, int place)
+{
+	int prev = places[place].prev[type];
+	int next = places[place].next[type];
+
+	if (prev != -1)
+	{
+		places[prev].next[type] = next;
+	}
+	else
+	{
+		list.first = next;
+	}
+
+	if (next != -1)
+	{
+		places[next].prev[type] = prev;
+	}
+	else
+	{
+		list.last = prev;
+	}
+
+	places[place].prev[type] = places[place].next[type] = -1;
+}
+
+
+
+
+// Hash of callID and reportedAt, FNV-1a
+size_t CallStore::hash(const CallRecord& record)
+{
+	char time[4];
+	unsigned long reportedAt = (unsigned long)record.reportedAt;
+
+	for (int i=0; i < 4; i++, reportedAt >>= 8)
+	{
+		time[i] = (char)(reportedAt & 0xFF);
+	}
+
+	return fnv1a(time, sizeof(time), fnv1a(record.callID));
+}
+
+
+
+// Add a place to the index
+void CallStore::indexInsert(int place)
+{
+	// Keep it at most half full, the new index has this record already
+	if ((indexUsed + 1) * 2 > index.size())
+	{
+		rehash();
+
+		return;
+	}
+
+	size_t mask = index.size() - 1;
+	size_t i = hash(*places[place].record) & mask;
+
+	// Reuse deleted entries
+	while (index[i] != INDEX_EMPTY && index[i] != INDEX_DELETED)
+	{
+		i = (i + 1) & mask;
+	}
+
+	if (index[i] == INDEX_EMPTY)
+	{
+		indexUsed++;
+	}
+
+	index[i] = place;
+}
+
+
+
+// Remove a place from the index
+void CallStore::indexErase(int place)
+{
+	size_t mask = index.size() - 1;
+
+	for (size_t i = hash(*places[place].record) & mask; index[i] != INDEX_EMPTY; i = (i + 1) & mask)
+	{
+		if (index[i] == place)
+		{
+			index[i] = INDEX_DELETED;
+
+			return;
+		}
+	}
+}
+
+
+
+// Build the index again, drops deleted entries
+void CallStore::rehash()
+{
+	size_t capacity = 16;
+
+	// A quarter full, so it takes a while until the next one
+	while (capacity < (size_t)count * 4)
+	{
+		capacity *= 2;
+	}
+
+	index.assign(capacity, INDEX_EMPTY);
+	indexUsed = 0;
+
+	size_t mask = capacity - 1;
+
+	for (int place = all.first; place != -1; place = places[place].next[LINK_AGE])
+	{
+		size_t i = hash(*places[place].record) & mask;
+
+		while (index[i] != INDEX_EMPTY)
+		{
+			i = (i + 1) & mask;
+		}
+
+		index[i] = place;
+		indexUsed++;
+	}
+}
+
+
+
+// Compare names, ignoring the case of ASCII letters
+static int compareNames(const std::string& x, const std::string& y)
+{
+	size_t length = (x.size() < y.size()) ? x.size() : y.size();
+
+	for (size_t i=0; i < length; i++)
+	{
+		unsigned char a = (unsigned char)x[i];
+		unsigned char b = (unsigned char)y[i];
+
+		if (a >= 'A' && a <= 'Z') a += 'a' - 'A';
+		if (b >= 'A' && b <= 'Z') b += 'a' - 'A';
+
+		if (a != b)
+		{
+			return (a < b) ? -1 : 1;
+		}
+	}
+
+	return (x.size() == y.size()) ? 0 : ((x.size() < y.size()) ? -1 : 1);
+}
+
+
+// Node of the place used by a tree
+int CallStore::nodeOf(int order)
+{
+	switch (order)
+	{
+		case ORDER_UNHANDLED:
+		case ORDER_HANDLED:
+			return NODE_STATE;
+
+		case ORDER_SERVER:
+			return NODE_SERVER;
+
+		case ORDER_TARGET:
+			return NODE_TARGET;
+
+		default:
+			return NODE_TIME;
+	}
+}
+
+
+// Order of two places in a tree: by name for the sorted ones, then by time, then by arrival
+bool CallStore::before(int order, int x, int y) const
+{
+	const CallRecord& first = *places[x].record;
+	const CallRecord& second = *places[y].record;
+
+	if (order == ORDER_SERVER || order == ORDER_TARGET)
+	{
+		const PooledString& a = (order == ORDER_SERVER) ? first.serverName : first.targetName;
+		const PooledString& b = (order == ORDER_SERVER) ? second.serverName : second.targetName;
+
+		// Interned, so the same name has the same handle
+		if (a.getHandle() != b.getHandle())
+		{
+			int result = compareNames(a.str(), b.str());
+
+			if (result != 0)
+			{
+				return result < 0;
+			}
+		}
+	}
+
+	if (first.reportedAt != second.reportedAt)
+	{
+		return first.reportedAt < second.reportedAt;
+	}
+
+	if (places[x].serial != places[y].serial)
+	{
+		return places[x].serial < places[y].serial;
+	}
+
+	return x < y;
+}
+
+
+
+// Add a place to a tree: as a leaf, then up until its parent has a higher priority
+void CallStore::treeInsert(int order, int place)
+{
+	int type = nodeOf(order);
+	CallNode& node = places[place].node[type];
+
+	node.left = node.right = -1;
+	node.size = 1;
+
+	int parent = -1;
+	bool left = false;
+
+	for (int current = roots[order]; current != -1; current = left ? places[current].node[type].left : places[current].node[type].right)
+	{
+		places[current].node[type].size++;
+
+		parent = current;
+		left = before(order, place, current);
+	}
+
+	node.parent = parent;
+
+	if (parent == -1)
+	{
+		roots[order] = place;
+	}
+	else if (left)
+	{
+		places[parent].node[type].left = place;
+	}
+	else
+	{
+		places[parent].node[type].right = place;
+	}
+
+	while (node.parent != -1 && places[node.parent].priority < places[place].priority)
+	{
+		rotateUp(order, place);
+	}
+}
+
+
+// Take a place out of a tree: down until it's a leaf, then off
+void CallStore::treeErase(int order, int place)
+{
+	int type = nodeOf(order);
+	CallNode& node = places[place].node[type];
+
+	while (node.left != -1 || node.right != -1)
+	{
+		int child;
+
+		if (node.left == -1 || (node.right != -1 && places[node.right].priority > places[node.left].priority))
+		{
+			child = node.right;
+		}
+		else
+		{
+			child = node.left;
+		}
+
+		rotateUp(order, child);
+	}
+
+	int parent = node.parent;
+
+	if (parent == -1)
+	{
+		roots[order] = -1;
+	}
+	else if (places[parent].node[type].left == place)
+	{
+		places[parent].node[type].left = -1;
+	}
+	else
+	{
+		places[parent].node[type].right = -1;
+	}
+
+	for (int current = parent; current != -1; current = places[current].node[type].parent)
+	{
+		places[current].node[type].size--;
+	}
+
+	node.parent = -1;
+	node.size = 0;
+}
+
+
+// Put a place above its parent, the order stays the same
+void CallStore::rotateUp(int order, int place)
+{
+	int type = nodeOf(order);
+
+	CallNode& node = places[place].node[type];
+
+	int parent = node.parent;
+	CallNode& above = places[parent].node[type];
+
+	int grandparent = above.parent;
+
+	if (above.left == place)
+	{
+		above.left = node.right;
+
+		if (node.right != -1)
+		{
+			places[node.right].node[type].parent = parent;
+		}
+
+		node.right = parent;
+	}
+	else
+	{
+		above.right = node.left;
+
+		if (node.left != -1)
+		{
+			places[node.left].node[type].parent = parent;
+		}
+
+		node.left = parent;
+	}
+
+	above.parent = place;
+	node.parent = grandparent;
+
+	if (grandparent == -1)
+	{
+		roots[order] = place;
+	}
+	else if (places[grandparent].node[type].left == parent)
+	{
+		places[grandparent].node[type].left = place;
+	}
+	else
+	{
+		places[grandparent].node[type].right = place;
+	}
+
+	above.size = 1 + sizeOf(order, above.left) + sizeOf(order, above.right);
+	node.size = 1 + sizeOf(order, node.left) + sizeOf(order, node.right);
+}
+
+
+
+// Position of a place in a tree: what's left of it on the way up
+int CallStore::rankOf(int order, int place) const
+{
+	int type = nodeOf(order);
+	int rank = sizeOf(order, places[place].node[type].left);
+
+	for (int current = place, parent = places[place].node[type].parent; parent != -1; current = parent, parent = places[parent].node[type].parent)
+	{
+		if (places[parent].node[type].right == current)
+		{
+			rank += sizeOf(order, places[parent].node[type].left) + 1;
+		}
+	}
+
+	return rank;
+}
+
+
+// Place at a position of a tree
+int CallStore::placeAt(int order, int rank) const
+{
+	int type = nodeOf(order);
+	int current = roots[order];
+
+	while (current != -1)
+	{
+		int left = sizeOf(order, places[current].node[type].left);
+
+		if (rank < left)
+		{
+			current = places[current].node[type].left;
+		}
+		else if (rank == left)
+		{
+			return current;
+		}
+		else
+		{
+			rank -= left + 1;
+			current = places[current].node[type].right;
+		}
+	}
+
+	return -1;
+}
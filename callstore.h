@@ -0,0 +1,380 @@
+#ifndef CALLSTORE_H
+#define CALLSTORE_H
+
+/**
+ * -----------------------------------------------------
+ * File        callstore.h
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#pragma once
+
+
+// c++ libs
+#include <string>
+#include <vector>
+
+// Project
+#include "api.h"
+#include "stringpool.h"
+
+
+
+// Default memory for the calls, in MB
+#define CALL_MEMORY_DEFAULT 16
+
+
+// Handle of a call: its place in the low bits, a generation above that
+// tells whether the place still holds the same call
+// 64bit, so a place is reused 2^32 times before an old handle can match again
+typedef long long CallHandle;
+
+#define INVALID_CALL -1
+#define CALL_PLACE_BITS 31
+#define CALL_PLACE_MASK 0x7FFFFFFFLL
+#define CALL_GENERATION_MASK 0xFFFFFFFFU
+
+
+
+// Dialog showing a call
+class CallDialog;
+
+
+// Interned strings of the calls
+extern StringPool call_strings;
+
+
+
+// A call, everything the client keeps about it
+//
+// The dialog is only created when the call is opened, so a call the admin
+// never looks at costs no more than this struct.
+struct CallRecord
+{
+	std::string callID;
+	std::string fullIP;
+
+	// Repeat across calls, so they're interned
+	PooledString serverName;
+	PooledString targetName;
+	PooledString targetReason;
+	PooledString clientName;
+
+	// 64bit SteamIDs
+	unsigned long long targetID;
+	unsigned long long clientID;
+
+	// Unix time
+	long reportedAt;
+
+	bool handled;
+
+	// Open dialog, NULL if none
+	CallDialog* dialog;
+
+
+	CallRecord() : serverName(call_strings), targetName(call_strings), targetReason(call_strings), clientName(call_strings), targetID(0), clientID(0), reportedAt(0), handled(false), dialog(NULL) {}
+
+	CallRecord(const ApiCall& call) : callID(call.callID), fullIP(call.fullIP), serverName(call_strings, call.serverName), targetName(call_strings, call.targetName), targetReason(call_strings, call.targetReason), clientName(call_strings, call.clientName),
+	                                  targetID(call.targetID), clientID(call.clientID), reportedAt(call.reportedAt), handled(call.handled), dialog(NULL) {}
+
+
+	// Same call? callID and reportedAt never change once stored
+	friend bool operator==(const CallRecord& x, const CallRecord& y) {return (x.reportedAt == y.reportedAt && x.callID == y.callID);}
+	friend bool operator!=(const CallRecord& x, const CallRecord& y) {return !(x == y);}
+};
+
+
+
+// Orders in which the calls can be listed
+enum CALL_VIEW
+{
+	// By the time they were reported
+	CALL_VIEW_OLDEST = 0,
+	CALL_VIEW_NEWEST,
+
+	// Only unhandled ones, oldest first
+	CALL_VIEW_UNHANDLED,
+
+	// Unhandled ones first, each oldest first
+	CALL_VIEW_UNHANDLED_FIRST,
+
+	// By name, then by time
+	CALL_VIEW_SERVER,
+	CALL_VIEW_TARGET,
+
+	CALL_VIEWS
+};
+
+
+
+// Told about the changes of a store, so views of it only redraw what moved
+class CallStoreListener
+{
+public:
+	virtual ~CallStoreListener() {}
+
+	// A call was added, it's already in place in the views
+	virtual void onCallAdded(CallHandle handle) = 0;
+
+	// A call is about to be marked handled or removed, it's still where it was
+	virtual void onCallChanging(CallHandle handle) = 0;
+
+	// A call was marked handled, it's in its new place in the views
+	virtual void onCallChanged(CallHandle handle) = 0;
+
+	// A call was removed, the handle finds nothing anymore
+	virtual void onCallRemoved(CallHandle handle) = 0;
+
+	// Many calls changed at once, everything has to be read again
+	virtual void onCallsReset() = 0;
+};
+
+
+
+// Doubly linked list through the places of the store
+struct CallList
+{
+	int first;
+	int last;
+
+	CallList() : first(-1), last(-1) {}
+};
+
+
+// Node of a place in a tree of the store, size counts the places below it and itself
+struct CallNode
+{
+	int left;
+	int right;
+	int parent;
+	int size;
+};
+
+
+
+// All calls of the client
+//
+// Owns the records, but knows nothing about dialogs: whoever removes a
+// record has to close its dialog first. Calls are referred to by handles,
+// a handle of a removed call just finds nothing.
+//
+// The store grows as needed, bounded by a memory budget for the call data
+// and their interned strings instead of a fixed number of calls. When a
+// new call doesn't fit, the oldest call is given up, handled calls before
+// unhandled ones. The places are linked in the order the calls came in,
+// once for all calls and once per handled state, so finding and removing
+// that call doesn't scan anything.
+//
+// Records are also indexed by (callID, reportedAt) in an open addressing
+// hash table, so finding a duplicate doesn't compare against every call.
+//
+// Every order a view lists the calls in is kept up to date as calls come
+// and go, in a treap whose nodes know the size below them: by time, by
+// time per handled state, by server and by target. So the call of a row
+// and the row of a call are found in O(log n), for any view at any time,
+// nothing is ever sorted, filtered or walked to list a view.
+//
+// A listener is told about every change. Bulk changes can be put between
+// beginUpdate() and endUpdate(), then it's only told once at the end.
+class CallStore
+{
+private:
+	// Links of a place, by arrival over all calls and by arrival per state
+	enum
+	{
+		LINK_AGE = 0,
+		LINK_STATE,
+		LINKS
+	};
+
+	// Trees of the orders: by time, by time per state, by name then time
+	enum
+	{
+		ORDER_TIME = 0,
+		ORDER_UNHANDLED,
+		ORDER_HANDLED,
+		ORDER_SERVER,
+		ORDER_TARGET,
+		ORDERS
+	};
+
+	// Nodes of a place, a call is either in the unhandled or the handled tree
+	enum
+	{
+		NODE_TIME = 0,
+		NODE_STATE,
+		NODE_SERVER,
+		NODE_TARGET,
+		NODES
+	};
+
+	struct Place
+	{
+		CallRecord* record;
+		unsigned int generation;
+
+		// Arrival, orders calls reported at the same time
+		unsigned int serial;
+
+		// Of the treaps, a parent has a higher one than its children
+		unsigned int priority;
+
+		int prev[LINKS];
+		int next[LINKS];
+
+		CallNode node[NODES];
+	};
+
+	std::vector<Place> places;
+	int count;
+
+	// Empty places, linked through next[LINK_AGE]
+	int firstFree;
+
+	// Lists of places
+	CallList all;
+	CallList unhandled;
+	CallList handled;
+
+	// Roots of the trees
+	int roots[ORDERS];
+
+	// Next serial and state of the priorities
+	unsigned int nextSerial;
+	unsigned int random;
+
+	// Memory used and allowed, in bytes
+	size_t memory;
+	size_t budget;
+
+	// Places of the records by hash, linear probing
+	std::vector<int> index;
+
+	// Used entries of the index, including deleted ones
+	size_t indexUsed;
+
+	// Told about changes, NULL if none
+	CallStoreListener* listener;
+
+	// Nesting of beginUpdate(), and whether something changed meanwhile
+	int updating;
+	bool changed;
+
+	// Should the listener be told about a change now?
+	bool notify();
+
+	static size_t hash(const CallRecord& record);
+
+	void indexInsert(int place);
+	void indexErase(int place);
+	void rehash();
+
+	void link(CallList& list, int type, int place);
+	void unlink(CallList& list, int type, int place);
+
+	// Trees of the orders
+	static int nodeOf(int order);
+	bool before(int order, int x, int y) const;
+	int sizeOf(int order, int place) const {return (place == -1) ? 0 : places[place].node[nodeOf(order)].size;}
+
+	void treeInsert(int order, int place);
+	void treeErase(int order, int place);
+	void rotateUp(int order, int place);
+
+	// Position of a place in a tree and the place at a position, -1 if none
+	int rankOf(int order, int place) const;
+	int placeAt(int order, int rank) const;
+
+	CallHandle toHandle(int place) const {return (place == -1) ? INVALID_CALL : (((CallHandle)places[place].generation << CALL_PLACE_BITS) | place);}
+	int toPlace(CallHandle handle) const;
+
+	// No copies
+	CallStore(const CallStore&);
+	CallStore& operator=(const CallStore&);
+
+public:
+	CallStore();
+	~CallStore();
+
+	// Record of a call, NULL if it's gone
+	CallRecord* get(CallHandle handle) const;
+
+	int getCount() const {return count;}
+
+	// Calls in the order they came in, INVALID_CALL at the end
+	CallHandle getFirst() const {return toHandle(all.first);}
+	CallHandle getNext(CallHandle handle) const;
+
+	// Call to give up for a new one: first handled, otherwise first that came in
+	CallHandle getOldest() const {return toHandle((handled.first != -1) ? handled.first : unhandled.first);}
+
+	// Rows of a view
+	int getViewCount(CALL_VIEW view) const;
+
+	// Call of a row of a view, INVALID_CALL if none
+	CallHandle getAt(CALL_VIEW view, long row) const;
+
+	// Row of a call in a view, -1 if the view doesn't list it
+	long getRow(CALL_VIEW view, CallHandle handle) const;
+
+	// Same call, INVALID_CALL if not found
+	CallHandle find(const CallRecord& record) const;
+
+	// Add a new call, the store takes it over
+	CallHandle add(CallRecord* record);
+
+	// Mark a call handled
+	void setHandled(CallHandle handle);
+
+	// Delete records
+	void remove(CallHandle handle);
+	void clear();
+
+
+	// Who is told about changes, NULL for nobody
+	void setListener(CallStoreListener* storeListener) {listener = storeListener;}
+	CallStoreListener* getListener() const {return listener;}
+
+	// Changes in between are told as one reset at the end
+	void beginUpdate() {updating++;}
+	void endUpdate();
+
+
+	// Memory of the call data
+	void setBudget(size_t bytes) {budget = bytes;}
+	size_t getBudget() const {return budget;}
+	size_t getMemory() const {return memory;}
+
+	// Memory a record takes in the store
+	static size_t getSize(const CallRecord& record);
+
+	// Does a new call fit without giving up others? Its strings are already interned
+	bool hasRoom(const CallRecord& record) const {return memory + call_strings.getMemory() + getSize(record) <= budget;}
+};
+
+
+
+// Calls
+extern CallStore call_store;
+
+
+#endif
@@ -0,0 +1,225 @@
+/**
+ * -----------------------------------------------------
+ * File        codec.cpp
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+// Project
+#include "codec.h"
+
+
+
+// FNV-1a
+unsigned int fnv1a(const char* data, size_t length, unsigned int hash)
+{
+	for (size_t i=0; i < length; i++)
+	{
+		hash = (hash ^ (unsigned char)data[i]) * 16777619U;
+	}
+
+	return hash;
+}
+
+
+
+// Little endian integers
+unsigned long long readLittle(const char* data, int bytes)
+{
+	unsigned long long result = 0;
+
+	for (int i = bytes - 1; i >= 0; i--)
+	{
+		result = (result << 8) | (unsigned char)data[i];
+	}
+
+	return result;
+}
+
+void writeLittle(std::string& out, unsigned long long value, int bytes)
+{
+	for (int i=0; i < bytes; i++, value >>= 8)
+	{
+		out += (char)(value & 0xFF);
+	}
+}
+
+
+// LEB128
+void writeVarint(std::string& out, unsigned long long value)
+{
+	while (value >= 0x80)
+	{
+		out += (char)((value & 0x7F) | 0x80);
+		value >>= 7;
+	}
+
+	out += (char)value;
+}
+
+
+// Length prefixed string
+void writeString(std::string& out, const std::string& value)
+{
+	writeVarint(out, value.size());
+
+	out += value;
+}
+
+
+
+// A call
+void writeCall(std::string& out, const CallRecord& record)
+{
+	writeString(out, record.callID);
+	writeString(out, record.fullIP);
+	writeString(out, record.serverName.str());
+	writeString(out, record.targetName.str());
+	writeLittle(out, record.targetID, 8);
+	writeString(out, record.targetReason.str());
+	writeString(out, record.clientName.str());
+	writeLittle(out, record.clientID, 8);
+	writeVarint(out, (unsigned long long)record.reportedAt);
+
+	out += (char)(record.handled ? 1 : 0);
+}
+
+
+
+
+// Next byte
+unsigned char CodecReader::readByte()
+{
+	if (pos >= end)
+	{
+		failed = true;
+
+		return 0;
+	}
+
+	return (unsigned char)*pos++;
+}
+
+
+// LEB128, at most 64 bits
+unsigned long long CodecReader::readVarint()
+{
+	unsigned long long result = 0;
+
+	for (int shift = 0; shift < 64; shift += 7)
+	{
+		unsigned char c = readByte();
+
+		result |= (unsigned long long)(c & 0x7F) << shift;
+
+		if (!(c & 0x80))
+		{
+			return result;
+		}
+	}
+
+	failed = true;
+
+	return 0;
+}
+
+
+// Little endian integer
+unsigned long long CodecReader::readLittle(int bytes)
+{
+	if (end - pos < bytes)
+	{
+		failed = true;
+		pos = end;
+
+		return 0;
+	}
+
+	unsigned long long result = ::readLittle(pos, bytes);
+
+	pos += bytes;
+
+	return result;
+}
+
+
+// Length prefixed string
+std::string CodecReader::readString()
+{
+	size_t length;
+	const char* span = readSpan(length);
+
+	return (span != NULL) ? std::string(span, length) : "";
+}
+
+
+// Length prefixed string in place
+const char* CodecReader::readSpan(size_t& length)
+{
+	unsigned long long value = readVarint();
+
+	if (failed || value > (unsigned long long)(end - pos))
+	{
+		failed = true;
+		length = 0;
+
+		return NULL;
+	}
+
+	const char* result = pos;
+
+	length = (size_t)value;
+	pos += length;
+
+	return result;
+}
+
+
+// Count of items
+size_t CodecReader::readCount()
+{
+	unsigned long long result = readVarint();
+
+	if (failed || result > (unsigned long long)(end - pos))
+	{
+		failed = true;
+
+		return 0;
+	}
+
+	return (size_t)result;
+}
+
+
+// A call
+void CodecReader::readCall(CallRecord& record)
+{
+	record.callID = readString();
+	record.fullIP = readString();
+	record.serverName = readString().c_str();
+	record.targetName = readString().c_str();
+	record.targetID = readU64();
+	record.targetReason = readString().c_str();
+	record.clientName = readString().c_str();
+	record.clientID = readU64();
+	record.reportedAt = (long)readVarint();
+	record.handled = (readByte() & 1) != 0;
+}
@@ -0,0 +1,107 @@
+#ifndef CODEC_H
+#define CODEC_H
+
+/**
+ * -----------------------------------------------------
+ * File        codec.h
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#pragma once
+
+
+// c++ libs
+#include <stddef.h>
+#include <string>
+
+// Project
+#include "callstore.h"
+
+
+
+// Encoding shared by the files of the client and the binary API format
+//
+// Integers are little endian, varints are unsigned LEB128, a string is a
+// varint length followed by its bytes. Hashes and checksums are FNV-1a.
+
+
+
+// FNV-1a, continuing from a hash to hash pieces one after the other
+#define FNV_OFFSET 2166136261U
+
+unsigned int fnv1a(const char* data, size_t length, unsigned int hash = FNV_OFFSET);
+inline unsigned int fnv1a(const std::string& text, unsigned int hash = FNV_OFFSET) {return fnv1a(text.data(), text.size(), hash);}
+
+
+
+// Little endian integers of 1 to 8 bytes
+unsigned long long readLittle(const char* data, int bytes);
+void writeLittle(std::string& out, unsigned long long value, int bytes);
+
+void writeVarint(std::string& out, unsigned long long value);
+void writeString(std::string& out, const std::string& value);
+
+
+// A call in the order of the binary API format
+//
+//   string callID, fullIP, serverName, targetName
+//   u64    targetID
+//   string targetReason, clientName
+//   u64    clientID
+//   varint reportedAt
+//   u8     flags                  bit 0: handled
+void writeCall(std::string& out, const CallRecord& record);
+
+
+
+// Reads encoded data, every read past the end fails it and gives 0 or ""
+class CodecReader
+{
+private:
+	const char* pos;
+	const char* end;
+
+	bool failed;
+
+public:
+	CodecReader(const char* data, size_t length) : pos(data), end(data + length), failed(false) {}
+
+	bool hasFailed() const {return failed;}
+	bool atEnd() const {return pos >= end;}
+
+	unsigned char readByte();
+	unsigned long long readVarint();
+	unsigned long long readLittle(int bytes);
+	unsigned long long readU64() {return readLittle(8);}
+	std::string readString();
+
+	// A string where it is, not terminated, NULL if it fails
+	const char* readSpan(size_t& length);
+
+	// A count of items which need at least a byte each
+	size_t readCount();
+
+	// A call as written by writeCall
+	void readCall(CallRecord& record);
+};
+
+
+#endif
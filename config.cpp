@@ -46,6 +46,7 @@ int step = 5;
 int timeout = 3;
 int maxAttempts = 3;
 int lastCalls = 25;
+int callMemory = CALL_MEMORY_DEFAULT;
 
 wxString page = "";
 wxString key = "";
@@ -54,6 +55,7 @@ wxString key = "";
 // Steam Enabled?
 bool steamEnabled = true;
 bool hideOnMinimize = false;
+bool singleCallWindow = false;
 
 
 // The config
@@ -66,6 +68,7 @@ enum
 	wxID_SetConfig = wxID_HIGHEST+400,
 	wxID_SteamUpdate,
 	wxID_HideUpdate,
+	wxID_SingleUpdate,
 };
 
 
@@ -75,6 +78,7 @@ BEGIN_EVENT_TABLE(ConfigPanel, wxPanel)
 
 	EVT_CHECKBOX(wxID_SteamUpdate, ConfigPanel::OnCheckBox)
 	EVT_CHECKBOX(wxID_HideUpdate, ConfigPanel::OnCheckBox2)
+	EVT_CHECKBOX(wxID_SingleUpdate, ConfigPanel::OnCheckBox3)
 END_EVENT_TABLE()
 
 
@@ -207,6 +211,20 @@ ConfigPanel::ConfigPanel(wxNotebook* note) : wxPanel(note, wxID_ANY)
 
 
 
+	// Ask for Call Memory
+	text = new wxStaticText(this, wxID_ANY, "Memory to keep calls in (in MB): ");
+	text->SetFont(wxFont(11, FONT_FAMILY, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+
+	memorySlider = new wxSpinCtrl(this, wxID_ANY, wxEmptyString, wxDefaultPosition, wxDefaultSize, wxSP_ARROW_KEYS | wxALIGN_RIGHT, 1, 1024, CALL_MEMORY_DEFAULT, "Call Memory");
+	memorySlider->SetFont(wxFont(11, FONT_FAMILY, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+
+	// Add to Grid
+	gridSizer->Add(text, wxGBPosition(currentPos, 0), wxDefaultSpan, 0, 10);
+	gridSizer->Add(memorySlider, wxGBPosition(currentPos++, 1), wxDefaultSpan, wxEXPAND);
+
+
+
+
 	// Static line
 	gridSizer->Add(new wxStaticLine(this, wxID_ANY), wxGBPosition(currentPos++, 0), wxGBSpan(1, 2), wxEXPAND | (wxALL &~ wxLEFT &~ wxRIGHT), 10);
 
@@ -246,6 +264,23 @@ ConfigPanel::ConfigPanel(wxNotebook* note) : wxPanel(note, wxID_ANY)
 
 
 
+	// Ask for one call window
+	text = new wxStaticText(this, wxID_ANY, "Show all calls in one window: ");
+	text->SetFont(wxFont(11, FONT_FAMILY, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+
+
+	// Add
+	singleWindow = new wxCheckBox(this, wxID_SingleUpdate, "One Call Window");
+	singleWindow->SetValue(false);
+
+
+	// Add one call window
+	gridSizer->Add(text, wxGBPosition(currentPos, 0), wxDefaultSpan, 0, 10);
+	gridSizer->Add(singleWindow, wxGBPosition(currentPos++, 1), wxDefaultSpan, wxRIGHT);
+
+
+
+
 	wxSizer* const sizerBtns = new wxBoxSizer(wxHORIZONTAL);
 
 	// Hide and Exit Button
@@ -280,7 +315,7 @@ void ConfigPanel::OnCheckBox(wxCommandEvent& WXUNUSED(event))
 		g_config->Write("steam", steamEnabled);
 
 		// Log Action
-		LogAction("Changed Steam Status");
+		LOG(LOG_CATEGORY_APP, LOG_LEVEL_INFO, "Changed Steam Status").field("enabled", steamEnabled);
 	}
 }
 
@@ -300,7 +335,26 @@ void ConfigPanel::OnCheckBox2(wxCommandEvent& WXUNUSED(event))
 		g_config->Write("hideonminimize", hideOnMinimize);
 
 		// Log Action
-		LogAction("Changed Hide on Minimize Status");
+		LOG(LOG_CATEGORY_APP, LOG_LEVEL_INFO, "Changed Hide on Minimize Status").field("enabled", hideOnMinimize);
+	}
+}
+
+
+
+
+// One Call Window Updated -> Set Config
+void ConfigPanel::OnCheckBox3(wxCommandEvent& WXUNUSED(event))
+{
+	// Read config value
+	if (singleWindow != NULL && g_config != NULL)
+	{
+		singleCallWindow = singleWindow->GetValue();
+
+		// Write to config file
+		g_config->Write("singlecallwindow", singleCallWindow);
+
+		// Log Action
+		LOG(LOG_CATEGORY_APP, LOG_LEVEL_INFO, "Changed One Call Window Status").field("enabled", singleCallWindow);
 	}
 }
 
@@ -311,7 +365,7 @@ void ConfigPanel::OnCheckBox2(wxCommandEvent& WXUNUSED(event))
 void ConfigPanel::OnSet(wxCommandEvent& WXUNUSED(event))
 {
 	// Valid?
-	if (hideMini == NULL || timeoutSlider == NULL || stepSlider == NULL || attemptsSlider == NULL || lastCalls == NULL || pageText == NULL || keyText == NULL || g_config == NULL || main_dialog == NULL || notebook == NULL)
+	if (hideMini == NULL || timeoutSlider == NULL || stepSlider == NULL || attemptsSlider == NULL || memorySlider == NULL || lastCalls == NULL || pageText == NULL || keyText == NULL || g_config == NULL || main_dialog == NULL || notebook == NULL)
 	{
 		return;
 	}
@@ -321,6 +375,7 @@ void ConfigPanel::OnSet(wxCommandEvent& WXUNUSED(event))
 	step = stepSlider->GetValue();
 	maxAttempts = attemptsSlider->GetValue();
 	lastCalls = callsSlider->GetValue();
+	callMemory = memorySlider->GetValue();
 
 	page = pageText->GetValue();
 	key = keyText->GetValue();
@@ -331,6 +386,7 @@ void ConfigPanel::OnSet(wxCommandEvent& WXUNUSED(event))
 	g_config->Write("timeout", timeout);
 	g_config->Write("attempts", maxAttempts);
 	g_config->Write("lastcalls", lastCalls);
+	g_config->Write("callmemory", callMemory);
 	g_config->Write("page", page);
 	g_config->Write("key", key);
 
@@ -341,7 +397,7 @@ void ConfigPanel::OnSet(wxCommandEvent& WXUNUSED(event))
 	main_dialog->setEventText("Enable new Settings...");
 
 	// Log Action
-	LogAction("Saved the config");
+	LOG(LOG_CATEGORY_APP, LOG_LEVEL_INFO, "Saved the config");
 
 
 	// Goto Main
@@ -359,7 +415,7 @@ void ConfigPanel::OnSet(wxCommandEvent& WXUNUSED(event))
 void ConfigPanel::parseConfig()
 {
 	// Valid?
-	if (hideMini == NULL || timeoutSlider == NULL || stepSlider == NULL || attemptsSlider == NULL || lastCalls == NULL || pageText == NULL || keyText == NULL || g_config == NULL || main_dialog == NULL)
+	if (hideMini == NULL || timeoutSlider == NULL || stepSlider == NULL || attemptsSlider == NULL || memorySlider == NULL || lastCalls == NULL || pageText == NULL || keyText == NULL || g_config == NULL || main_dialog == NULL)
 	{
 		return;
 	}
@@ -367,7 +423,7 @@ void ConfigPanel::parseConfig()
 	bool foundConfigError = false;
 
 	// Log Action
-	LogAction("Parse the config");
+	LOG(LOG_CATEGORY_APP, LOG_LEVEL_DEBUG, "Parse the config");
 
 
 	// Was parsing good?
@@ -384,9 +440,11 @@ void ConfigPanel::parseConfig()
 			timeout = g_config->ReadLong("timeout", 3l);
 			maxAttempts = g_config->ReadLong("attempts", 5l);
 			lastCalls = g_config->ReadLong("lastcalls", 25l);
+			callMemory = g_config->ReadLong("callmemory", (long)CALL_MEMORY_DEFAULT);
 
 			steamEnabled = g_config->ReadBool("steam", true);
 			hideOnMinimize = g_config->ReadBool("hideonminimize", false);
+			singleCallWindow = g_config->ReadBool("singlecallwindow", false);
 
 			g_config->Read("page", &page, "");
 
@@ -450,6 +508,16 @@ void ConfigPanel::parseConfig()
 			lastCalls = 50;
 		}
 
+		if (callMemory < 1)
+		{
+			callMemory = 1;
+		}
+
+		if (callMemory > 1024)
+		{
+			callMemory = 1024;
+		}
+
 		if (timeout >= step)
 		{
 			timeout = step - 1;
@@ -461,28 +529,30 @@ void ConfigPanel::parseConfig()
 		stepSlider->SetValue(step);
 		attemptsSlider->SetValue(maxAttempts);
 		callsSlider->SetValue(lastCalls);
+		memorySlider->SetValue(callMemory);
 
 		pageText->SetValue(page);
 		keyText->SetValue(key);
 
 		steamEnable->SetValue(steamEnabled);
 		hideMini->SetValue(hideOnMinimize);
+		singleWindow->SetValue(singleCallWindow);
+
+		// State of the page before
+		saveSnapshot();
+
+		// The call list is read once all calls are in
+		call_store.beginUpdate();
 
 		// Calls are unimportant
-		for (int i=0; i < MAXCALLS; i++)
-		{
-			if (call_dialogs[i] != NULL)
-			{
-				// Stop Avatar Timer
-				if (call_dialogs[i]->avatarTimer != NULL && call_dialogs[i]->avatarTimer->IsRunning())
-				{
-					call_dialogs[i]->avatarTimer->Stop();
-				}
-
-				call_dialogs[i]->Destroy();
-				call_dialogs[i] = NULL;
-			}
-		}
+		clearCalls();
+
+		call_store.setBudget((size_t)callMemory * 1024 * 1024);
+
+		// Calls of the last runs
+		loadHistory();
+
+		call_store.endUpdate();
 
 
 		// Timer... STOP!
@@ -493,11 +563,8 @@ void ConfigPanel::parseConfig()
 		}
 
 		// Log Action
-		LogAction("Loaded the config");
-
+		LOG(LOG_CATEGORY_APP, LOG_LEVEL_INFO, "Loaded the config");
 
-		// Updated Main Interface
-		main_dialog->resetCalls();
 
 		// First Start again ;D
 		timerStarted = false;
@@ -520,6 +587,6 @@ void ConfigPanel::parseConfig()
 		main_dialog->setEventText("Please configurate your settings...");
 
 		// Log Action
-		LogAction("Couldn't load/find the config");
+		LOG(LOG_CATEGORY_APP, LOG_LEVEL_WARNING, "Couldn't load/find the config");
 	}
 }
@@ -47,12 +47,18 @@ extern int timeout;
 extern int maxAttempts;
 extern int lastCalls;
 
+// Memory for calls in MB, only in the config file
+extern int callMemory;
+
 extern wxString page;
 extern wxString key;
 
 extern bool steamEnabled;
 extern bool hideOnMinimize;
 
+// One window for all calls
+extern bool singleCallWindow;
+
 
 // Config
 extern wxConfig *g_config;
@@ -66,10 +72,12 @@ private:
 	wxSpinCtrl* timeoutSlider;
 	wxSpinCtrl* attemptsSlider;
 	wxSpinCtrl* callsSlider;
+	wxSpinCtrl* memorySlider;
 	wxTextCtrl* pageText;
 	wxTextCtrl* keyText;
 	wxCheckBox* steamEnable;
 	wxCheckBox* hideMini;
+	wxCheckBox* singleWindow;
 
 public:
 	ConfigPanel(wxNotebook* note);
@@ -81,6 +89,7 @@ protected:
 
 	void OnCheckBox(wxCommandEvent& event);
 	void OnCheckBox2(wxCommandEvent& event);
+	void OnCheckBox3(wxCommandEvent& event);
 
 	void parseConfig();
 
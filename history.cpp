@@ -0,0 +1,578 @@
+/**
+ * -----------------------------------------------------
+ * File        history.cpp
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+// c++ libs
+#include <string.h>
+
+#if defined(_WIN32)
+	#include <windows.h>
+	#include <io.h>
+#else
+	#include <sys/mman.h>
+	#include <unistd.h>
+#endif
+
+
+// Project
+#include "codec.h"
+#include "history.h"
+
+
+
+// History of the calls
+CallHistory call_history;
+
+
+// Size of the record header: length and checksum
+#define HISTORY_HEADER 8
+
+// Size of the magics
+#define HISTORY_MAGIC 4
+
+
+
+// Is there a complete record at the offset? Gives its end
+static bool checkRecord(const char* data, size_t size, size_t offset, size_t* next)
+{
+	if (offset < HISTORY_MAGIC || offset > size || size - offset < HISTORY_HEADER)
+	{
+		return false;
+	}
+
+	size_t length = (size_t)readLittle(data + offset, 4);
+
+	if (length == 0 || length > size - offset - HISTORY_HEADER)
+	{
+		return false;
+	}
+
+	if (fnv1a(data + offset + HISTORY_HEADER, length) != (unsigned int)readLittle(data + offset + 4, 4))
+	{
+		return false;
+	}
+
+	*next = offset + HISTORY_HEADER + length;
+
+	return true;
+}
+
+
+// Size of an open file
+static size_t getFileSize(FILE* file)
+{
+	if (fseek(file, 0, SEEK_END) != 0)
+	{
+		return 0;
+	}
+
+	long size = ftell(file);
+
+	return (size > 0) ? (size_t)size : 0;
+}
+
+
+// Cut a file
+static bool truncateFile(FILE* file, size_t size)
+{
+	fflush(file);
+
+#if defined(_WIN32)
+	return _chsize(_fileno(file), (long)size) == 0;
+#else
+	return ftruncate(fileno(file), (off_t)size) == 0;
+#endif
+}
+
+
+// Open a file for reading and writing, create it with the magic if it's new
+// or not ours
+static FILE* openFile(const std::string& path, const char* magic)
+{
+	FILE* file = fopen(path.c_str(), "r+b");
+
+	if (file != NULL)
+	{
+		char read[HISTORY_MAGIC];
+
+		if (fread(read, 1, HISTORY_MAGIC, file) == HISTORY_MAGIC && memcmp(read, magic, HISTORY_MAGIC) == 0)
+		{
+			return file;
+		}
+
+		fclose(file);
+	}
+
+	file = fopen(path.c_str(), "w+b");
+
+	if (file != NULL && (fwrite(magic, 1, HISTORY_MAGIC, file) != HISTORY_MAGIC || fflush(file) != 0))
+	{
+		fclose(file);
+
+		return NULL;
+	}
+
+	return file;
+}
+
+
+
+
+// Nothing mapped yet
+FileMapping::FileMapping()
+{
+	data = NULL;
+	size = 0;
+
+#if defined(_WIN32)
+	mapping = NULL;
+#endif
+}
+
+
+// Map a file for reading
+bool FileMapping::map(FILE* file, size_t bytes)
+{
+	unmap();
+
+	if (bytes == 0)
+	{
+		return true;
+	}
+
+	fflush(file);
+
+#if defined(_WIN32)
+	mapping = CreateFileMapping((HANDLE)_get_osfhandle(_fileno(file)), NULL, PAGE_READONLY, 0, 0, NULL);
+
+	if (mapping == NULL)
+	{
+		return false;
+	}
+
+	data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, bytes);
+
+	if (data == NULL)
+	{
+		CloseHandle(mapping);
+		mapping = NULL;
+
+		return false;
+	}
+#else
+	void* view = mmap(NULL, bytes, PROT_READ, MAP_SHARED, fileno(file), 0);
+
+	if (view == MAP_FAILED)
+	{
+		return false;
+	}
+
+	data = (const char*)view;
+#endif
+
+	size = bytes;
+
+	return true;
+}
+
+
+// Unmap it
+void FileMapping::unmap()
+{
+	if (data == NULL)
+	{
+		return;
+	}
+
+#if defined(_WIN32)
+	UnmapViewOfFile(data);
+	CloseHandle(mapping);
+
+	mapping = NULL;
+#else
+	munmap((void*)data, size);
+#endif
+
+	data = NULL;
+	size = 0;
+}
+
+
+
+
+// Init. the history
+CallHistory::CallHistory()
+{
+	log = NULL;
+	index = NULL;
+
+	stale = false;
+
+	count = 0;
+	logEnd = HISTORY_MAGIC;
+
+	newest = 0;
+}
+
+
+
+// Open the files
+bool CallHistory::open(const std::string& logPath, const std::string& indexPath)
+{
+	close();
+
+	log = openFile(logPath, HISTORY_LOG_MAGIC);
+	index = openFile(indexPath, HISTORY_INDEX_MAGIC);
+
+	if (log == NULL || index == NULL || !check())
+	{
+		close();
+
+		return false;
+	}
+
+
+	// Newest call
+	CallRecord record;
+
+	for (size_t i = count; i > 0; i--)
+	{
+		if (read(i - 1, record) == HISTORY_CALL)
+		{
+			newest = record.reportedAt;
+
+			break;
+		}
+	}
+
+	return true;
+}
+
+
+// Close the files
+void CallHistory::close()
+{
+	logMapping.unmap();
+	indexMapping.unmap();
+
+	if (log != NULL)
+	{
+		fclose(log);
+	}
+
+	if (index != NULL)
+	{
+		fclose(index);
+	}
+
+	log = NULL;
+	index = NULL;
+
+	stale = false;
+
+	count = 0;
+	logEnd = HISTORY_MAGIC;
+
+	newest = 0;
+}
+
+
+
+// Check the index against the log and cut off a broken tail
+bool CallHistory::check()
+{
+	size_t logSize = getFileSize(log);
+	size_t indexSize = getFileSize(index);
+
+	if (!logMapping.map(log, logSize) || !indexMapping.map(index, indexSize))
+	{
+		return false;
+	}
+
+	const char* data = logMapping.getData();
+	const char* offsets = indexMapping.getData();
+
+
+	// The index is only trusted if every offset is where the length of the
+	// record before ends and the last one is a complete record
+	size_t entries = (indexSize - HISTORY_MAGIC) / 8;
+	bool valid = ((indexSize - HISTORY_MAGIC) % 8 == 0);
+
+	size_t previous = 0;
+	size_t expected = HISTORY_MAGIC;
+
+	for (size_t i=0; valid && i < entries; i++)
+	{
+		unsigned long long offset = readLittle(offsets + HISTORY_MAGIC + i * 8, 8);
+
+		valid = (offset == expected && offset <= logSize && logSize - offset >= HISTORY_HEADER);
+
+		if (valid)
+		{
+			previous = (size_t)offset;
+			expected = previous + HISTORY_HEADER + (size_t)readLittle(data + previous, 4);
+		}
+	}
+
+	size_t end = HISTORY_MAGIC;
+
+	if (valid && entries > 0)
+	{
+		valid = checkRecord(data, logSize, previous, &end);
+	}
+
+	if (!valid)
+	{
+		entries = 0;
+		end = HISTORY_MAGIC;
+	}
+
+	indexMapping.unmap();
+
+
+	// Records the index doesn't know yet, or all if it was broken
+	if (!rebuildIndex(entries, end))
+	{
+		return false;
+	}
+
+	logMapping.unmap();
+
+
+	// Cut off what was only partly written
+	if (logEnd < logSize && !truncateFile(log, logEnd))
+	{
+		return false;
+	}
+
+	stale = true;
+
+	return true;
+}
+
+
+// Add the records of the log from an offset on to the index
+bool CallHistory::rebuildIndex(size_t from, size_t offset)
+{
+	if (!truncateFile(index, HISTORY_MAGIC + from * 8) || fseek(index, 0, SEEK_END) != 0)
+	{
+		return false;
+	}
+
+	const char* data = logMapping.getData();
+	size_t size = logMapping.getSize();
+
+	count = from;
+
+	std::string entries;
+	size_t next;
+
+	while (checkRecord(data, size, offset, &next))
+	{
+		writeLittle(entries, offset, 8);
+
+		count++;
+		offset = next;
+	}
+
+	logEnd = offset;
+
+	return fwrite(entries.data(), 1, entries.size(), index) == entries.size() && fflush(index) == 0;
+}
+
+
+
+// Map the files again after appends
+bool CallHistory::remap()
+{
+	if (!logMapping.map(log, logEnd) || !indexMapping.map(index, HISTORY_MAGIC + count * 8))
+	{
+		return false;
+	}
+
+	stale = false;
+
+	return true;
+}
+
+
+
+// Read a record
+HISTORY_RECORD CallHistory::read(size_t number, CallRecord& record, long* handledAt)
+{
+	if (handledAt != NULL)
+	{
+		*handledAt = 0;
+	}
+
+	if (log == NULL || number >= count || (stale && !remap()))
+	{
+		return HISTORY_INVALID;
+	}
+
+	size_t offset = (size_t)readLittle(indexMapping.getData() + HISTORY_MAGIC + number * 8, 8);
+	size_t next;
+
+	if (!checkRecord(logMapping.getData(), logMapping.getSize(), offset, &next))
+	{
+		return HISTORY_INVALID;
+	}
+
+	CodecReader reader(logMapping.getData() + offset + HISTORY_HEADER, next - offset - HISTORY_HEADER);
+
+	HISTORY_RECORD kind = (HISTORY_RECORD)reader.readByte();
+
+	if (kind == HISTORY_CALL)
+	{
+		reader.readCall(record);
+	}
+	else if (kind == HISTORY_HANDLED)
+	{
+		record.callID = reader.readString();
+		record.reportedAt = (long)reader.readVarint();
+
+		// Older logs end here
+		long at = 0;
+
+		if (!reader.atEnd())
+		{
+			at = (long)reader.readVarint();
+
+			record.serverName = reader.readString().c_str();
+			record.targetReason = reader.readString().c_str();
+		}
+		else
+		{
+			record.serverName = "";
+			record.targetReason = "";
+		}
+
+		if (handledAt != NULL)
+		{
+			*handledAt = at;
+		}
+	}
+	else
+	{
+		return HISTORY_INVALID;
+	}
+
+	return reader.hasFailed() ? HISTORY_INVALID : kind;
+}
+
+
+
+// Append a new call
+bool CallHistory::append(const CallRecord& record)
+{
+	std::string payload;
+
+	payload += (char)HISTORY_CALL;
+
+	writeCall(payload, record);
+
+	if (!appendRecord(payload))
+	{
+		return false;
+	}
+
+	if (record.reportedAt > newest)
+	{
+		newest = record.reportedAt;
+	}
+
+	return true;
+}
+
+
+// Append the handled mark of a call
+bool CallHistory::appendHandled(const CallRecord& record, long handledAt)
+{
+	std::string payload;
+
+	payload += (char)HISTORY_HANDLED;
+
+	writeString(payload, record.callID);
+	writeVarint(payload, (unsigned long long)record.reportedAt);
+	writeVarint(payload, (unsigned long long)handledAt);
+	writeString(payload, record.serverName.str());
+	writeString(payload, record.targetReason.str());
+
+	return appendRecord(payload);
+}
+
+
+
+// Write a record to the log, then its offset to the index
+bool CallHistory::appendRecord(const std::string& payload)
+{
+	if (log == NULL)
+	{
+		return false;
+	}
+
+	std::string buffer;
+
+	writeLittle(buffer, payload.size(), 4);
+	writeLittle(buffer, fnv1a(payload), 4);
+
+	buffer += payload;
+
+
+	// The log first: an index entry must never point behind it
+	if (fseek(log, (long)logEnd, SEEK_SET) != 0 || fwrite(buffer.data(), 1, buffer.size(), log) != buffer.size() || fflush(log) != 0)
+	{
+		// Don't leave half a record
+		logMapping.unmap();
+		stale = true;
+
+		truncateFile(log, logEnd);
+
+		return false;
+	}
+
+	std::string entry;
+
+	writeLittle(entry, logEnd, 8);
+
+	if (fseek(index, (long)(HISTORY_MAGIC + count * 8), SEEK_SET) != 0 || fwrite(entry.data(), 1, entry.size(), index) != entry.size() || fflush(index) != 0)
+	{
+		// Both back to where they were
+		logMapping.unmap();
+		indexMapping.unmap();
+		stale = true;
+
+		truncateFile(index, HISTORY_MAGIC + count * 8);
+		truncateFile(log, logEnd);
+
+		return false;
+	}
+
+	logEnd += buffer.size();
+	count++;
+
+	stale = true;
+
+	return true;
+}
@@ -0,0 +1,166 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+/**
+ * -----------------------------------------------------
+ * File        history.h
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#pragma once
+
+
+// c++ libs
+#include <stdio.h>
+#include <string>
+
+// Project
+#include "callstore.h"
+
+
+
+// Magics of the files
+#define HISTORY_LOG_MAGIC "CAH1"
+#define HISTORY_INDEX_MAGIC "CAI1"
+
+
+
+// Kinds of records in the history
+enum HISTORY_RECORD
+{
+	HISTORY_INVALID = 0,
+
+	// A new call
+	HISTORY_CALL,
+
+	// A call was handled, only callID, reportedAt, serverName and
+	// targetReason are set
+	HISTORY_HANDLED,
+};
+
+
+
+// A file mapped into memory for reading
+class FileMapping
+{
+private:
+	const char* data;
+	size_t size;
+
+#if defined(_WIN32)
+	void* mapping;
+#endif
+
+	// No copies
+	FileMapping(const FileMapping&);
+	FileMapping& operator=(const FileMapping&);
+
+public:
+	FileMapping();
+	~FileMapping() {unmap();}
+
+	// Map the first bytes of a file, an empty file maps to nothing
+	bool map(FILE* file, size_t bytes);
+	void unmap();
+
+	const char* getData() const {return data;}
+	size_t getSize() const {return size;}
+};
+
+
+
+// History of all calls on disk
+//
+// The log is append only: a magic, then records of
+//
+//   u32     length of the payload
+//   u32     FNV-1a of the payload
+//   payload u8 kind, then for a call the fields in the order of the binary
+//           API format, for a handled call callID, reportedAt, then the
+//           varint time it was handled, serverName and targetReason
+//           (only in newer logs)
+//
+// A record that was only partly written when the client died fails its
+// checksum and is cut off on the next open. The index file holds the u64
+// offset of every record after its magic; it's only a shortcut, if it
+// doesn't match the log it's rebuilt from it. Integers are little endian.
+//
+// Both files are mapped for reading, appends go through plain writes.
+class CallHistory
+{
+private:
+	FILE* log;
+	FILE* index;
+
+	FileMapping logMapping;
+	FileMapping indexMapping;
+
+	// Mappings are behind the appends
+	bool stale;
+
+	// Records in the index, valid end of the log
+	size_t count;
+	size_t logEnd;
+
+	// reportedAt of the newest call
+	long newest;
+
+	bool check();
+	bool rebuildIndex(size_t from, size_t offset);
+	bool appendRecord(const std::string& payload);
+	bool remap();
+
+	// No copies
+	CallHistory(const CallHistory&);
+	CallHistory& operator=(const CallHistory&);
+
+public:
+	CallHistory();
+	~CallHistory() {close();}
+
+	// Open or create the files, a broken tail is cut off
+	bool open(const std::string& logPath, const std::string& indexPath);
+	void close();
+
+	bool isOpen() const {return log != NULL;}
+
+	// Records, calls and handled marks
+	size_t getCount() const {return count;}
+
+	// reportedAt of the newest call, 0 if there is none
+	long getNewest() const {return newest;}
+
+	// Read a record, the record gets the fields of its kind
+	// handledAt gets the time of a handled mark, 0 if unknown
+	HISTORY_RECORD read(size_t number, CallRecord& record, long* handledAt = NULL);
+
+	// Append a new call or the handled mark of a call
+	bool append(const CallRecord& record);
+	bool appendHandled(const CallRecord& record, long handledAt);
+};
+
+
+
+// History of the calls
+extern CallHistory call_history;
+
+
+#endif
@@ -0,0 +1,410 @@
+/**
+ * -----------------------------------------------------
+ * File        json.cpp
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+// c++ libs
+#include <string.h>
+
+// Project
+#include "json.h"
+
+
+
+// Init. the reader
+JsonReader::JsonReader(char* buffer, size_t length)
+{
+	begin = pos = buffer;
+	depth = 0;
+	first = false;
+	afterKey = false;
+	started = false;
+	value = "";
+	error = "";
+	number[0] = '\0';
+
+	// Terminate it
+	if (pos != NULL && length != (size_t)-1)
+	{
+		pos[length] = '\0';
+	}
+}
+
+
+
+// Read the next token
+JSON_TOKEN JsonReader::next()
+{
+	value = "";
+
+	if (pos == NULL)
+	{
+		return fail("JSON_ERROR_EMPTY_DOCUMENT");
+	}
+
+	skipWhiteSpace();
+
+
+	// Top level
+	if (depth == 0)
+	{
+		if (!started)
+		{
+			started = true;
+
+			if (*pos == '\0')
+			{
+				return fail("JSON_ERROR_EMPTY_DOCUMENT");
+			}
+
+			return readValue();
+		}
+
+		// Only whitespace may follow
+		if (*pos != '\0')
+		{
+			return fail("JSON_ERROR_TRAILING_DATA");
+		}
+
+		return JSON_END;
+	}
+
+
+	// Key read, now its value
+	if (afterKey)
+	{
+		afterKey = false;
+
+		return readValue();
+	}
+
+
+	char top = stack[depth - 1];
+
+	// End of the container?
+	if (*pos == (top == '{' ? '}' : ']'))
+	{
+		pos++;
+		depth--;
+		first = false;
+
+		return (top == '{') ? JSON_OBJECT_END : JSON_ARRAY_END;
+	}
+
+	// Items are separated by a comma
+	if (!first)
+	{
+		if (*pos != ',')
+		{
+			return fail("JSON_ERROR_EXPECTED_COMMA");
+		}
+
+		pos++;
+		skipWhiteSpace();
+	}
+
+	first = false;
+
+
+	// Array item
+	if (top == '[')
+	{
+		return readValue();
+	}
+
+
+	// Object key
+	if (*pos != '"' || readString(&value) != JSON_STRING)
+	{
+		return fail("JSON_ERROR_EXPECTED_KEY");
+	}
+
+	skipWhiteSpace();
+
+	if (*pos != ':')
+	{
+		return fail("JSON_ERROR_EXPECTED_COLON");
+	}
+
+	pos++;
+	afterKey = true;
+
+	return JSON_KEY;
+}
+
+
+
+// Skip an object or array which was just started
+bool JsonReader::skip()
+{
+	int level = depth;
+
+	while (depth >= level)
+	{
+		JSON_TOKEN token = next();
+
+		if (token == JSON_ERROR || token == JSON_END)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+
+// Read any value
+JSON_TOKEN JsonReader::readValue()
+{
+	switch (*pos)
+	{
+		case '{':
+		case '[':
+		{
+			if (depth == JSON_MAX_DEPTH)
+			{
+				return fail("JSON_ERROR_TOO_DEEP");
+			}
+
+			stack[depth++] = *pos;
+			first = true;
+
+			return (*pos++ == '{') ? JSON_OBJECT_START : JSON_ARRAY_START;
+		}
+
+		case '"':
+			return readString(&value);
+
+		case 't':
+			return readLiteral("true", JSON_TRUE);
+
+		case 'f':
+			return readLiteral("false", JSON_FALSE);
+
+		case 'n':
+			return readLiteral("null", JSON_NULL);
+
+		default:
+		{
+			if (*pos == '-' || (*pos >= '0' && *pos <= '9'))
+			{
+				return readNumber();
+			}
+
+			return fail("JSON_ERROR_UNEXPECTED_CHARACTER");
+		}
+	}
+}
+
+
+
+// Read a string and unescape it in place
+JSON_TOKEN JsonReader::readString(const char** result)
+{
+	// Skip quote
+	char* read = ++pos;
+	char* write = read;
+
+	*result = read;
+
+	while (*read != '"')
+	{
+		unsigned char c = (unsigned char)*read;
+
+		if (c == '\0' || c < 0x20)
+		{
+			return fail("JSON_ERROR_PARSING_STRING");
+		}
+
+		if (c != '\\')
+		{
+			*write++ = *read++;
+
+			continue;
+		}
+
+
+		// Escape sequence
+		read++;
+
+		switch (*read++)
+		{
+			case '"':  *write++ = '"'; break;
+			case '\\': *write++ = '\\'; break;
+			case '/':  *write++ = '/'; break;
+			case 'b':  *write++ = '\b'; break;
+			case 'f':  *write++ = '\f'; break;
+			case 'n':  *write++ = '\n'; break;
+			case 'r':  *write++ = '\r'; break;
+			case 't':  *write++ = '\t'; break;
+
+			case 'u':
+			{
+				unsigned long code = 0;
+
+				for (int i=0; i < 4; i++, read++)
+				{
+					char h = *read;
+
+					code <<= 4;
+
+					if (h >= '0' && h <= '9') code |= h - '0';
+					else if (h >= 'a' && h <= 'f') code |= h - 'a' + 10;
+					else if (h >= 'A' && h <= 'F') code |= h - 'A' + 10;
+					else return fail("JSON_ERROR_PARSING_STRING");
+				}
+
+				// Surrogate pair
+				if (code >= 0xD800 && code <= 0xDBFF && read[0] == '\\' && read[1] == 'u')
+				{
+					unsigned long low = 0;
+
+					for (int i=2; i < 6; i++)
+					{
+						char h = read[i];
+
+						low <<= 4;
+
+						if (h >= '0' && h <= '9') low |= h - '0';
+						else if (h >= 'a' && h <= 'f') low |= h - 'a' + 10;
+						else if (h >= 'A' && h <= 'F') low |= h - 'A' + 10;
+						else return fail("JSON_ERROR_PARSING_STRING");
+					}
+
+					if (low >= 0xDC00 && low <= 0xDFFF)
+					{
+						code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+						read += 6;
+					}
+				}
+
+				// To UTF-8, never longer than the escape sequence
+				if (code < 0x80)
+				{
+					*write++ = (char)code;
+				}
+				else if (code < 0x800)
+				{
+					*write++ = (char)(0xC0 | (code >> 6));
+					*write++ = (char)(0x80 | (code & 0x3F));
+				}
+				else if (code < 0x10000)
+				{
+					*write++ = (char)(0xE0 | (code >> 12));
+					*write++ = (char)(0x80 | ((code >> 6) & 0x3F));
+					*write++ = (char)(0x80 | (code & 0x3F));
+				}
+				else
+				{
+					*write++ = (char)(0xF0 | (code >> 18));
+					*write++ = (char)(0x80 | ((code >> 12) & 0x3F));
+					*write++ = (char)(0x80 | ((code >> 6) & 0x3F));
+					*write++ = (char)(0x80 | (code & 0x3F));
+				}
+
+				break;
+			}
+
+			default:
+				return fail("JSON_ERROR_PARSING_STRING");
+		}
+	}
+
+	// Terminate it, the closing quote is overwritten at the latest
+	*write = '\0';
+	pos = read + 1;
+
+	return JSON_STRING;
+}
+
+
+
+// Read a number
+JSON_TOKEN JsonReader::readNumber()
+{
+	char* start = pos;
+
+	if (*pos == '-')
+	{
+		pos++;
+	}
+
+	while ((*pos >= '0' && *pos <= '9') || *pos == '.' || *pos == 'e' || *pos == 'E' || *pos == '+' || *pos == '-')
+	{
+		pos++;
+	}
+
+	size_t length = pos - start;
+
+	if (length >= sizeof(number) || (length == 1 && *start == '-'))
+	{
+		return fail("JSON_ERROR_PARSING_NUMBER");
+	}
+
+	// Terminating it in place would overwrite the next token. The character
+	// in front of it was already read, so move the number there instead
+	if (start > begin)
+	{
+		memmove(start - 1, start, length);
+		start[length - 1] = '\0';
+
+		value = start - 1;
+	}
+	else
+	{
+		memcpy(number, start, length);
+		number[length] = '\0';
+
+		value = number;
+	}
+
+	return JSON_NUMBER;
+}
+
+
+
+// Read true, false or null
+JSON_TOKEN JsonReader::readLiteral(const char* literal, JSON_TOKEN token)
+{
+	size_t length = strlen(literal);
+
+	if (strncmp(pos, literal, length) != 0)
+	{
+		return fail("JSON_ERROR_UNEXPECTED_CHARACTER");
+	}
+
+	pos += length;
+
+	// Same as the xml API
+	if (token == JSON_TRUE)
+	{
+		value = "1";
+	}
+	else if (token == JSON_FALSE)
+	{
+		value = "0";
+	}
+
+	return token;
+}
@@ -0,0 +1,120 @@
+#ifndef JSON_H
+#define JSON_H
+
+/**
+ * -----------------------------------------------------
+ * File        json.h
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#pragma once
+
+
+// c++ libs
+#include <stddef.h>
+
+
+
+// Max. nesting of objects and arrays
+#define JSON_MAX_DEPTH 32
+
+
+
+// Tokens of the reader
+enum JSON_TOKEN
+{
+	JSON_END = 0,
+	JSON_ERROR,
+
+	JSON_OBJECT_START,
+	JSON_OBJECT_END,
+	JSON_ARRAY_START,
+	JSON_ARRAY_END,
+
+	JSON_KEY,
+	JSON_STRING,
+	JSON_NUMBER,
+	JSON_TRUE,
+	JSON_FALSE,
+	JSON_NULL,
+};
+
+
+
+// Streaming JSON reader
+//
+// Works in place on a mutable buffer: strings are unescaped and terminated
+// inside it, so reading allocates nothing. Keys and strings returned by
+// getValue() stay valid as long as the buffer does.
+class JsonReader
+{
+private:
+	char* begin;
+	char* pos;
+
+	// Open containers, '{' or '['
+	char stack[JSON_MAX_DEPTH];
+	int depth;
+
+	// State inside the current container
+	bool first;
+	bool afterKey;
+	bool started;
+
+	// Current value
+	const char* value;
+
+	// A top level number can't be terminated in place
+	char number[64];
+
+	// Error
+	const char* error;
+
+	JSON_TOKEN readValue();
+	JSON_TOKEN readString(const char** result);
+	JSON_TOKEN readNumber();
+	JSON_TOKEN readLiteral(const char* literal, JSON_TOKEN token);
+	JSON_TOKEN fail(const char* reason) {error = reason; return JSON_ERROR;}
+
+	void skipWhiteSpace() {while (*pos == ' ' || *pos == '\t' || *pos == '\n' || *pos == '\r') pos++;}
+
+public:
+	// buffer[length] is overwritten with the terminator, length -1 means already terminated
+	JsonReader(char* buffer, size_t length = (size_t)-1);
+
+	// Next token
+	JSON_TOKEN next();
+
+	// Skip the rest of a just started object or array
+	bool skip();
+
+	// Text of the last key, string or number; true, false and null read as "1", "0" and ""
+	const char* getValue() const {return value;}
+
+	// Nesting of the last token
+	int getDepth() const {return depth;}
+
+	// Reason of the last JSON_ERROR
+	const char* getError() const {return error;}
+};
+
+
+#endif
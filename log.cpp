@@ -27,8 +27,14 @@
 #include <sstream>
 #include <ctime>
 
+// Log File Directory
+#include <wx/filename.h>
+
 // Include Project
 #include "log.h"
+#include "logring.h"
+#include "logqueue.h"
+#include "logfile.h"
 #include "main.h"
 #include "taskbar.h"
 #include "calladmin-client.h"
@@ -37,6 +43,9 @@
 // Log Panel
 LogPanel* logPanel = NULL;
 
+// Log File
+LogFileThread* logFile = NULL;
+
 
 
 // Create Log Panel
@@ -59,12 +68,12 @@ LogPanel::LogPanel(wxNotebook* note) : wxPanel(note, wxID_ANY)
 	wxSizer* const sizerTop = new wxBoxSizer(wxVERTICAL);
 
 
-	logBox = new wxListBox(this, wxID_ANY, wxDefaultPosition, wxDefaultSize, 0, NULL, wxLB_HSCROLL | wxLB_SINGLE);
-	logBox->SetFont(wxFont(12, FONT_FAMILY, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+	logList = new LogListCtrl(this);
+	logList->SetFont(wxFont(12, FONT_FAMILY, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
 
 
 	// Add Log Box
-	sizerTop->Add(logBox, 1, wxEXPAND);
+	sizerTop->Add(logList, 1, wxEXPAND);
 
 
 
@@ -75,33 +84,304 @@ LogPanel::LogPanel(wxNotebook* note) : wxPanel(note, wxID_ANY)
 
 
 
-// Add Action to the logBox
-void LogPanel::addLog(wxString log)
+// Create the list
+LogListCtrl::LogListCtrl(wxWindow* parent) : wxListCtrl(parent, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxLC_REPORT | wxLC_VIRTUAL | wxLC_SINGLE_SEL)
+{
+	warningAttr.SetTextColour(wxColour(160, 110, 0));
+	errorAttr.SetTextColour(wxColour(200, 0, 0));
+
+	InsertColumn(LOG_COLUMN_TIME, "Time", wxLIST_FORMAT_LEFT, 200);
+	InsertColumn(LOG_COLUMN_LEVEL, "Level", wxLIST_FORMAT_LEFT, 70);
+	InsertColumn(LOG_COLUMN_CATEGORY, "Category", wxLIST_FORMAT_LEFT, 70);
+	InsertColumn(LOG_COLUMN_ACTION, "Action", wxLIST_FORMAT_LEFT, 600);
+
+	// Lines logged before the panel existed
+	update();
+}
+
+
+
+// Lines were added to the ring
+void LogListCtrl::update()
+{
+	// Only follow the newest lines if they were in sight
+	bool atEnd = (GetTopItem() + GetCountPerPage() >= GetItemCount());
+
+	long count = (long)log_ring.getCount();
+
+	SetItemCount(count);
+
+	// A full ring moved every line up
+	Refresh();
+
+	if (atEnd && count > 0)
+	{
+		EnsureVisible(count - 1);
+	}
+}
+
+
+
+// Text of a line, read when it's drawn
+wxString LogListCtrl::OnGetItemText(long item, long column) const
+{
+	if (item < 0 || (size_t)item >= log_ring.getCount())
+	{
+		return "";
+	}
+
+	const LogEntry& entry = log_ring.get((size_t)item);
+
+	switch (column)
+	{
+		case LOG_COLUMN_TIME:
+		{
+			char buffer[80];
+
+			time_t t = (time_t)entry.time;
+
+			strftime(buffer, sizeof(buffer), "%c", localtime(&t));
+
+			return buffer;
+		}
+
+		case LOG_COLUMN_LEVEL:
+			return getLogLevelName(entry.level);
+
+		case LOG_COLUMN_CATEGORY:
+			return getLogCategoryName(entry.category);
+
+		case LOG_COLUMN_ACTION:
+			return wxString::FromUTF8((entry.text + entry.fields).c_str());
+
+		default:
+			return "";
+	}
+}
+
+
+
+// Style of a line
+wxListItemAttr* LogListCtrl::OnGetItemAttr(long item) const
+{
+	if (item < 0 || (size_t)item >= log_ring.getCount())
+	{
+		return NULL;
+	}
+
+	switch (log_ring.get((size_t)item).level)
+	{
+		case LOG_LEVEL_WARNING:
+			return const_cast<wxListItemAttr*>(&warningAttr);
+
+		case LOG_LEVEL_ERROR:
+			return const_cast<wxListItemAttr*>(&errorAttr);
+
+		default:
+			return NULL;
+	}
+}
+
+
+
+
+// Queue the line, from any thread
+LogLine::~LogLine()
+{
+	// The UI thread does the rest when it's idle
+	if (log_queue.push(entry))
+	{
+		wxWakeUpIdle();
+	}
+}
+
+
+
+// Move queued lines into the ring
+bool drainLog()
+{
+	log_queue.startDrain();
+
+	LogEntry entry;
+	int taken = 0;
+
+	// Lines for the file, handed over at once
+	static std::vector<LogEntry> fileLines;
+
+	while (taken < LOG_DRAIN_BATCH && log_queue.pop(entry))
+	{
+		log_ring.add(entry);
+
+		if (logFile != NULL)
+		{
+			fileLines.push_back(entry);
+		}
+
+		taken++;
+	}
+
+	if (!fileLines.empty())
+	{
+		logFile->add(fileLines);
+
+		fileLines.clear();
+	}
+
+	// Show them at once
+	if (taken > 0 && logPanel != NULL)
+	{
+		logPanel->update();
+	}
+
+	return (taken == LOG_DRAIN_BATCH);
+}
+
+
+
+
+// Create the writer, it opens the file itself
+LogFileThread::LogFileThread(const std::string& filePath) : wxThread(wxTHREAD_JOINABLE), path(filePath), wake(lock), dropped(0), stopping(false)
+{
+	this->Create();
+	this->Run();
+}
+
+
+
+// Write batches until stopped
+wxThread::ExitCode LogFileThread::Entry()
 {
-	if (logBox != NULL)
+	if (!file.open(path))
 	{
-		logBox->SetSelection(logBox->Append(wxString::FromUTF8(log)));
+		LOG(LOG_CATEGORY_APP, LOG_LEVEL_ERROR, "Couldn't open the log file").field("path", path);
 	}
+
+	std::vector<LogEntry> batch;
+
+	while (true)
+	{
+		unsigned long lost;
+		bool done;
+
+		{
+			wxMutexLocker locker(lock);
+
+			while (queued.empty() && dropped == 0 && !stopping)
+			{
+				wake.Wait();
+			}
+
+			// Take everything, the empty batch is the new queue
+			batch.swap(queued);
+
+			lost = dropped;
+			dropped = 0;
+
+			done = stopping;
+		}
+
+		// Nothing is locked while writing
+		if (file.isOpen())
+		{
+			file.write(batch, lost);
+		}
+
+		batch.clear();
+
+		if (done)
+		{
+			break;
+		}
+	}
+
+	file.close();
+
+	return (wxThread::ExitCode)0;
 }
 
 
 
+// Hand lines over
+void LogFileThread::add(const std::vector<LogEntry>& lines)
+{
+	wxMutexLocker locker(lock);
+
+	for (size_t i=0; i < lines.size(); i++)
+	{
+		if (queued.size() >= LOG_FILE_QUEUE)
+		{
+			dropped += lines.size() - i;
 
-void LogAction(wxString action)
+			break;
+		}
+
+		queued.push_back(lines[i]);
+	}
+
+	wake.Signal();
+}
+
+
+
+// Write what's left and end
+void LogFileThread::stop()
 {
-	// Add the new Log to the Log box
-	char buffer[80];
+	{
+		wxMutexLocker locker(lock);
+
+		stopping = true;
+
+		wake.Signal();
+	}
+
+	Wait();
+}
 
-	time_t t = time(0);
 
-	struct tm* now = localtime(&t);
 
-	// But first we need a Time
-	strftime(buffer, sizeof(buffer), "%c", now);
 
-	// Add the log
-	if (logPanel != NULL)
+// Start writing the log file
+void startLogFile()
+{
+	if (logFile != NULL)
 	{
-		logPanel->addLog((wxString)buffer + " - " + action);		
+		return;
 	}
+
+	wxString dir = wxStandardPaths::Get().GetUserDataDir();
+
+	if (!wxFileName::DirExists(dir) && !wxFileName::Mkdir(dir, wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL))
+	{
+		return;
+	}
+
+	logFile = new LogFileThread((std::string)(dir + wxFileName::GetPathSeparator() + "calladmin.log"));
+}
+
+
+
+// Write the last lines and stop
+void stopLogFile()
+{
+	if (logFile == NULL)
+	{
+		return;
+	}
+
+	// Lines which were never shown
+	std::vector<LogEntry> lines;
+	LogEntry entry;
+
+	log_queue.startDrain();
+
+	while (log_queue.pop(entry))
+	{
+		lines.push_back(entry);
+	}
+
+	logFile->add(lines);
+	logFile->stop();
+
+	delete logFile;
+	logFile = NULL;
 }
\ No newline at end of file
@@ -39,6 +39,52 @@
 
 #include <wx/listctrl.h>
 #include <wx/notebook.h>
+#include <wx/thread.h>
+
+// c++ libs
+#include <ctime>
+#include <sstream>
+#include <vector>
+
+// Project
+#include "logfile.h"
+
+
+
+// Columns of the log list
+enum LOG_COLUMN
+{
+	LOG_COLUMN_TIME = 0,
+	LOG_COLUMN_LEVEL,
+	LOG_COLUMN_CATEGORY,
+	LOG_COLUMN_ACTION,
+
+	LOG_COLUMNS
+};
+
+
+
+// Lines of the log ring
+//
+// Virtual, so however long the client runs the control holds no items:
+// only the lines in sight are read from the ring and converted.
+class LogListCtrl : public wxListCtrl
+{
+private:
+	// Warnings and errors stand out
+	wxListItemAttr warningAttr;
+	wxListItemAttr errorAttr;
+
+protected:
+	virtual wxString OnGetItemText(long item, long column) const;
+	virtual wxListItemAttr* OnGetItemAttr(long item) const;
+
+public:
+	LogListCtrl(wxWindow* parent);
+
+	// Lines were added to the ring
+	void update();
+};
 
 
 
@@ -46,17 +92,99 @@
 class LogPanel: public wxPanel
 {
 private:
-	wxListBox* logBox;
+	LogListCtrl* logList;
 
 public:
 	LogPanel(wxNotebook* note);
 
-	void addLog(wxString log);
+	void update() {logList->update();}
 };
 
 
-// Log a Action
-void LogAction(wxString action);
+// Writes the log lines to the log file
+//
+// The UI thread only hands the lines over, one lock per drain. The queue is
+// bounded: when the disk doesn't keep up, lines are dropped and counted
+// instead of letting the UI wait, the file notes how many were lost.
+class LogFileThread : public wxThread
+{
+private:
+	LogFile file;
+	std::string path;
+
+	wxMutex lock;
+	wxCondition wake;
+
+	// Guarded by lock
+	std::vector<LogEntry> queued;
+	unsigned long dropped;
+	bool stopping;
+
+public:
+	LogFileThread(const std::string& filePath);
+
+	virtual ExitCode Entry();
+
+	// UI thread: hand lines over, never waits for the disk
+	void add(const std::vector<LogEntry>& lines);
+
+	// Write what's left and end the thread
+	void stop();
+};
+
+
+// Start and stop writing the log file
+void startLogFile();
+void stopLogFile();
+
+
+
+// A line being logged, queued when it goes out of scope
+//
+// Only made by LOG after the level was checked, so a line below the level
+// of its category costs a compare: its message isn't copied and its fields
+// aren't even evaluated. The message is fixed text, everything which
+// changes goes into fields, which keeps the lines easy to search and parse.
+class LogLine
+{
+private:
+	LogEntry entry;
+
+	// No copies
+	LogLine(const LogLine&);
+	LogLine& operator=(const LogLine&);
+
+public:
+	LogLine(LOG_CATEGORY category, LOG_LEVEL level, const char* message) : entry((long)time(0), level, category, message) {}
+	~LogLine();
+
+	// Add a key=value field
+	LogLine& field(const char* key, const char* value) {entry.addField(key, value); return *this;}
+	LogLine& field(const char* key, const std::string& value) {entry.addField(key, value); return *this;}
+	LogLine& field(const char* key, const wxString& value) {entry.addField(key, (const char*)value.ToUTF8()); return *this;}
+
+	// Anything else a stream can write
+	template <class T>
+	LogLine& field(const char* key, const T& value)
+	{
+		std::ostringstream out;
+
+		out << value;
+
+		entry.addField(key, out.str());
+
+		return *this;
+	}
+};
+
+
+// Log a line from any thread, fields follow as .field(key, value)
+//   LOG(LOG_CATEGORY_STEAM, LOG_LEVEL_DEBUG, "Loaded avatar").field("steamid", id->Render());
+#define LOG(category, level, message) LOG_IF(category, level) LogLine(category, level, message)
+
+// UI thread: move queued lines into the ring and show them
+// Returns true if lines are left for the next idle event
+bool drainLog();
 
 
 #endif
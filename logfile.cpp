@@ -0,0 +1,198 @@
+/**
+ * -----------------------------------------------------
+ * File        logfile.cpp
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+// c++ libs
+#include <ctime>
+#include <string.h>
+
+// Project
+#include "logfile.h"
+
+
+
+// Open for appending
+bool LogFile::open(const std::string& filePath, size_t fileSize, int oldFiles)
+{
+	close();
+
+	path = filePath;
+	maxSize = fileSize;
+	keep = oldFiles;
+
+	file = fopen(path.c_str(), "ab");
+
+	if (file == NULL)
+	{
+		return false;
+	}
+
+	// Append mode starts at the end only with the first write
+	fseek(file, 0, SEEK_END);
+
+	long end = ftell(file);
+
+	size = (end > 0) ? (size_t)end : 0;
+
+	return true;
+}
+
+
+// Close the file
+void LogFile::close()
+{
+	if (file != NULL)
+	{
+		fclose(file);
+	}
+
+	file = NULL;
+	size = 0;
+}
+
+
+
+// Write lines
+bool LogFile::write(const std::vector<LogEntry>& lines, unsigned long dropped)
+{
+	if (file == NULL || (lines.empty() && dropped == 0))
+	{
+		return file != NULL;
+	}
+
+	buffer.clear();
+
+	if (dropped > 0)
+	{
+		char count[32];
+
+		sprintf(count, "%lu", dropped);
+
+		LogEntry entry(lines.empty() ? (long)time(0) : lines[0].time, LOG_LEVEL_WARNING, LOG_CATEGORY_APP, "Dropped lines, the disk was too slow");
+
+		entry.addField("count", count);
+
+		format(entry);
+	}
+
+	for (size_t i=0; i < lines.size(); i++)
+	{
+		format(lines[i]);
+	}
+
+
+	// Full, start a new one
+	if (size > 0 && size + buffer.size() > maxSize && !rotate())
+	{
+		return false;
+	}
+
+	// The whole batch at once
+	if (fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size() || fflush(file) != 0)
+	{
+		return false;
+	}
+
+	size += buffer.size();
+
+	return true;
+}
+
+
+
+// Add a line to the batch
+void LogFile::format(const LogEntry& entry)
+{
+	// Lines come in bursts, so most share their second with the one before
+	if (entry.time != lastTime)
+	{
+		time_t t = (time_t)entry.time;
+		struct tm local;
+
+#if defined(_WIN32)
+		localtime_s(&local, &t);
+#else
+		localtime_r(&t, &local);
+#endif
+
+		strftime(timeText, sizeof(timeText), "%Y-%m-%d %H:%M:%S", &local);
+
+		lastTime = entry.time;
+	}
+
+	buffer += timeText;
+	buffer += ' ';
+	buffer += getLogLevelName(entry.level);
+	buffer += ' ';
+	buffer += getLogCategoryName(entry.category);
+
+	// The message is a field too
+	message.fields.clear();
+	message.addField("msg", entry.text);
+
+	buffer += message.fields;
+	buffer += entry.fields;
+	buffer += '\n';
+}
+
+
+
+// Move the files up a number and start a new one
+bool LogFile::rotate()
+{
+	fclose(file);
+
+	file = NULL;
+
+	char number[16];
+
+	// The oldest is gone
+	sprintf(number, ".%d", keep);
+
+	remove((path + number).c_str());
+
+	for (int i = keep - 1; i >= 1; i--)
+	{
+		char next[16];
+
+		sprintf(number, ".%d", i);
+		sprintf(next, ".%d", i + 1);
+
+		rename((path + number).c_str(), (path + next).c_str());
+	}
+
+	if (keep > 0)
+	{
+		rename(path.c_str(), (path + ".1").c_str());
+	}
+	else
+	{
+		remove(path.c_str());
+	}
+
+	file = fopen(path.c_str(), "wb");
+	size = 0;
+
+	return file != NULL;
+}
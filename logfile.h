@@ -0,0 +1,104 @@
+#ifndef LOGFILE_H
+#define LOGFILE_H
+
+/**
+ * -----------------------------------------------------
+ * File        logfile.h
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#pragma once
+
+
+// c++ libs
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+// Project
+#include "logring.h"
+
+
+
+// Size of a log file before it's rotated, in bytes
+#define LOG_FILE_SIZE (4 * 1024 * 1024)
+
+// Old files kept: calladmin.log.1 is the newest of them
+#define LOG_FILE_KEEP 3
+
+// Lines waiting for the log file at most, more are dropped
+#define LOG_FILE_QUEUE 20000
+
+
+
+// Log lines on disk
+//
+// A line is its time, level and category, then the message and its fields
+// as key=value, so it's read by people and scripts alike.
+//
+// Lines are written in batches, each batch with one write and flush. A
+// batch that would make the file bigger than its size starts a new file:
+// the old ones move up a number and the oldest is deleted.
+class LogFile
+{
+private:
+	FILE* file;
+
+	std::string path;
+	size_t maxSize;
+	int keep;
+
+	// Bytes in the current file
+	size_t size;
+
+	// A batch is formatted into this
+	std::string buffer;
+
+	// Quotes the message
+	LogEntry message;
+
+	// Time text of the last second formatted
+	long lastTime;
+	char timeText[32];
+
+	bool rotate();
+	void format(const LogEntry& entry);
+
+	// No copies
+	LogFile(const LogFile&);
+	LogFile& operator=(const LogFile&);
+
+public:
+	LogFile() : file(NULL), maxSize(LOG_FILE_SIZE), keep(LOG_FILE_KEEP), size(0), lastTime(-1) {timeText[0] = '\0';}
+	~LogFile() {close();}
+
+	// Open for appending
+	bool open(const std::string& filePath, size_t fileSize = LOG_FILE_SIZE, int oldFiles = LOG_FILE_KEEP);
+	void close();
+
+	bool isOpen() const {return file != NULL;}
+
+	// Write lines, plus a line about lines dropped before them
+	bool write(const std::vector<LogEntry>& lines, unsigned long dropped = 0);
+};
+
+
+#endif
@@ -0,0 +1,180 @@
+/**
+ * -----------------------------------------------------
+ * File        logqueue.cpp
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+// c++ libs
+#if defined(_WIN32)
+	#include <windows.h>
+#endif
+
+// Project
+#include "logqueue.h"
+
+
+
+// Lines to the log panel
+LogQueue log_queue;
+
+
+
+// Atomics: the exchanges are full barriers, loads acquire and stores release.
+// MSVC gives volatile accesses these semantics already
+#if defined(_WIN32)
+	static LogNode* exchangeNode(LogNode* volatile* target, LogNode* value)
+	{
+		return (LogNode*)InterlockedExchangePointer((PVOID volatile*)target, value);
+	}
+
+	static long exchangeLong(volatile long* target, long value)
+	{
+		return InterlockedExchange(target, value);
+	}
+
+	static LogNode* loadNode(LogNode* volatile* target) {return *target;}
+	static void storeNode(LogNode* volatile* target, LogNode* value) {*target = value;}
+#else
+	static LogNode* exchangeNode(LogNode* volatile* target, LogNode* value)
+	{
+		return __atomic_exchange_n(target, value, __ATOMIC_ACQ_REL);
+	}
+
+	static long exchangeLong(volatile long* target, long value)
+	{
+		return __atomic_exchange_n(target, value, __ATOMIC_ACQ_REL);
+	}
+
+	static LogNode* loadNode(LogNode* volatile* target) {return __atomic_load_n(target, __ATOMIC_ACQUIRE);}
+	static void storeNode(LogNode* volatile* target, LogNode* value) {__atomic_store_n(target, value, __ATOMIC_RELEASE);}
+#endif
+
+
+
+// Init. the queue with the stub
+LogQueue::LogQueue()
+{
+	head = &stub;
+	tail = &stub;
+
+	pending = 0;
+}
+
+
+// Delete what wasn't taken
+LogQueue::~LogQueue()
+{
+	LogEntry entry;
+
+	while (pop(entry));
+}
+
+
+
+// Any thread: add a line
+bool LogQueue::push(const LogEntry& entry)
+{
+	LogNode* node = new LogNode();
+
+	node->entry = entry;
+
+	pushNode(node);
+
+	// After the link, so a drain started since sees the line
+	return exchangeLong(&pending, 1) == 0;
+}
+
+
+// Swap in a node as the head, then link it behind the old one
+void LogQueue::pushNode(LogNode* node)
+{
+	storeNode(&node->next, NULL);
+
+	LogNode* previous = exchangeNode(&head, node);
+
+	storeNode(&previous->next, node);
+}
+
+
+
+// Consumer: a drain starts
+void LogQueue::startDrain()
+{
+	exchangeLong(&pending, 0);
+}
+
+
+// Consumer: take the oldest line
+bool LogQueue::pop(LogEntry& entry)
+{
+	LogNode* current = tail;
+	LogNode* next = loadNode(&current->next);
+
+	// Step over the stub
+	if (current == &stub)
+	{
+		if (next == NULL)
+		{
+			return false;
+		}
+
+		tail = next;
+		current = next;
+		next = loadNode(&next->next);
+	}
+
+	// Not the newest, so it can go
+	if (next != NULL)
+	{
+		tail = next;
+	}
+	else
+	{
+		// A producer is between its exchange and its link
+		if (current != loadNode(&head))
+		{
+			return false;
+		}
+
+		// The newest node can only go with the stub behind it
+		pushNode(&stub);
+
+		next = loadNode(&current->next);
+
+		if (next == NULL)
+		{
+			return false;
+		}
+
+		tail = next;
+	}
+
+	entry.time = current->entry.time;
+	entry.level = current->entry.level;
+	entry.category = current->entry.category;
+	entry.text.swap(current->entry.text);
+	entry.fields.swap(current->entry.fields);
+
+	delete current;
+
+	return true;
+}
@@ -0,0 +1,106 @@
+#ifndef LOGQUEUE_H
+#define LOGQUEUE_H
+
+/**
+ * -----------------------------------------------------
+ * File        logqueue.h
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#pragma once
+
+
+// c++ libs
+#include <string>
+
+// Project
+#include "logring.h"
+
+
+
+// Lines taken from the queue per idle event
+#define LOG_DRAIN_BATCH 500
+
+
+// A queued line
+struct LogNode
+{
+	LogNode* volatile next;
+
+	LogEntry entry;
+
+	LogNode() : next(NULL) {}
+};
+
+
+
+// Lines logged by any thread, on their way to the UI thread
+//
+// Many threads add, only the UI thread takes. Adding never blocks: the
+// new node is swapped in as the head with one atomic exchange, then linked
+// behind the one before it. Taking walks from the oldest node on. If a
+// thread is between its exchange and its link, the lines behind it wait
+// for the next drain.
+//
+// The first line after a drain asks the caller to wake the UI thread, the
+// ones following it don't.
+class LogQueue
+{
+private:
+	// Newest node, swapped by the producers
+	LogNode* volatile head;
+
+	// Oldest node, only used by the consumer
+	LogNode* tail;
+
+	// Stays in the queue, so it's never empty
+	LogNode stub;
+
+	// Lines since the consumer last started to drain
+	volatile long pending;
+
+	void pushNode(LogNode* node);
+
+	// No copies
+	LogQueue(const LogQueue&);
+	LogQueue& operator=(const LogQueue&);
+
+public:
+	LogQueue();
+	~LogQueue();
+
+	// Any thread: add a line, true if the consumer should be woken
+	bool push(const LogEntry& entry);
+
+	// Consumer: call before taking lines, so the next push wakes it again
+	void startDrain();
+
+	// Consumer: take the oldest line, false if there is none
+	bool pop(LogEntry& entry);
+};
+
+
+
+// Lines to the log panel
+extern LogQueue log_queue;
+
+
+#endif
@@ -0,0 +1,148 @@
+/**
+ * -----------------------------------------------------
+ * File        logring.cpp
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+// Project
+#include "logring.h"
+
+
+
+// Lines of the log
+LogRing log_ring(LOG_CAPACITY);
+
+
+// Levels per category
+int logLevels[LOG_CATEGORY_COUNT] = {LOG_LEVEL_INFO, LOG_LEVEL_INFO, LOG_LEVEL_INFO, LOG_LEVEL_INFO, LOG_LEVEL_INFO, LOG_LEVEL_INFO};
+
+
+// Names of the levels and categories
+static const char* levelNames[LOG_LEVEL_COUNT] = {"debug", "info", "warning", "error"};
+static const char* categoryNames[LOG_CATEGORY_COUNT] = {"app", "net", "parse", "steam", "ui", "update"};
+
+
+
+// Name of a level
+const char* getLogLevelName(LOG_LEVEL level)
+{
+	return (level >= 0 && level < LOG_LEVEL_COUNT) ? levelNames[level] : "";
+}
+
+
+// Name of a category
+const char* getLogCategoryName(LOG_CATEGORY category)
+{
+	return (category >= 0 && category < LOG_CATEGORY_COUNT) ? categoryNames[category] : "";
+}
+
+
+// Category of a name
+LOG_CATEGORY getLogCategory(const std::string& name)
+{
+	for (int i=0; i < LOG_CATEGORY_COUNT; i++)
+	{
+		if (name == categoryNames[i])
+		{
+			return (LOG_CATEGORY)i;
+		}
+	}
+
+	return LOG_CATEGORY_COUNT;
+}
+
+
+
+// Add a line
+void LogRing::add(const LogEntry& entry)
+{
+	if (entries.empty())
+	{
+		return;
+	}
+
+	size_t slot;
+
+	if (count < entries.size())
+	{
+		slot = (first + count) % entries.size();
+		count++;
+	}
+	else
+	{
+		// Full, the oldest makes room
+		slot = first;
+		first = (first + 1) % entries.size();
+	}
+
+	// Assigning keeps the memory of the slot
+	entries[slot].time = entry.time;
+	entries[slot].level = entry.level;
+	entries[slot].category = entry.category;
+	entries[slot].text.assign(entry.text);
+	entries[slot].fields.assign(entry.fields);
+
+	total++;
+}
+
+
+
+// Add a field
+void LogEntry::addField(const char* key, const std::string& value)
+{
+	fields += ' ';
+	fields += key;
+	fields += '=';
+
+	if (!value.empty() && value.find_first_of(LOG_QUOTED) == std::string::npos)
+	{
+		fields += value;
+
+		return;
+	}
+
+	fields += '"';
+
+	// A line stays a line
+	for (size_t i=0; i < value.size(); i++)
+	{
+		if (value[i] == '\n')
+		{
+			fields += "\\n";
+		}
+		else if (value[i] == '\r')
+		{
+			fields += "\\r";
+		}
+		else
+		{
+			if (value[i] == '"' || value[i] == '\\')
+			{
+				fields += '\\';
+			}
+
+			fields += value[i];
+		}
+	}
+
+	fields += '"';
+}
@@ -0,0 +1,153 @@
+#ifndef LOGRING_H
+#define LOGRING_H
+
+/**
+ * -----------------------------------------------------
+ * File        logring.h
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#pragma once
+
+
+// c++ libs
+#include <string>
+#include <vector>
+
+
+
+// Log lines kept for the log panel
+#define LOG_CAPACITY 10000
+
+// Values of fields in quotes if they have one of these
+#define LOG_QUOTED " \t\r\n\"=\\"
+
+
+
+// How important a line is
+enum LOG_LEVEL
+{
+	LOG_LEVEL_DEBUG = 0,
+	LOG_LEVEL_INFO,
+	LOG_LEVEL_WARNING,
+	LOG_LEVEL_ERROR,
+
+	LOG_LEVEL_COUNT
+};
+
+
+// What a line is about
+enum LOG_CATEGORY
+{
+	LOG_CATEGORY_APP = 0,
+	LOG_CATEGORY_NET,
+	LOG_CATEGORY_PARSE,
+	LOG_CATEGORY_STEAM,
+	LOG_CATEGORY_UI,
+	LOG_CATEGORY_UPDATE,
+
+	LOG_CATEGORY_COUNT
+};
+
+
+
+// Lowest level logged per category, LOG_LEVEL_INFO at first
+extern int logLevels[LOG_CATEGORY_COUNT];
+
+// Read a lot, so only an array lookup
+inline bool isLogged(LOG_CATEGORY category, LOG_LEVEL level) {return level >= logLevels[category];}
+
+// What follows is only evaluated if the line is logged
+#define LOG_IF(category, level) if (!isLogged(category, level)) {} else
+
+// Names, as the log shows them
+const char* getLogLevelName(LOG_LEVEL level);
+const char* getLogCategoryName(LOG_CATEGORY category);
+
+// Category of a name, LOG_CATEGORY_COUNT if there is none
+LOG_CATEGORY getLogCategory(const std::string& name);
+
+
+
+// A line of the log
+struct LogEntry
+{
+	// Unix time
+	long time;
+
+	LOG_LEVEL level;
+	LOG_CATEGORY category;
+
+	// Message, and its fields as " key=value" each
+	std::string text;
+	std::string fields;
+
+	LogEntry() : time(0), level(LOG_LEVEL_INFO), category(LOG_CATEGORY_APP) {}
+	LogEntry(long lineTime, LOG_LEVEL lineLevel, LOG_CATEGORY lineCategory, const std::string& lineText) : time(lineTime), level(lineLevel), category(lineCategory), text(lineText) {}
+
+	// Add a field, the value is quoted if it has to be
+	void addField(const char* key, const std::string& value);
+};
+
+
+
+// The newest lines of the log
+//
+// A fixed number of entries used as a ring: when it's full a new line
+// takes the place of the oldest one. The slots are reused, so once their
+// strings have grown, adding a line allocates nothing.
+class LogRing
+{
+private:
+	std::vector<LogEntry> entries;
+
+	// Slot of the oldest line, lines in the ring
+	size_t first;
+	size_t count;
+
+	// Lines ever added
+	unsigned long long total;
+
+public:
+	LogRing(size_t capacity) : entries(capacity), first(0), count(0), total(0) {}
+
+	// Add a line, the oldest is dropped if it's full
+	void add(const LogEntry& entry);
+
+	void clear() {first = count = 0;}
+
+	size_t getCount() const {return count;}
+	size_t getCapacity() const {return entries.size();}
+
+	// Lines ever added, tells how far the ring moved on
+	unsigned long long getTotal() const {return total;}
+
+	// Line by age, 0 is the oldest
+	const LogEntry& get(size_t number) const {return entries[(first + number) % entries.size()];}
+};
+
+
+
+// Lines of the log
+extern LogRing log_ring;
+
+
+#endif
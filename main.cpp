@@ -25,6 +25,7 @@
 
 // c++ lib
 #include <sstream>
+#include <time.h>
 
 
 // Include Project
@@ -32,9 +33,15 @@
 #include "log.h"
 #include "about.h"
 #include "trackers.h"
+#include "search.h"
+#include "statistics.h"
 #include "taskbar.h"
 #include "config.h"
 #include "calladmin-client.h"
+#include "resources.h"
+#include "history.h"
+#include "callindex.h"
+#include "callstats.h"
 
 
 // Wx
@@ -65,7 +72,9 @@ BEGIN_EVENT_TABLE(MainDialog, wxDialog)
 	EVT_CLOSE(MainDialog::OnCloseWindow)
 	EVT_ICONIZE(MainDialog::OnMinimizeWindow)
 
-	EVT_LISTBOX_DCLICK(wxID_BoxClick, MainDialog::OnBoxClick)
+	EVT_LIST_ITEM_ACTIVATED(wxID_BoxClick, MainDialog::OnBoxClick)
+	EVT_LIST_ITEM_SELECTED(wxID_BoxClick, MainDialog::OnBoxSelect)
+	EVT_CHOICE(wxID_ViewChange, MainDialog::OnViewChange)
 END_EVENT_TABLE()
 
 
@@ -105,16 +114,33 @@ void MainDialog::createWindow(bool taskbar)
 	sizerBody = new wxBoxSizer(wxHORIZONTAL);
 
 	// Box Body
-	wxStaticBoxSizer* sizerBox = new wxStaticBoxSizer(new wxStaticBox(panel, wxID_ANY, wxT("Latest Calls")), wxHORIZONTAL);
+	wxStaticBoxSizer* sizerBox = new wxStaticBoxSizer(new wxStaticBox(panel, wxID_ANY, wxT("Latest Calls")), wxVERTICAL);
+
+
+	// Order of the calls, same order as CALL_VIEW
+	wxString views[] = {"Oldest first", "Newest first", "Unhandled only", "Unhandled first", "By server", "By target"};
+
+	viewChoice = new wxChoice(panel, wxID_ViewChange, wxDefaultPosition, wxSize(280, -1), CALL_VIEWS, views);
+
+	CALL_VIEW view = (CALL_VIEW)g_config->ReadLong("view", (long)CALL_VIEW_OLDEST);
+
+	if (view < 0 || view >= CALL_VIEWS)
+	{
+		view = CALL_VIEW_OLDEST;
+	}
+
+	viewChoice->SetSelection(view);
 
 
 	// Box for all Calls
-	callBox = new wxListBox(panel, wxID_BoxClick, wxDefaultPosition, wxSize(280, -1), 0, NULL, wxLB_HSCROLL | wxLB_SINGLE);
+	callBox = new CallListCtrl(panel, wxID_BoxClick, wxSize(400, -1));
 	callBox->SetFont(wxFont(9, FONT_FAMILY, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+	callBox->setView(view);
 
 
 	// Add to Body
-	sizerBox->Add(callBox, 0, wxEXPAND | wxALL, 5);
+	sizerBox->Add(viewChoice, 0, wxEXPAND | wxALL, 5);
+	sizerBox->Add(callBox, 1, wxEXPAND | wxALL, 5);
 	sizerBody->Add(sizerBox, 0, wxEXPAND | wxALL, 5);
 	
 
@@ -302,6 +328,12 @@ void MainDialog::createWindow(bool taskbar)
 	// Add trackers Page
 	notebook->AddPage(new TrackerPanel(notebook), ("Trackers"));
 
+	// Add search Page
+	notebook->AddPage(new SearchPanel(notebook), ("Search"));
+
+	// Add statistics Page
+	notebook->AddPage(new StatisticsPanel(notebook), ("Statistics"));
+
 	// Add Log Page
 	notebook->AddPage(new LogPanel(notebook), ("Logging"));
 
@@ -311,7 +343,7 @@ void MainDialog::createWindow(bool taskbar)
 
 
 	// Log Action
-	LogAction("Start the main Window");
+	LOG(LOG_CATEGORY_UI, LOG_LEVEL_INFO, "Start the main Window");
 
 
 	// Start in taskbar
@@ -329,13 +361,7 @@ void MainDialog::createWindow(bool taskbar)
 
 
 	// Set the Icon
-	#if defined(__WXMSW__)
-		SetIcon(wxIcon("calladmin_icon", wxBITMAP_TYPE_ICO_RESOURCE));
-	#else
-		wxLogNull nolog;
-
-		SetIcon(wxIcon(getAppPath("resources/calladmin_icon.ico"), wxBITMAP_TYPE_ICON));
-	#endif
+	SetIcon(getResourceIcon("calladmin_icon"));
 
 	// Fit Notebook
 	notebook->Fit();
@@ -360,7 +386,7 @@ void MainDialog::createWindow(bool taskbar)
 void MainDialog::OnHide(wxCommandEvent& WXUNUSED(event))
 {
 	// Log Action
-	LogAction("Hided Window");
+	LOG(LOG_CATEGORY_UI, LOG_LEVEL_DEBUG, "Hid the Window");
 
 	if (m_taskBarIcon != NULL)
 	{
@@ -391,7 +417,7 @@ void MainDialog::OnCheckBox(wxCommandEvent& WXUNUSED(event))
 void MainDialog::OnReconnect(wxCommandEvent& WXUNUSED(event))
 {
 	// Log Action
-	LogAction("Reconnecting...");
+	LOG(LOG_CATEGORY_NET, LOG_LEVEL_INFO, "Reconnecting");
 
 	// Reset attempts
 	attempts = 0;
@@ -412,6 +438,34 @@ void MainDialog::OnReconnect(wxCommandEvent& WXUNUSED(event))
 
 
 
+// A call was handled
+void MainDialog::setHandled(CallHandle item)
+{
+	CallRecord* record = call_store.get(item);
+
+	// Unknown or already handled
+	if (record == NULL || record->handled)
+	{
+		return;
+	}
+
+	long handledAt = (long)time(0);
+
+	// The call list is told by the store
+	call_store.setHandled(item);
+
+	call_history.appendHandled(*record, handledAt);
+	call_index.setHandled(*record);
+	call_stats.addHandled(*record, handledAt);
+
+	if (record->dialog != NULL)
+	{
+		record->dialog->setFinish();
+	}
+}
+
+
+
 // Thread Handled -> Call Function
 void MainDialog::OnThread(wxCommandEvent& event)
 {
@@ -455,18 +509,46 @@ void MainDialog::OnSteamChange(wxCommandEvent& event)
 
 
 // Window Event -> Open Call
-void MainDialog::OnBoxClick(wxCommandEvent& WXUNUSED(event))
+void MainDialog::OnBoxClick(wxListEvent& event)
 {
-	int selection = callBox->GetSelection();
+	CallHandle id = callBox->getCall(event.GetIndex());
 
-	if (call_dialogs != NULL && call_dialogs[selection] != NULL)
+	if (id != INVALID_CALL)
 	{
-		call_dialogs[selection]->Show(true);
-		call_dialogs[selection]->Restore();
+		showCall(id);
 	}
 }
 
 
+// Window Event -> Show the selected call in the call window
+void MainDialog::OnBoxSelect(wxListEvent& event)
+{
+	// Only what the user selects
+	if (callBox->isRestoring())
+	{
+		return;
+	}
+
+	CallHandle id = callBox->getCall(event.GetIndex());
+
+	if (id != INVALID_CALL)
+	{
+		selectCall(id);
+	}
+}
+
+
+// Choice Event -> Other order of the calls
+void MainDialog::OnViewChange(wxCommandEvent& WXUNUSED(event))
+{
+	CALL_VIEW view = (CALL_VIEW)viewChoice->GetSelection();
+
+	g_config->Write("view", (long)view);
+
+	callBox->setView(view);
+}
+
+
 // Window Event -> exit programm
 void MainDialog::OnCloseWindow(wxCloseEvent& WXUNUSED(event))
 {
@@ -481,7 +563,7 @@ void MainDialog::OnMinimizeWindow(wxIconizeEvent& WXUNUSED(event))
 	if (hideOnMinimize)
 	{
 		// Log Action
-		LogAction("Hided Window");
+		LOG(LOG_CATEGORY_UI, LOG_LEVEL_DEBUG, "Hid the Window");
 
 		if (m_taskBarIcon != NULL)
 		{
@@ -495,32 +577,3 @@ void MainDialog::OnMinimizeWindow(wxIconizeEvent& WXUNUSED(event))
 		}
 	}
 }
-
-
-
-// Update Call List
-void MainDialog::updateCall()
-{
-	callBox->Clear();
-
-	for (int i=0; i < MAXCALLS; i++)
-	{
-		if (call_dialogs != NULL && call_dialogs[i] != NULL)
-		{
-			int item;
-
-			
-			if (call_dialogs[i]->getHandled())
-			{
-				item = callBox->Append("F - " + wxString::FromUTF8(call_dialogs[i]->getBoxText()));
-			}
-			else
-			{
-				item = callBox->Append("U - " + wxString::FromUTF8(call_dialogs[i]->getBoxText()));
-			}
-			
-
-			callBox->SetSelection(item);
-		}
-	}
-}
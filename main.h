@@ -37,8 +37,10 @@
 #endif
 
 #include <wx/listbox.h>
+#include <wx/choice.h>
 #include <wx/notebook.h>
 #include "call.h"
+#include "calllist.h"
 
 // Main Notebook
 extern wxNotebook* notebook;
@@ -52,6 +54,7 @@ enum
 	wxID_Hide = wxID_HIGHEST+100,
 	wxID_Reconnect,
 	wxID_BoxClick,
+	wxID_ViewChange,
 	wxID_CheckBox,
 	wxID_SteamChanged,
 	wxID_ThreadHandled,
@@ -72,7 +75,8 @@ private:
 
 	wxPanel *panel;
 
-	wxListBox* callBox;
+	CallListCtrl* callBox;
+	wxChoice* viewChoice;
 	wxSizer* sizerBody;
 
 	wxStaticText* eventText;
@@ -88,6 +92,7 @@ public:
 		reconnectButton = NULL;
 		panel = NULL;
 		callBox = NULL;
+		viewChoice = NULL;
 		sizerBody = NULL;
 		eventText = NULL;
 		steamText = NULL;
@@ -108,14 +113,10 @@ public:
 	void setSteamStatus(wxString text, wxColor color) {steamText->SetLabelText(text); steamText->SetForegroundColour(color); sizerBody->Layout(); panel->SetSizerAndFit(sizerBody, false); notebook->Fit(); Fit();}
 
 	// Update Call list
-	void updateCall();
-	void resetCalls() {callBox->Clear();}
-	void setHandled(int item)
-	{
-		callBox->SetString(item, "F - " + wxString::FromUTF8(call_dialogs[item]->getBoxText()));
-		call_dialogs[item]->setFinish();
-		call_dialogs[item]->takeover->Enable(false);
-	}
+	void updateCall() {callBox->update();}
+
+	// A call was handled: store, history and statistics learn it once
+	void setHandled(CallHandle item);
 
 
 protected:
@@ -125,7 +126,9 @@ protected:
 
 	void OnCloseWindow(wxCloseEvent& event);
 	void OnMinimizeWindow(wxIconizeEvent& event);
-	void OnBoxClick(wxCommandEvent& event);
+	void OnBoxClick(wxListEvent& event);
+	void OnBoxSelect(wxListEvent& event);
+	void OnViewChange(wxCommandEvent& event);
 
 	void OnCheckBox(wxCommandEvent& event);
 	void OnSteamChange(wxCommandEvent& event);
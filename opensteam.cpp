@@ -22,12 +22,23 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>
  */
 
+// c++ libs
+#include <ctime>
+#include <vector>
+#include <algorithm>
+
+// Avatar cache
+#include <wx/stdpaths.h>
+#include <wx/filename.h>
+
+// Project
 #include "opensteam.h"
 #include "main.h"
 #include "log.h"
 #include "trackers.h"
 #include "config.h"
 #include "calladmin-client.h"
+#include "resources.h"
 
 
 // Alloca
@@ -60,6 +71,48 @@ ISteamUtils006* steamUtils = NULL;
 steamThread *steamThreader = NULL;
 
 
+// Cached avatars
+std::map<unsigned long long, long> avatarCache;
+
+
+
+// File of a cached avatar
+wxString getAvatarPath(unsigned long long steamID)
+{
+	wxString separator = wxFileName::GetPathSeparator();
+
+	return wxStandardPaths::Get().GetUserDataDir() + separator + "avatars" + separator + wxString::Format("%" wxLongLongFmtSpec "u.bmp", steamID);
+}
+
+
+// Delete the oldest avatars above the limit
+void pruneAvatarCache(size_t keep)
+{
+	if (avatarCache.size() <= keep)
+	{
+		return;
+	}
+
+	// Newest first
+	std::vector<std::pair<long, unsigned long long> > avatars;
+
+	for (std::map<unsigned long long, long>::iterator it = avatarCache.begin(); it != avatarCache.end(); ++it)
+	{
+		avatars.push_back(std::make_pair(-it->second, it->first));
+	}
+
+	std::sort(avatars.begin(), avatars.end());
+
+	for (size_t i = keep; i < avatars.size(); i++)
+	{
+		wxRemoveFile(getAvatarPath(avatars[i].second));
+
+		avatarCache.erase(avatars[i].second);
+	}
+}
+
+
+
 // The Thread Class
 steamThread::steamThread() : wxThread(wxTHREAD_DETACHED), loader(CSteamAPILoader::k_ESearchOrderSteamInstallFirst)
 {
@@ -199,7 +252,7 @@ void steamThread::checkSteam()
 
 						main_dialog->GetEventHandler()->AddPendingEvent(event);
 
-						LogAction("Disonnected from Steam");
+						LOG(LOG_CATEGORY_STEAM, LOG_LEVEL_WARNING, "Disconnected from Steam");
 					}
 				}
 				else
@@ -235,7 +288,7 @@ void steamThread::checkSteam()
 					main_dialog->GetEventHandler()->AddPendingEvent(event);
 				}
 
-				LogAction("Connected to Steam");
+				LOG(LOG_CATEGORY_STEAM, LOG_LEVEL_INFO, "Connected to Steam");
 
 				steamConnected = true;
 			}
@@ -261,7 +314,7 @@ void steamThread::checkSteam()
 
 						main_dialog->GetEventHandler()->AddPendingEvent(event);
 
-						LogAction("Disonnected from Steam");
+						LOG(LOG_CATEGORY_STEAM, LOG_LEVEL_WARNING, "Disconnected from Steam");
 					}
 
 					steamConnected = false;
@@ -290,7 +343,7 @@ void steamThread::checkSteam()
 
 					main_dialog->GetEventHandler()->AddPendingEvent(event);
 
-					LogAction("Disonnected from Steam");
+					LOG(LOG_CATEGORY_STEAM, LOG_LEVEL_WARNING, "Disconnected from Steam");
 				}
 
 				steamConnected = false;
@@ -368,6 +421,18 @@ AvatarTimer::AvatarTimer(CSteamID *cid, CSteamID *tid, wxStaticBitmap* cAvatar,
 	{
 		targetLoaded = true;
 	}
+
+
+	// Avatars Steam gave in this run are done, the ones of the last run are shown until Steam has them
+	if (!clientLoaded)
+	{
+		clientLoaded = setCachedAvatar(clientsID, clientsAvatar);
+	}
+
+	if (!targetLoaded)
+	{
+		targetLoaded = setCachedAvatar(targetsID, targetsAvatar);
+	}
 }
 
 
@@ -445,16 +510,32 @@ bool AvatarTimer::setAvatar(CSteamID *id, wxStaticBitmap* map)
 					}
 				}
 				
+				// Keep it for the next start, once per run: calls after this one take it from memory
+				unsigned long long steamID = id->ConvertToUint64();
+				wxString path = getAvatarPath(steamID);
+				wxString dir = wxFileName(path).GetPath();
+
+				wxLogNull nolog;
+
+				if ((wxFileName::DirExists(dir) || wxFileName::Mkdir(dir, wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL)) && image.SaveFile(path, wxBITMAP_TYPE_BMP))
+				{
+					avatarCache[steamID] = (long)time(0);
+				}
+
 				if (avatarSize != 184)
 				{
 					image.Rescale(avatarSize, avatarSize);
 				}
 
 				// Set new Avatar
-				map->SetBitmap(wxBitmap(image));
+				wxBitmap bitmap(image);
+
+				setAvatarBitmap(steamID, avatarSize, bitmap, true);
+
+				map->SetBitmap(bitmap);
 
 
-				LogAction("Loaded Avatar of " + (wxString)id->Render());
+				LOG(LOG_CATEGORY_STEAM, LOG_LEVEL_DEBUG, "Loaded Avatar").field("steamid", id->Render());
 
 
 				// It's loaded
@@ -469,6 +550,64 @@ bool AvatarTimer::setAvatar(CSteamID *id, wxStaticBitmap* map)
 
 
 
+// Set the avatar kept in memory, otherwise the one of the last run if it's on disk
+bool AvatarTimer::setCachedAvatar(CSteamID *id, wxStaticBitmap* map)
+{
+	unsigned long long steamID = id->ConvertToUint64();
+
+	bool current = false;
+	const wxBitmap* kept = getAvatarBitmap(steamID, avatarSize, &current);
+
+	if (kept != NULL)
+	{
+		map->SetBitmap(*kept);
+
+		return current;
+	}
+
+
+	std::map<unsigned long long, long>::iterator cached = avatarCache.find(steamID);
+
+	if (cached == avatarCache.end())
+	{
+		return false;
+	}
+
+	// Deleted meanwhile?
+	wxString path = getAvatarPath(steamID);
+
+	if (!wxFileExists(path))
+	{
+		avatarCache.erase(cached);
+
+		return false;
+	}
+
+	wxLogNull nolog;
+
+	wxImage image(path, wxBITMAP_TYPE_BMP);
+
+	if (image.IsOk())
+	{
+		if (image.GetWidth() != avatarSize)
+		{
+			image.Rescale(avatarSize, avatarSize);
+		}
+
+		// Read once, the next calls of the player take it from memory
+		wxBitmap bitmap(image);
+
+		setAvatarBitmap(steamID, avatarSize, bitmap, false);
+
+		map->SetBitmap(bitmap);
+	}
+
+	return false;
+}
+
+
+
+
 // Timer to update trackers
 void NameTimer::Notify()
 {
@@ -32,6 +32,7 @@
 #include <wx/wxprec.h>
 
 // c++ libs
+#include <map>
 #include <string>
 
 
@@ -68,6 +69,21 @@ extern ISteamUser016* steamUser;
 extern ISteamUtils006* steamUtils;
 
 
+// Avatars loaded from Steam are kept on disk, so a call shows them before
+// Steam is connected. 64bit SteamID to the time it was loaded
+extern std::map<unsigned long long, long> avatarCache;
+
+// Max. avatars kept on disk
+#define AVATAR_CACHE_MAX 512
+
+// File of a cached avatar
+wxString getAvatarPath(unsigned long long steamID);
+
+// Delete the oldest avatars above the limit
+void pruneAvatarCache(size_t keep);
+
+
+
 enum STEAM_ERROR_TYP
 {
 	STEAM_NO_ERROR = 0,
@@ -127,6 +143,9 @@ public:
 	void startTimer() {Start(100);}
 	bool setAvatar(CSteamID *id, wxStaticBitmap* map);
 
+	// Show the avatar kept in memory or on disk, true if Steam gave it in this run
+	bool setCachedAvatar(CSteamID *id, wxStaticBitmap* map);
+
 	void Notify();
 };
 
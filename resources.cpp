@@ -0,0 +1,301 @@
+/**
+ * -----------------------------------------------------
+ * File        resources.cpp
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+// c++ libs
+#include <map>
+#include <utility>
+
+// Include Project
+#include "resources.h"
+#include "calladmin-client.h"
+
+
+// Linux has no resource compiler, the Makefile compiles the files in
+#if defined(EMBED_RESOURCES) && !defined(__WXMSW__)
+	#include <wx/mstream.h>
+
+	// Generated from the resources directory
+	#include "resources/embedded.inc"
+
+
+	// A file of the resources directory
+	struct EmbeddedResource
+	{
+		const char* file;
+
+		const unsigned char* data;
+		unsigned int length;
+	};
+
+	static const EmbeddedResource embedded[] =
+	{
+		{"calladmin_avatar.bmp", resources_calladmin_avatar_bmp, resources_calladmin_avatar_bmp_len},
+		{"calladmin_banner.bmp", resources_calladmin_banner_bmp, resources_calladmin_banner_bmp_len},
+		{"calladmin_icon.ico", resources_calladmin_icon_ico, resources_calladmin_icon_ico_len},
+		{"calladmin_sound.wav", resources_calladmin_sound_wav, resources_calladmin_sound_wav_len}
+	};
+
+
+	// Compiled in file, NULL if there is none
+	static const EmbeddedResource* findEmbedded(const wxString& file)
+	{
+		for (size_t i=0; i < sizeof(embedded) / sizeof(embedded[0]); i++)
+		{
+			if (file == embedded[i].file)
+			{
+				return &embedded[i];
+			}
+		}
+
+		return NULL;
+	}
+
+
+	// Decode a compiled in image
+	static wxImage readEmbedded(const wxString& file, wxBitmapType type)
+	{
+		const EmbeddedResource* resource = findEmbedded(file);
+
+		if (resource == NULL)
+		{
+			return wxImage();
+		}
+
+		wxMemoryInputStream stream(resource->data, resource->length);
+
+		return wxImage(stream, type);
+	}
+#endif
+
+
+
+// Decoded images by name and size, 0 is the size of the file
+static std::map<std::pair<wxString, int>, wxBitmap> bitmaps;
+
+// Icons by name
+static std::map<wxString, wxIcon> icons;
+
+// Sounds by name
+static std::map<wxString, wxSound*> sounds;
+
+
+// A decoded avatar
+struct AvatarBitmap
+{
+	wxBitmap bitmap;
+	bool current;
+
+	// Use it was last needed for
+	unsigned long used;
+
+	AvatarBitmap() : current(false), used(0) {}
+};
+
+// Avatars by SteamID and size, and uses so far
+static std::map<std::pair<unsigned long long, int>, AvatarBitmap> avatars;
+static unsigned long avatarUses = 0;
+
+
+
+// Image in a size
+const wxBitmap& getResourceBitmap(const wxString& name, int size)
+{
+	std::pair<wxString, int> key(name, size);
+
+	std::map<std::pair<wxString, int>, wxBitmap>::iterator it = bitmaps.find(key);
+
+	if (it != bitmaps.end())
+	{
+		return it->second;
+	}
+
+
+	// The image itself is only read once, other sizes are scaled from it
+	wxBitmap& bitmap = bitmaps[key];
+
+	if (size > 0)
+	{
+		wxImage image = getResourceBitmap(name).ConvertToImage();
+
+		if (image.IsOk())
+		{
+			bitmap = wxBitmap(image.Rescale(size, size));
+		}
+
+		return bitmap;
+	}
+
+	#if defined(__WXMSW__)
+		wxImage image(name, wxBITMAP_TYPE_RESOURCE);
+	#elif defined(EMBED_RESOURCES)
+		wxImage image = readEmbedded(name + ".bmp", wxBITMAP_TYPE_BMP);
+	#else
+		wxImage image(getAppPath("resources/" + name + ".bmp"));
+	#endif
+
+	if (image.IsOk())
+	{
+		bitmap = wxBitmap(image);
+	}
+
+	return bitmap;
+}
+
+
+
+// Icon of a .ico resource
+const wxIcon& getResourceIcon(const wxString& name)
+{
+	std::map<wxString, wxIcon>::iterator it = icons.find(name);
+
+	if (it != icons.end())
+	{
+		return it->second;
+	}
+
+	wxIcon& icon = icons[name];
+
+	#if defined(__WXMSW__)
+		icon = wxIcon(name, wxBITMAP_TYPE_ICO_RESOURCE);
+	#elif defined(EMBED_RESOURCES)
+		// Only BMP is known without asking
+		if (wxImage::FindHandler(wxBITMAP_TYPE_ICO) == NULL)
+		{
+			wxImage::AddHandler(new wxICOHandler);
+		}
+
+		wxImage image = readEmbedded(name + ".ico", wxBITMAP_TYPE_ICO);
+
+		if (image.IsOk())
+		{
+			icon.CopyFromBitmap(wxBitmap(image));
+		}
+	#else
+		wxLogNull nolog;
+
+		icon = wxIcon(getAppPath("resources/" + name + ".ico"), wxBITMAP_TYPE_ICON);
+	#endif
+
+	return icon;
+}
+
+
+
+// Sound of a .wav resource
+wxSound* getResourceSound(const wxString& name)
+{
+	std::map<wxString, wxSound*>::iterator it = sounds.find(name);
+
+	if (it != sounds.end())
+	{
+		return it->second;
+	}
+
+	wxSound* sound;
+
+	#if defined(__WXMSW__)
+		sound = new wxSound(name, true);
+	#elif defined(EMBED_RESOURCES)
+		const EmbeddedResource* resource = findEmbedded(name + ".wav");
+
+		sound = (resource != NULL) ? new wxSound(resource->length, resource->data) : NULL;
+	#else
+		wxLogNull nolog;
+
+		sound = new wxSound(getAppPath("resources/" + name + ".wav"), false);
+	#endif
+
+	sounds[name] = sound;
+
+	return sound;
+}
+
+
+
+// Avatar of a player
+const wxBitmap* getAvatarBitmap(unsigned long long steamID, int size, bool* current)
+{
+	std::map<std::pair<unsigned long long, int>, AvatarBitmap>::iterator it = avatars.find(std::make_pair(steamID, size));
+
+	if (it == avatars.end())
+	{
+		return NULL;
+	}
+
+	it->second.used = ++avatarUses;
+
+	if (current != NULL)
+	{
+		*current = it->second.current;
+	}
+
+	return &it->second.bitmap;
+}
+
+
+// Keep the avatar of a player
+void setAvatarBitmap(unsigned long long steamID, int size, const wxBitmap& bitmap, bool current)
+{
+	AvatarBitmap& avatar = avatars[std::make_pair(steamID, size)];
+
+	avatar.bitmap = bitmap;
+	avatar.current = current;
+	avatar.used = ++avatarUses;
+
+	if (avatars.size() <= AVATAR_BITMAPS)
+	{
+		return;
+	}
+
+	// Too many, let the one used longest ago go
+	std::map<std::pair<unsigned long long, int>, AvatarBitmap>::iterator oldest = avatars.begin();
+
+	for (std::map<std::pair<unsigned long long, int>, AvatarBitmap>::iterator it = avatars.begin(); it != avatars.end(); ++it)
+	{
+		if (it->second.used < oldest->second.used)
+		{
+			oldest = it;
+		}
+	}
+
+	avatars.erase(oldest);
+}
+
+
+
+// Let the cached images go
+void clearResources()
+{
+	bitmaps.clear();
+	icons.clear();
+	avatars.clear();
+
+	for (std::map<wxString, wxSound*>::iterator it = sounds.begin(); it != sounds.end(); ++it)
+	{
+		delete it->second;
+	}
+
+	sounds.clear();
+}
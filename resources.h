@@ -0,0 +1,80 @@
+#ifndef RESOURCES_H
+#define RESOURCES_H
+
+/**
+ * -----------------------------------------------------
+ * File        resources.h
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#pragma once
+
+
+// Precomp Header
+#include <wx/wxprec.h>
+
+// We need WX
+#ifndef WX_PRECOMP
+	#include <wx/wx.h>
+#endif
+
+#include <wx/sound.h>
+
+
+
+// Images and icons of the client
+//
+// Each is read and decoded once, and each size of an image is scaled once.
+// Bitmaps and icons share their data when copied, so every dialog using
+// them holds a reference, not a copy. Only for the UI thread.
+//
+// The name is the name of the Windows resource. On other systems it's the
+// file of that name in the resources directory, which the Makefile compiles
+// into the binary with EMBED_RESOURCES: then nothing is read from disk and
+// the client runs from anywhere.
+
+// Image in its own size, or scaled to size x size
+const wxBitmap& getResourceBitmap(const wxString& name, int size = 0);
+
+// Icon of .ico resource
+const wxIcon& getResourceIcon(const wxString& name);
+
+// Sound of a .wav resource, NULL if there is none
+wxSound* getResourceSound(const wxString& name);
+
+
+
+// Avatars kept decoded at most, the ones used longest ago are let go
+#define AVATAR_BITMAPS 128
+
+// Avatars of players by 64bit SteamID, scaled to size x size
+//
+// current tells whether it came from Steam in this run, or from the disk
+// cache of an earlier one. The bitmap returned is only valid until the
+// next avatar is set, it's NULL if there is none.
+const wxBitmap* getAvatarBitmap(unsigned long long steamID, int size, bool* current = NULL);
+void setAvatarBitmap(unsigned long long steamID, int size, const wxBitmap& bitmap, bool current);
+
+// Let the cached images go, at the end
+void clearResources();
+
+
+#endif
@@ -0,0 +1,198 @@
+/**
+ * -----------------------------------------------------
+ * File        search.cpp
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+// c++ libs
+#include <ctime>
+#include <string>
+
+
+// Include Project
+#include "search.h"
+#include "call.h"
+#include "main.h"
+#include "log.h"
+#include "history.h"
+#include "callindex.h"
+#include "calladmin-client.h"
+
+
+// Wx
+#include <wx/stopwatch.h>
+
+
+
+// ID's for Search Panel
+enum
+{
+	wxID_SearchText = wxID_HIGHEST+900,
+	wxID_SearchResults,
+};
+
+
+// Events for Search Panel
+BEGIN_EVENT_TABLE(SearchPanel, wxPanel)
+	EVT_TEXT(wxID_SearchText, SearchPanel::OnSearch)
+	EVT_LISTBOX_DCLICK(wxID_SearchResults, SearchPanel::OnOpen)
+END_EVENT_TABLE()
+
+
+
+// Create Search Panel
+SearchPanel::SearchPanel(wxNotebook* note) : wxPanel(note, wxID_ANY)
+{
+	// Border and Center
+	wxSizerFlags flags;
+
+
+	// Border and Centre
+	flags.Border(wxALL, 10);
+	flags.Centre();
+
+
+	// Create Box
+	wxSizer* const sizerTop = new wxBoxSizer(wxVERTICAL);
+
+
+	// Search Box
+	searchText = new wxTextCtrl(this, wxID_SearchText, "", wxDefaultPosition, wxDefaultSize);
+	searchText->SetToolTip("Server, player, SteamID or reason. All words have to match.");
+
+	sizerTop->Add(searchText, 0, wxEXPAND | wxALL, 5);
+
+
+	// Results
+	resultBox = new wxListBox(this, wxID_SearchResults, wxDefaultPosition, wxDefaultSize, 0, NULL, wxLB_HSCROLL | wxLB_SINGLE);
+	resultBox->SetFont(wxFont(9, FONT_FAMILY, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+
+	sizerTop->Add(resultBox, 1, wxEXPAND | wxALL, 5);
+
+
+	// Result Text
+	resultText = new wxStaticText(this, wxID_ANY, "Search the calls of the history");
+
+	sizerTop->Add(resultText, flags.Align(wxALIGN_CENTER_HORIZONTAL));
+
+
+
+	// Auto Size
+	SetSizerAndFit(sizerTop, true);
+}
+
+
+
+// Text Event -> Search as it's typed
+void SearchPanel::OnSearch(wxCommandEvent& WXUNUSED(event))
+{
+	resultBox->Clear();
+	results.clear();
+
+	std::string query = (std::string)searchText->GetValue().ToUTF8();
+
+	if (query.empty())
+	{
+		resultText->SetLabelText("Search the calls of the history");
+
+		return;
+	}
+
+
+	wxStopWatch watch;
+
+	call_index.search(query, results, SEARCH_MAX_RESULTS);
+
+	long took = watch.Time();
+
+
+	// Show them
+	CallRecord record;
+	wxArrayString items;
+
+	for (size_t i=0; i < results.size(); i++)
+	{
+		if (call_history.read(results[i], record) != HISTORY_CALL)
+		{
+			items.Add("");
+
+			continue;
+		}
+
+		char buffer[80];
+
+		time_t tt = (time_t)record.reportedAt;
+
+		struct tm* dt = localtime(&tt);
+
+		strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M", dt);
+
+		items.Add((wxString)buffer + " - " + getDisplayString(record.serverName) + " - " + getDisplayString(record.targetName) + " (" + getDisplayString(record.targetReason) + ")");
+	}
+
+	resultBox->Append(items);
+
+	resultText->SetLabelText(wxString::Format("%d of %d calls in %ld ms", (int)results.size(), (int)call_index.getCount(), took));
+	Layout();
+}
+
+
+
+// List Event -> Open the call
+void SearchPanel::OnOpen(wxCommandEvent& WXUNUSED(event))
+{
+	int selection = resultBox->GetSelection();
+
+	if (selection == wxNOT_FOUND || (size_t)selection >= results.size())
+	{
+		return;
+	}
+
+	CallRecord record;
+
+	if (call_history.read(results[selection], record) != HISTORY_CALL)
+	{
+		return;
+	}
+
+	// Its record only has the state it came with
+	record.handled = call_index.isHandled(record);
+
+
+	// Calls which were given up come back into the store, where their time puts them
+	CallHandle id = call_store.find(record);
+
+	if (id == INVALID_CALL)
+	{
+		while (call_store.getCount() > 0 && !call_store.hasRoom(record))
+		{
+			removeCall(call_store.getOldest());
+		}
+
+		id = call_store.add(new CallRecord(record));
+	}
+
+	// Log Action
+	LOG(LOG_CATEGORY_UI, LOG_LEVEL_INFO, "Opened a call of the history").field("call", record.callID);
+
+	showCall(id);
+}
@@ -0,0 +1,75 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+/**
+ * -----------------------------------------------------
+ * File        search.h
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#pragma once
+
+
+// Precomp Header
+#include <wx/wxprec.h>
+
+// c++ libs
+#include <vector>
+
+
+// We need WX
+#ifndef WX_PRECOMP
+#include <wx/wx.h>
+#endif
+
+#include <wx/listbox.h>
+#include <wx/notebook.h>
+
+
+
+// Max. results shown
+#define SEARCH_MAX_RESULTS 500
+
+
+
+// Search Panel Class
+class SearchPanel: public wxPanel
+{
+private:
+	wxTextCtrl* searchText;
+	wxListBox* resultBox;
+	wxStaticText* resultText;
+
+	// History records of the results
+	std::vector<unsigned int> results;
+
+public:
+	SearchPanel(wxNotebook* note);
+
+protected:
+	void OnSearch(wxCommandEvent& event);
+	void OnOpen(wxCommandEvent& event);
+
+	DECLARE_EVENT_TABLE()
+};
+
+
+#endif
@@ -0,0 +1,290 @@
+/**
+ * -----------------------------------------------------
+ * File        snapshot.cpp
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+// c++ libs
+#include <stdio.h>
+#include <string.h>
+
+#if defined(_WIN32)
+	#include <windows.h>
+#endif
+
+// Project
+#include "snapshot.h"
+#include "callindex.h"
+#include "callstats.h"
+#include "codec.h"
+
+
+
+// Size of the magic and of the header: length and checksum
+#define SNAPSHOT_MAGIC_SIZE 4
+#define SNAPSHOT_HEADER 8
+
+// Bigger files are surely not ours
+#define SNAPSHOT_MAX_SIZE (256 * 1024 * 1024)
+
+
+
+// Delete the calls which weren't restored
+void CallSnapshot::clear()
+{
+	for (size_t i=0; i < calls.size(); i++)
+	{
+		delete calls[i];
+	}
+
+	calls.clear();
+	trackers.clear();
+	avatars.clear();
+
+	historyCount = 0;
+	newest = 0;
+}
+
+
+
+// Read a snapshot
+bool CallSnapshot::read(const std::string& path, CallIndex& index, CallStats& stats)
+{
+	clear();
+
+	index.clear();
+	stats.clear();
+
+	FILE* file = fopen(path.c_str(), "rb");
+
+	if (file == NULL)
+	{
+		return false;
+	}
+
+
+	// Header
+	char header[SNAPSHOT_MAGIC_SIZE + SNAPSHOT_HEADER];
+
+	if (fread(header, 1, sizeof(header), file) != sizeof(header) || memcmp(header, SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_SIZE) != 0)
+	{
+		fclose(file);
+
+		return false;
+	}
+
+	size_t length = (size_t)readLittle(header + SNAPSHOT_MAGIC_SIZE, 4);
+	unsigned int sum = (unsigned int)readLittle(header + SNAPSHOT_MAGIC_SIZE + 4, 4);
+
+	if (length > SNAPSHOT_MAX_SIZE)
+	{
+		fclose(file);
+
+		return false;
+	}
+
+
+	// Payload
+	std::string payload(length, '\0');
+
+	bool complete = (length == 0 || fread(&payload[0], 1, length, file) == length);
+
+	fclose(file);
+
+	if (!complete || fnv1a(payload.data(), payload.size()) != sum)
+	{
+		return false;
+	}
+
+	CodecReader reader(payload.data(), payload.size());
+
+	historyCount = (size_t)reader.readVarint();
+	newest = (long)reader.readVarint();
+
+
+	// Calls
+	size_t number = reader.readCount();
+
+	for (size_t i=0; i < number && !reader.hasFailed(); i++)
+	{
+		CallRecord* record = new CallRecord();
+
+		reader.readCall(*record);
+
+		calls.push_back(record);
+	}
+
+
+	// Trackers
+	number = reader.readCount();
+
+	for (size_t i=0; i < number && !reader.hasFailed(); i++)
+	{
+		trackers.push_back(reader.readString());
+	}
+
+
+	// Avatars
+	number = reader.readCount();
+
+	for (size_t i=0; i < number && !reader.hasFailed(); i++)
+	{
+		unsigned long long steamID = reader.readU64();
+
+		avatars.push_back(SnapshotAvatar(steamID, (long)reader.readVarint()));
+	}
+
+
+	// Index and statistics of the records
+	if (reader.hasFailed() || !index.read(reader) || !stats.read(reader) || !reader.atEnd())
+	{
+		clear();
+
+		index.clear();
+		stats.clear();
+
+		return false;
+	}
+
+	return true;
+}
+
+
+
+// Write the snapshot
+bool CallSnapshot::write(const std::string& path, const CallStore& store, const CallIndex& index, const CallStats& stats) const
+{
+	std::string payload;
+
+	writeVarint(payload, historyCount);
+	writeVarint(payload, (unsigned long long)newest);
+
+
+	// Calls, oldest first so they're added in the same order again
+	writeVarint(payload, (unsigned long long)store.getCount());
+
+	for (CallHandle i = store.getFirst(); i != INVALID_CALL; i = store.getNext(i))
+	{
+		writeCall(payload, *store.get(i));
+	}
+
+
+	// Trackers
+	writeVarint(payload, trackers.size());
+
+	for (size_t i=0; i < trackers.size(); i++)
+	{
+		writeString(payload, trackers[i]);
+	}
+
+
+	// Avatars
+	writeVarint(payload, avatars.size());
+
+	for (size_t i=0; i < avatars.size(); i++)
+	{
+		writeLittle(payload, avatars[i].steamID, 8);
+		writeVarint(payload, (unsigned long long)avatars[i].loadedAt);
+	}
+
+
+	// Index and statistics of the records
+	index.write(payload);
+	stats.write(payload);
+
+
+	std::string buffer = SNAPSHOT_MAGIC;
+
+	writeLittle(buffer, payload.size(), 4);
+	writeLittle(buffer, fnv1a(payload.data(), payload.size()), 4);
+
+	buffer += payload;
+
+
+	// Write it next to the old one and replace that, so there is always a complete one
+	std::string temp = path + ".new";
+
+	FILE* file = fopen(temp.c_str(), "wb");
+
+	if (file == NULL)
+	{
+		return false;
+	}
+
+	bool written = (fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size());
+
+	if (fclose(file) != 0 || !written)
+	{
+		remove(temp.c_str());
+
+		return false;
+	}
+
+#if defined(_WIN32)
+	// rename() doesn't replace an existing file on Windows
+	if (!MoveFileExA(temp.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING))
+#else
+	if (rename(temp.c_str(), path.c_str()) != 0)
+#endif
+	{
+		remove(temp.c_str());
+
+		return false;
+	}
+
+	return true;
+}
+
+
+
+// Hand the calls over to the store
+int CallSnapshot::restore(CallStore& store)
+{
+	int added = 0;
+
+	for (size_t i=0; i < calls.size(); i++)
+	{
+		CallRecord* record = calls[i];
+
+		if (store.find(*record) != INVALID_CALL)
+		{
+			delete record;
+
+			continue;
+		}
+
+		// Nothing is shown yet, so the store can give them up directly
+		while (store.getCount() > 0 && !store.hasRoom(*record))
+		{
+			store.remove(store.getOldest());
+		}
+
+		if (store.add(record) != INVALID_CALL)
+		{
+			added++;
+		}
+	}
+
+	calls.clear();
+
+	return added;
+}
@@ -0,0 +1,134 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+/**
+ * -----------------------------------------------------
+ * File        snapshot.h
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#pragma once
+
+
+// c++ libs
+#include <string>
+#include <vector>
+
+// Project
+#include "callstore.h"
+
+
+// Index and statistics kept with it
+class CallIndex;
+class CallStats;
+
+
+
+// Magic of the file
+#define SNAPSHOT_MAGIC "CAS4"
+
+
+
+// An avatar in the cache on disk
+struct SnapshotAvatar
+{
+	// 64bit SteamID
+	unsigned long long steamID;
+
+	// Unix time it was loaded from Steam
+	long loadedAt;
+
+	SnapshotAvatar() : steamID(0), loadedAt(0) {}
+	SnapshotAvatar(unsigned long long id, long at) : steamID(id), loadedAt(at) {}
+};
+
+
+
+// State of the client when it was closed, to start with it the next time
+//
+// The file is written in one go on exit and replaced as a whole:
+//
+//   "CAS4"                          magic
+//   u32     length of the payload
+//   u32     FNV-1a of the payload
+//   payload:
+//     varint  records of the history when it was written
+//     varint  reportedAt of the newest call, where fetching goes on
+//     varint  number of calls, then per call, oldest first, the fields in
+//             the order of the binary API format
+//     varint  number of trackers, then per tracker its line as a string
+//     varint  number of avatars, then per avatar
+//               u64    64bit SteamID
+//               varint time it was loaded
+//     the search index and the statistics of the records of the history,
+//     see CallIndex::write and CallStats::write
+//
+// A file that is cut off or doesn't match its checksum is ignored as a
+// whole. The calls are only worth restoring if the history didn't get new
+// records since, otherwise they're replayed from the history as before.
+// The index and the statistics are always worth it, only the records
+// after historyCount have to be added to them.
+class CallSnapshot
+{
+private:
+	// Calls read, owned until restored
+	std::vector<CallRecord*> calls;
+
+	// No copies
+	CallSnapshot(const CallSnapshot&);
+	CallSnapshot& operator=(const CallSnapshot&);
+
+public:
+	// Records of the history it belongs to
+	size_t historyCount;
+
+	// reportedAt of the newest call, 0 if there is none
+	long newest;
+
+	// Lines of the tracker list, UTF-8
+	std::vector<std::string> trackers;
+
+	// Avatars in the cache
+	std::vector<SnapshotAvatar> avatars;
+
+
+	CallSnapshot() : historyCount(0), newest(0) {}
+	~CallSnapshot() {clear();}
+
+	void clear();
+
+	// Read a snapshot with the index and statistics, false if there is none or it's broken
+	// The index and statistics are empty then
+	bool read(const std::string& path, CallIndex& index, CallStats& stats);
+
+	// Write the snapshot with the calls of the store, the index and statistics
+	bool write(const std::string& path, const CallStore& store, const CallIndex& index, const CallStats& stats) const;
+
+	// Calls read
+	size_t getCallCount() const {return calls.size();}
+
+	// Hand the calls over to the store, the oldest are given up if they don't fit
+	// Returns the calls added
+	int restore(CallStore& store);
+};
+
+
+#endif
@@ -0,0 +1,141 @@
+/**
+ * -----------------------------------------------------
+ * File        statistics.cpp
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+// c++ libs
+#include <string>
+
+
+// Include Project
+#include "statistics.h"
+#include "callstats.h"
+#include "log.h"
+#include "calladmin-client.h"
+
+
+// Wx
+#include <wx/file.h>
+#include <wx/filedlg.h>
+
+
+
+// Button ID's for Statistics Panel
+enum
+{
+	wxID_RefreshStatistics = wxID_HIGHEST+1000,
+	wxID_ExportStatistics,
+};
+
+
+// Button Events for Statistics Panel
+BEGIN_EVENT_TABLE(StatisticsPanel, wxPanel)
+	EVT_BUTTON(wxID_RefreshStatistics, StatisticsPanel::OnRefresh)
+	EVT_BUTTON(wxID_ExportStatistics, StatisticsPanel::OnExport)
+END_EVENT_TABLE()
+
+
+
+// Create Statistics Panel
+StatisticsPanel::StatisticsPanel(wxNotebook* note) : wxPanel(note, wxID_ANY)
+{
+	// Border and Center
+	wxSizerFlags flags;
+
+
+	// Border and Centre
+	flags.Border(wxALL, 10);
+	flags.Centre();
+
+
+	// Create Box
+	wxSizer* const sizerTop = new wxBoxSizer(wxVERTICAL);
+
+
+	// Report
+	reportText = new wxTextCtrl(this, wxID_ANY, "", wxDefaultPosition, wxSize(-1, 300), wxTE_MULTILINE | wxTE_READONLY | wxHSCROLL);
+	reportText->SetFont(wxFont(9, wxFONTFAMILY_TELETYPE, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+
+	sizerTop->Add(reportText, 1, wxEXPAND | wxALL, 5);
+
+
+	wxSizer* const sizerBtns = new wxBoxSizer(wxHORIZONTAL);
+
+	// Refresh and Export Button
+	sizerBtns->Add(new wxButton(this, wxID_RefreshStatistics, "Refresh"), flags.Border(wxALL, 5));
+	sizerBtns->Add(new wxButton(this, wxID_ExportStatistics, "Export"), flags.Border(wxALL, 5));
+
+
+	// Add Buttons to Box
+	sizerTop->Add(sizerBtns, flags.Align(wxALIGN_CENTER_HORIZONTAL));
+
+
+
+	// Auto Size
+	SetSizerAndFit(sizerTop, true);
+
+	updateReport();
+}
+
+
+
+// Show the current statistics, they're always up to date
+void StatisticsPanel::updateReport()
+{
+	reportText->SetValue(wxString::FromUTF8(call_stats.getReport().c_str()));
+}
+
+
+
+// Button Event -> Refresh
+void StatisticsPanel::OnRefresh(wxCommandEvent& WXUNUSED(event))
+{
+	updateReport();
+}
+
+
+
+// Button Event -> Export as CSV
+void StatisticsPanel::OnExport(wxCommandEvent& WXUNUSED(event))
+{
+	wxFileDialog dialog(this, "Export statistics", "", "calladmin-statistics.csv", "CSV files (*.csv)|*.csv", wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
+
+	if (dialog.ShowModal() != wxID_OK)
+	{
+		return;
+	}
+
+	std::string csv = call_stats.getCSV();
+
+	wxFile file(dialog.GetPath(), wxFile::write);
+
+	if (!file.IsOpened() || file.Write(csv.data(), csv.size()) != csv.size())
+	{
+		wxMessageBox("Couldn't write the statistics to " + dialog.GetPath(), "Call Admin", wxOK | wxCENTRE | wxICON_EXCLAMATION);
+
+		return;
+	}
+
+	// Log Action
+	LOG(LOG_CATEGORY_UI, LOG_LEVEL_INFO, "Exported the statistics");
+}
@@ -0,0 +1,64 @@
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+/**
+ * -----------------------------------------------------
+ * File        statistics.h
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#pragma once
+
+
+// Precomp Header
+#include <wx/wxprec.h>
+
+
+// We need WX
+#ifndef WX_PRECOMP
+#include <wx/wx.h>
+#endif
+
+#include <wx/notebook.h>
+
+
+
+// Statistics Panel Class
+class StatisticsPanel: public wxPanel
+{
+private:
+	wxTextCtrl* reportText;
+
+public:
+	StatisticsPanel(wxNotebook* note);
+
+	// Show the current statistics
+	void updateReport();
+
+protected:
+	void OnRefresh(wxCommandEvent& event);
+	void OnExport(wxCommandEvent& event);
+
+	DECLARE_EVENT_TABLE()
+};
+
+
+#endif
@@ -0,0 +1,223 @@
+/**
+ * -----------------------------------------------------
+ * File        stringpool.cpp
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+// Project
+#include "codec.h"
+#include "stringpool.h"
+
+
+
+// Init. the pool
+StringPool::StringPool()
+{
+	count = 0;
+	firstFree = -1;
+	serials = 0;
+	memory = 0;
+
+	rehash();
+}
+
+
+
+// Handle of a text
+StringHandle StringPool::intern(const char* text, size_t length)
+{
+	if (length == 0)
+	{
+		return EMPTY_STRING;
+	}
+
+	unsigned int textHash = fnv1a(text, length);
+	size_t bucket = textHash & (buckets.size() - 1);
+
+
+	// Already known?
+	for (int i = buckets[bucket]; i != -1; i = entries[i].next)
+	{
+		if (entries[i].hash == textHash && entries[i].text.size() == length && memcmp(entries[i].text.data(), text, length) == 0)
+		{
+			entries[i].references++;
+
+			return i;
+		}
+	}
+
+
+	// New entry
+	int entry = firstFree;
+
+	if (entry == -1)
+	{
+		entry = (int)entries.size();
+
+		entries.push_back(Entry());
+	}
+	else
+	{
+		firstFree = entries[entry].next;
+	}
+
+	Entry& added = entries[entry];
+
+	added.text.assign(text, length);
+	added.hash = textHash;
+	added.references = 1;
+	added.serial = ++serials;
+
+	added.next = buckets[bucket];
+	buckets[bucket] = entry;
+
+	count++;
+	memory += sizeof(Entry) + sizeof(int) + added.text.capacity();
+
+	// At most one entry per bucket on average
+	if ((size_t)count > buckets.size())
+	{
+		rehash();
+	}
+
+	return entry;
+}
+
+
+
+// One more reference
+void StringPool::addReference(StringHandle handle)
+{
+	if (handle != EMPTY_STRING)
+	{
+		entries[handle].references++;
+	}
+}
+
+
+// One less reference, the last one drops the text
+void StringPool::release(StringHandle handle)
+{
+	if (handle == EMPTY_STRING || --entries[handle].references > 0)
+	{
+		return;
+	}
+
+	Entry& entry = entries[handle];
+
+	// Out of its bucket
+	int* link = &buckets[entry.hash & (buckets.size() - 1)];
+
+	while (*link != handle)
+	{
+		link = &entries[*link].next;
+	}
+
+	*link = entry.next;
+
+	count--;
+	memory -= sizeof(Entry) + sizeof(int) + entry.text.capacity();
+
+	// Give the memory back
+	std::string().swap(entry.text);
+
+	entry.references = -1;
+	entry.next = firstFree;
+	firstFree = handle;
+}
+
+
+
+// Drop everything, serials keep counting so cached texts stay invalid
+void StringPool::clear()
+{
+	std::vector<Entry>().swap(entries);
+
+	count = 0;
+	firstFree = -1;
+	memory = 0;
+
+	rehash();
+}
+
+
+
+// Text of a handle
+const std::string& StringPool::get(StringHandle handle) const
+{
+	static const std::string empty;
+
+	return (handle == EMPTY_STRING) ? empty : entries[handle].text;
+}
+
+
+
+// Build the buckets for the current count
+void StringPool::rehash()
+{
+	size_t capacity = 16;
+
+	while (capacity < (size_t)count * 2)
+	{
+		capacity *= 2;
+	}
+
+	buckets.assign(capacity, -1);
+
+	for (int i=0; i < (int)entries.size(); i++)
+	{
+		if (entries[i].references > 0)
+		{
+			size_t bucket = entries[i].hash & (capacity - 1);
+
+			entries[i].next = buckets[bucket];
+			buckets[bucket] = i;
+		}
+	}
+}
+
+
+
+// Take over the reference of another one
+PooledString& PooledString::operator=(const PooledString& other)
+{
+	// Reference first, it may be the same text
+	other.pool->addReference(other.handle);
+	pool->release(handle);
+
+	pool = other.pool;
+	handle = other.handle;
+
+	return *this;
+}
+
+
+// Intern a new text
+PooledString& PooledString::operator=(const char* text)
+{
+	StringHandle newHandle = pool->intern(text);
+
+	pool->release(handle);
+	handle = newHandle;
+
+	return *this;
+}
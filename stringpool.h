@@ -0,0 +1,136 @@
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+/**
+ * -----------------------------------------------------
+ * File        stringpool.h
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#pragma once
+
+
+// c++ libs
+#include <string.h>
+#include <string>
+#include <vector>
+
+
+
+// Handle of an interned string, the empty string has none
+typedef int StringHandle;
+#define EMPTY_STRING -1
+
+
+
+// Pool of interned strings
+//
+// The same server names, player names and reasons come in with call after
+// call. Each distinct text is stored once and referred to by a small
+// handle; the pool counts references and drops a text when the last one
+// is released. Handles of dropped texts are reused, the serial of an entry
+// tells whether a handle still means the same text.
+class StringPool
+{
+private:
+	struct Entry
+	{
+		std::string text;
+		unsigned int hash;
+
+		// -1 if free
+		int references;
+
+		// Changes whenever the entry gets a new text
+		unsigned int serial;
+
+		// Next entry of the bucket, or next free entry
+		int next;
+	};
+
+	std::vector<Entry> entries;
+	std::vector<int> buckets;
+
+	int count;
+	int firstFree;
+	unsigned int serials;
+
+	// Bytes used by the texts and entries
+	size_t memory;
+
+	void rehash();
+
+	// No copies
+	StringPool(const StringPool&);
+	StringPool& operator=(const StringPool&);
+
+public:
+	StringPool();
+
+	// Handle of a text, adds a reference
+	StringHandle intern(const char* text, size_t length);
+	StringHandle intern(const char* text) {return intern(text, strlen(text));}
+	StringHandle intern(const std::string& text) {return intern(text.c_str(), text.size());}
+
+	// References of a handle
+	void addReference(StringHandle handle);
+	void release(StringHandle handle);
+
+	// Drop every text at once, no handle of the pool may be held anymore
+	void clear();
+
+	// Text of a handle
+	const std::string& get(StringHandle handle) const;
+
+	// Serial of a handle, 0 for the empty string
+	unsigned int getSerial(StringHandle handle) const {return (handle == EMPTY_STRING) ? 0 : entries[handle].serial;}
+
+	int getCount() const {return count;}
+	size_t getMemory() const {return memory;}
+};
+
+
+
+// An interned string, holds a reference as long as it lives
+class PooledString
+{
+private:
+	StringPool* pool;
+	StringHandle handle;
+
+public:
+	PooledString(StringPool& stringPool) : pool(&stringPool), handle(EMPTY_STRING) {}
+	PooledString(StringPool& stringPool, const char* text) : pool(&stringPool), handle(stringPool.intern(text)) {}
+	PooledString(const PooledString& other) : pool(other.pool), handle(other.handle) {pool->addReference(handle);}
+	~PooledString() {pool->release(handle);}
+
+	PooledString& operator=(const PooledString& other);
+	PooledString& operator=(const char* text);
+
+	StringHandle getHandle() const {return handle;}
+
+	const std::string& str() const {return pool->get(handle);}
+	const char* c_str() const {return str().c_str();}
+	bool empty() const {return handle == EMPTY_STRING;}
+};
+
+
+#endif
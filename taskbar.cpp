@@ -29,6 +29,7 @@
 #include "log.h"
 #include "config.h"
 #include "calladmin-client.h"
+#include "resources.h"
 
 
 // Wx
@@ -75,13 +76,7 @@ END_EVENT_TABLE()
 // Set Icon of Taskbar
 TaskBarIcon::TaskBarIcon()
 {
-	#if defined(__WXMSW__)
-		SetIcon(wxIcon("calladmin_icon", wxBITMAP_TYPE_ICO_RESOURCE), "Call Admin Client");
-	#else
-		wxLogNull nolog;
-
-		SetIcon(wxIcon(getAppPath("resources/calladmin_icon.ico"), wxBITMAP_TYPE_ICON), "Call Admin Client");
-	#endif
+	SetIcon(getResourceIcon("calladmin_icon"), "Call Admin Client");
 }
 
 
@@ -123,14 +118,14 @@ void TaskBarIcon::OnMenuExit(wxCommandEvent&)
 				// Write in
 				RegSetValueExW(hkRegistry, L"CallAdmin-Client", 0, REG_SZ, (BYTE*)appPath.wc_str(), (wcslen(appPath.wc_str()) + 1) * sizeof(wchar_t));
 
-				LogAction("Added Call Admin to the auto start list");
+				LOG(LOG_CATEGORY_APP, LOG_LEVEL_INFO, "Added Call Admin to the auto start list");
 			}
 			else
 			{
 				// Remove it
 				RegDeleteValueA(hkRegistry, "CallAdmin-Client");
 
-				LogAction("Removed Call Admin from the auto start list");
+				LOG(LOG_CATEGORY_APP, LOG_LEVEL_INFO, "Removed Call Admin from the auto start list");
 			}
 
 			// Close Key
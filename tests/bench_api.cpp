@@ -0,0 +1,192 @@
+/**
+ * -----------------------------------------------------
+ * File        bench_api.cpp
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+// c++ libs
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+// Project
+#include "api.h"
+#include "payloads.h"
+#include "testing.h"
+
+
+
+// Cost of the decoders of the web API
+//
+// Replays notice.php, trackers.php and takeover.php in every format they
+// can answer in through the decoders. Every run first refills the body as
+// the transfer would, as the decoders parse in place.
+
+
+// A decoder on a payload
+class Decode : public BenchCase
+{
+protected:
+	const std::string& payload;
+	std::vector<char> body;
+
+	void receive()
+	{
+		body.resize(payload.size() + 1);
+
+		memcpy(&body[0], payload.data(), payload.size());
+		body[payload.size()] = '\0';
+	}
+
+public:
+	Decode(const std::string& data) : payload(data) {}
+};
+
+
+class DecodeNotice : public Decode
+{
+public:
+	DecodeNotice(const std::string& data) : Decode(data) {}
+
+	virtual void run()
+	{
+		receive();
+
+		ApiNotice notice;
+
+		decodeNotice("", body, notice);
+	}
+};
+
+
+class DecodeTrackers : public Decode
+{
+public:
+	DecodeTrackers(const std::string& data) : Decode(data) {}
+
+	virtual void run()
+	{
+		receive();
+
+		ApiTrackers trackers;
+
+		decodeTrackers("", body, trackers);
+	}
+};
+
+
+class DecodeTakeover : public Decode
+{
+public:
+	DecodeTakeover(const std::string& data) : Decode(data) {}
+
+	virtual void run()
+	{
+		receive();
+
+		ApiTakeover takeover;
+
+		decodeTakeover("", body, takeover);
+	}
+};
+
+
+
+// Check that a payload decodes at all, a benchmark of errors is worthless
+static bool decodes(const std::string& payload, API_STATUS status)
+{
+	if (status != API_OK)
+	{
+		fprintf(stderr, "Payload of %d bytes doesn't decode\n", (int)payload.size());
+
+		return false;
+	}
+
+	return true;
+}
+
+
+
+int main()
+{
+	const API_FORMAT formats[] = {API_FORMAT_XML, API_FORMAT_JSON, API_FORMAT_BINARY};
+	const int calls[] = {1, 10, 100, 1000};
+	const int trackers[] = {1, 10, 100};
+
+	char name[64];
+	bool ok = true;
+
+	printf("\nnotice.php\n");
+
+	for (int c=0; c < 4; c++)
+	{
+		for (int f=0; f < 3; f++)
+		{
+			std::string payload = makeNotice(formats[f], calls[c]);
+			std::vector<char> body = toBody(payload);
+			ApiNotice notice;
+
+			ok = decodes(payload, decodeNotice("", body, notice)) && ok;
+
+			DecodeNotice decode(payload);
+
+			sprintf(name, "%4d calls %s", calls[c], getFormatName(formats[f]));
+			printBench(name, runBench(decode), payload.size());
+		}
+	}
+
+	printf("\ntrackers.php\n");
+
+	for (int t=0; t < 3; t++)
+	{
+		for (int f=0; f < 2; f++)
+		{
+			std::string payload = makeTrackers(formats[f], trackers[t]);
+			std::vector<char> body = toBody(payload);
+			ApiTrackers result;
+
+			ok = decodes(payload, decodeTrackers("", body, result)) && ok;
+
+			DecodeTrackers decode(payload);
+
+			sprintf(name, "%4d trackers %s", trackers[t], getFormatName(formats[f]));
+			printBench(name, runBench(decode), payload.size());
+		}
+	}
+
+	printf("\ntakeover.php\n");
+
+	for (int s=0; s < 2; s++)
+	{
+		for (int f=0; f < 2; f++)
+		{
+			std::string payload = makeTakeover(formats[f], s == 0);
+			DecodeTakeover decode(payload);
+
+			sprintf(name, "%s %s", (s == 0) ? "success" : "error", getFormatName(formats[f]));
+			printBench(name, runBench(decode), payload.size());
+		}
+	}
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,172 @@
+/**
+ * -----------------------------------------------------
+ * File        bench_fetch.cpp
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+// c++ libs
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+// Project
+#include "api.h"
+#include "callstore.h"
+#include "payloads.h"
+#include "standin.h"
+#include "testing.h"
+
+
+
+// notice.php from the request to the calls in the store, per format
+//
+// Fetches from the stand-in web API over loopback, decodes the body and
+// applies the calls to a store as onNotice does: one record per call,
+// checked for a duplicate and added. The store is emptied after every
+// run, so each run applies all calls again. The same without the transfer
+// shows what's left when the network isn't the bottleneck.
+
+
+// Apply decoded calls to a store, as onNotice does
+static int apply(CallStore& store, const ApiNotice& notice)
+{
+	int added = 0;
+
+	for (size_t i=0; i < notice.calls.size(); i++)
+	{
+		CallRecord* record = new CallRecord(notice.calls[i]);
+
+		if (notice.calls[i].found != API_CALL_FIELDS || store.find(*record) != INVALID_CALL)
+		{
+			delete record;
+
+			continue;
+		}
+
+		store.add(record);
+		added++;
+	}
+
+	return added;
+}
+
+
+// Fetch, decode and apply
+class Fetch : public BenchCase
+{
+	int port;
+	std::string path;
+	int expected;
+
+	CallStore store;
+	std::vector<char> body;
+
+public:
+	Fetch(int serverPort, const std::string& url, int calls) : port(serverPort), path(url), expected(calls) {}
+
+	virtual void run()
+	{
+		ApiNotice notice;
+
+		if (!standinFetch(port, path, body) || decodeNotice("", body, notice) != API_OK || apply(store, notice) != expected)
+		{
+			fprintf(stderr, "Fetching %s failed\n", path.c_str());
+		}
+
+		store.clear();
+	}
+};
+
+
+// Decode and apply only
+class Apply : public BenchCase
+{
+	const std::string& payload;
+	int expected;
+
+	CallStore store;
+
+public:
+	Apply(const std::string& data, int calls) : payload(data), expected(calls) {}
+
+	virtual void run()
+	{
+		std::vector<char> body = toBody(payload);
+		ApiNotice notice;
+
+		if (decodeNotice("", body, notice) != API_OK || apply(store, notice) != expected)
+		{
+			fprintf(stderr, "Applying failed\n");
+		}
+
+		store.clear();
+	}
+};
+
+
+
+int main()
+{
+	const API_FORMAT formats[] = {API_FORMAT_XML, API_FORMAT_JSON, API_FORMAT_BINARY};
+	const int sizes[] = {10, 100, 1000};
+
+	StandinServer server(1000);
+
+	if (!server.start())
+	{
+		fprintf(stderr, "Couldn't start the stand-in web API\n");
+
+		return 1;
+	}
+
+	char name[64];
+
+	for (int s=0; s < 3; s++)
+	{
+		printf("\nnotice.php, %d calls\n", sizes[s]);
+
+		for (int f=0; f < 3; f++)
+		{
+			ApiNoticeRequest request;
+
+			request.initial = true;
+			request.limit = sizes[s];
+			request.format = formats[f];
+
+			std::string path = buildURL("", "key", request);
+			std::string payload = makeNotice(formats[f], sizes[s]);
+
+			Fetch fetch(server.getPort(), path, sizes[s]);
+			Apply applyOnly(payload, sizes[s]);
+
+			snprintf(name, sizeof(name), "%s fetch+decode+apply", getFormatName(formats[f]));
+			printBench(name, runBench(fetch), payload.size());
+
+			snprintf(name, sizeof(name), "%s decode+apply", getFormatName(formats[f]));
+			printBench(name, runBench(applyOnly), payload.size());
+		}
+	}
+
+	server.stop();
+
+	return 0;
+}
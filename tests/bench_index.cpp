@@ -0,0 +1,146 @@
+/**
+ * -----------------------------------------------------
+ * File        bench_index.cpp
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+// c++ libs
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+// Project
+#include "callindex.h"
+#include "payloads.h"
+#include "testing.h"
+
+
+
+// Building the search index over 150000 calls of the history, then the
+// queries of the search tab against it
+//
+// The index is built once when the history is loaded, a query runs for
+// every key typed into the search field. Results are limited as the tab
+// limits them.
+
+
+// Calls in the history
+#define BENCH_CALLS 150000
+
+// Results the search tab shows
+#define BENCH_RESULTS 500
+
+
+
+// One query over and over
+class Query : public BenchCase
+{
+private:
+	const CallIndex& index;
+	std::string query;
+
+	std::vector<unsigned int> results;
+
+public:
+	Query(const CallIndex& callIndex, const char* text) : index(callIndex), query(text) {}
+
+	virtual void run()
+	{
+		index.search(query, results, BENCH_RESULTS);
+	}
+
+	size_t getResults() const {return results.size();}
+};
+
+
+
+// Time of a query and how many calls it found
+static void benchQuery(const CallIndex& index, const char* name, const char* text)
+{
+	Query query(index, text);
+
+	BenchResult result = runBench(query);
+
+	char line[128];
+
+	sprintf(line, "%s \"%s\", %u found", name, text, (unsigned int)query.getResults());
+
+	printBench(line, result);
+}
+
+
+
+int main()
+{
+	std::vector<CallRecord*> records;
+
+	for (int i=0; i < BENCH_CALLS; i++)
+	{
+		records.push_back(makeRecord(i));
+	}
+
+
+	// Build, as loading the history does
+	CallIndex index;
+
+	double start = benchTime();
+
+	for (int i=0; i < BENCH_CALLS; i++)
+	{
+		index.add((unsigned int)i, *records[i]);
+	}
+
+	double build = benchTime() - start;
+
+	printf("build over %d calls: %.1f ms, %.2f us per call, %u words\n", BENCH_CALLS, build * 1e3, build * 1e6 / BENCH_CALLS, (unsigned int)index.getTerms());
+
+	for (size_t i=0; i < records.size(); i++)
+	{
+		delete records[i];
+	}
+
+
+	// A word of few calls, of many and of all
+	printf("\nsingle word\n");
+
+	benchQuery(index, "rare", "griefing");
+	benchQuery(index, "common", "dust2");
+	benchQuery(index, "everywhere", "player");
+	benchQuery(index, "steamid", "STEAM_0:1:1017");
+
+	// All words have to match
+	printf("\nmultiple words\n");
+
+	benchQuery(index, "two", "wallhack dust2");
+	benchQuery(index, "three", "player 17 exploiting");
+	benchQuery(index, "none", "micspam spinbot");
+
+	// The last word while it's typed
+	printf("\nprefix\n");
+
+	benchQuery(index, "one letter", "p");
+	benchQuery(index, "word", "wall");
+	benchQuery(index, "after a word", "community s");
+	benchQuery(index, "digits", "7656119");
+
+	return 0;
+}
@@ -0,0 +1,181 @@
+/**
+ * -----------------------------------------------------
+ * File        bench_intern.cpp
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+// c++ libs
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+// Project
+#include "callstore.h"
+#include "payloads.h"
+#include "stringpool.h"
+#include "testing.h"
+
+
+
+// Memory of a call with and without interned strings
+//
+// Keeps 10000 calls alive and counts the heap bytes they hold. The calls
+// come from a few servers, players and reasons, as a real feed does.
+// Without interning every call has its own copy of each name, with it
+// they share one entry of the pool.
+
+
+// A call as it was before interning
+struct PlainCall
+{
+	std::string callID;
+	std::string fullIP;
+	std::string serverName;
+	std::string targetName;
+	std::string targetReason;
+	std::string clientName;
+
+	unsigned long long targetID;
+	unsigned long long clientID;
+
+	long reportedAt;
+	bool handled;
+	void* dialog;
+};
+
+
+static PlainCall* makePlain(int number, int textLength)
+{
+	PayloadCall call = makeCall(number, textLength);
+	PlainCall* plain = new PlainCall();
+
+	plain->callID = call.callID;
+	plain->fullIP = call.fullIP;
+	plain->serverName = call.serverName;
+	plain->targetName = call.targetName;
+	plain->targetReason = call.targetReason;
+	plain->clientName = call.clientName;
+	plain->targetID = call.targetID;
+	plain->clientID = call.clientID;
+	plain->reportedAt = call.reportedAt;
+	plain->handled = call.handled;
+	plain->dialog = NULL;
+
+	return plain;
+}
+
+
+
+// Making and dropping a call, for the cost of interning
+class MakeInterned : public BenchCase
+{
+	int number;
+	int textLength;
+
+public:
+	MakeInterned(int length) : number(0), textLength(length) {}
+
+	virtual void run()
+	{
+		delete makeRecord(number++ % 1000, textLength);
+	}
+};
+
+
+class MakePlain : public BenchCase
+{
+	int number;
+	int textLength;
+
+public:
+	MakePlain(int length) : number(0), textLength(length) {}
+
+	virtual void run()
+	{
+		delete makePlain(number++ % 1000, textLength);
+	}
+};
+
+
+
+int main()
+{
+	const int calls = 10000;
+	const int texts[] = {0, 200, 2000};
+
+	for (int t=0; t < 3; t++)
+	{
+		printf("\n%d calls, reasons of at least %d chars\n", calls, texts[t]);
+
+		// Interned, the pool is part of what they hold
+		call_strings.clear();
+
+		unsigned long long before = benchLiveBytes();
+		std::vector<CallRecord*> records;
+
+		records.reserve(calls);
+
+		for (int i=0; i < calls; i++)
+		{
+			records.push_back(makeRecord(i, texts[t]));
+		}
+
+		double interned = (double)(benchLiveBytes() - before) / calls;
+		size_t pool = call_strings.getMemory();
+		int distinct = call_strings.getCount();
+
+		for (int i=0; i < calls; i++)
+		{
+			delete records[i];
+		}
+
+
+		before = benchLiveBytes();
+		std::vector<PlainCall*> plains;
+
+		plains.reserve(calls);
+
+		for (int i=0; i < calls; i++)
+		{
+			plains.push_back(makePlain(i, texts[t]));
+		}
+
+		double plain = (double)(benchLiveBytes() - before) / calls;
+
+		for (int i=0; i < calls; i++)
+		{
+			delete plains[i];
+		}
+
+		printf("%-44s %10.0f B/call\n", "interned", interned);
+		printf("%-44s %10.0f B/call\n", "plain strings", plain);
+		printf("%-44s %10.0f B, %d distinct strings\n", "pool", (double)pool, distinct);
+
+		MakeInterned makeInterned(texts[t]);
+		MakePlain makePlainCall(texts[t]);
+
+		printBench("make and free, interned", runBench(makeInterned));
+		printBench("make and free, plain strings", runBench(makePlainCall));
+	}
+
+	return 0;
+}
@@ -0,0 +1,343 @@
+/**
+ * -----------------------------------------------------
+ * File        bench_list.cpp
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+// c++ libs
+#include <stdio.h>
+#include <time.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// Project
+#include "callstore.h"
+#include "payloads.h"
+#include "testing.h"
+
+
+
+// Time on the UI thread per change of the store, as the call list
+// applies it, while thousands of calls come in
+//
+// The list is a wxListCtrl, which can't be built here. ListModel has the
+// handlers of CallListCtrl line by line, only the list below them is a
+// few counters: the rows in sight that a refresh draws are read from the
+// store and formatted as OnGetItemText does. What wx itself takes to paint
+// them isn't measured.
+
+
+// Calls that come in per store size and view
+#define BENCH_INJECTED 5000
+
+// Rows in sight
+#define BENCH_PAGE 25
+
+
+
+// CallListCtrl without wx
+class ListModel : public CallStoreListener
+{
+private:
+	struct ListState
+	{
+		long selectedRow;
+		CallHandle selected;
+
+		long top;
+		bool atEnd;
+	};
+
+	const CallStore& store;
+	CALL_VIEW view;
+
+	// Of the wxListCtrl
+	long itemCount;
+	long selectedRow;
+	long top;
+
+	long changingRow;
+	ListState changing;
+
+	// Characters drawn, so the drawing isn't optimized away
+	size_t drawn;
+
+	CallHandle getCall(long row) const {return store.getAt(view, row);}
+
+	// Draw the rows in sight of a range, as a refresh does
+	void refreshItems(long from, long to)
+	{
+		char buffer[80];
+
+		for (long row = std::max(from, top); row <= to && row < top + BENCH_PAGE; row++)
+		{
+			const CallRecord* record = store.get(getCall(row));
+
+			if (record == NULL)
+			{
+				continue;
+			}
+
+			time_t tt = (time_t)record->reportedAt;
+
+			drawn += strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M", localtime(&tt));
+
+			std::string server = record->serverName.str();
+			std::string target = record->targetName.str();
+
+			drawn += server.size() + target.size() + (record->handled ? 7 : 9);
+		}
+	}
+
+	void setTop(long row)
+	{
+		top = std::max(0L, std::min(row, itemCount - BENCH_PAGE));
+	}
+
+	ListState getState() const
+	{
+		ListState state;
+
+		state.selectedRow = selectedRow;
+		state.selected = getCall(state.selectedRow);
+
+		state.top = top;
+		state.atEnd = (state.top + BENCH_PAGE >= store.getViewCount(view));
+
+		return state;
+	}
+
+	void applyChange(long from, int shift, const ListState& before)
+	{
+		long count = store.getViewCount(view);
+
+		itemCount = count;
+
+		if (from < count)
+		{
+			refreshItems(from, count - 1);
+		}
+
+		long row = store.getRow(view, before.selected);
+
+		if (row != before.selectedRow)
+		{
+			if (before.selectedRow != -1 && before.selectedRow < count)
+			{
+				selectedRow = -1;
+			}
+
+			if (row != -1)
+			{
+				selectedRow = row;
+			}
+		}
+
+		if (shift != 0 && count > 0)
+		{
+			setTop(top + shift);
+		}
+		else if (before.atEnd && count > 0 && from == count - 1)
+		{
+			setTop(count - 1);
+		}
+	}
+
+public:
+	ListModel(const CallStore& callStore, CALL_VIEW callView) : store(callStore), view(callView), itemCount(0), selectedRow(-1), top(0), changingRow(-1), drawn(0) {}
+
+	// Scroll to a row and select one
+	void show(long topRow, long selected)
+	{
+		setTop(topRow);
+		selectedRow = selected;
+
+		refreshItems(top, itemCount - 1);
+	}
+
+	size_t getDrawn() const {return drawn;}
+
+	virtual void onCallAdded(CallHandle handle)
+	{
+		long row = store.getRow(view, handle);
+
+		if (row == -1)
+		{
+			return;
+		}
+
+		ListState before = getState();
+
+		if (before.selectedRow >= row)
+		{
+			before.selected = getCall(before.selectedRow + 1);
+		}
+
+		before.atEnd = (before.top + BENCH_PAGE >= store.getViewCount(view) - 1);
+
+		applyChange(row, (before.top > 0 && row <= before.top) ? 1 : 0, before);
+	}
+
+	virtual void onCallChanging(CallHandle handle)
+	{
+		changing = getState();
+		changingRow = store.getRow(view, handle);
+	}
+
+	virtual void onCallChanged(CallHandle handle)
+	{
+		const ListState& before = changing;
+
+		long removed = changingRow;
+		long added = store.getRow(view, handle);
+
+		if (removed == -1 && added == -1)
+		{
+			return;
+		}
+
+		if (removed == added)
+		{
+			refreshItems(added, added);
+
+			return;
+		}
+
+		int shift = 0;
+
+		if (removed != -1 && removed < before.top)
+		{
+			shift--;
+		}
+
+		if (added != -1 && before.top > 0 && added <= before.top)
+		{
+			shift++;
+		}
+
+		applyChange((removed == -1 || (added != -1 && added < removed)) ? added : removed, shift, before);
+	}
+
+	virtual void onCallRemoved(CallHandle)
+	{
+		if (changingRow != -1)
+		{
+			applyChange(changingRow, (changingRow < changing.top) ? -1 : 0, changing);
+		}
+	}
+
+	virtual void onCallsReset()
+	{
+		itemCount = store.getViewCount(view);
+
+		refreshItems(top, itemCount - 1);
+	}
+};
+
+
+
+// Inject calls into a full store as onNotice does: the oldest call is
+// given up for each new one, now and then one is handled. Every change
+// is timed on its own.
+static void benchInject(int size, CALL_VIEW view, const char* name)
+{
+	CallStore store;
+
+	store.setBudget((size_t)1 << 30);
+
+	for (int i=0; i < size; i++)
+	{
+		store.add(makeRecord(i));
+	}
+
+	ListModel list(store, view);
+
+	store.setListener(&list);
+
+	list.onCallsReset();
+
+	// Somewhere in the middle, a call selected in sight
+	list.show(size / 2, size / 2 + 3);
+
+	std::vector<double> times;
+	unsigned int random = 12345U;
+	int number = size;
+
+	for (int i=0; i < BENCH_INJECTED; i++)
+	{
+		CallRecord* record = makeRecord(number++);
+
+		double start = benchTime();
+
+		store.remove(store.getOldest());
+		store.add(record);
+
+		times.push_back(benchTime() - start);
+
+		// A third of them handled by an admin meanwhile
+		if (i % 3 == 0)
+		{
+			random = random * 1103515245U + 12345U;
+
+			CallHandle handle = store.getAt(CALL_VIEW_OLDEST, (long)((random >> 8) % (unsigned int)store.getCount()));
+
+			start = benchTime();
+
+			store.setHandled(handle);
+
+			times.push_back(benchTime() - start);
+		}
+	}
+
+	store.setListener(NULL);
+
+	std::sort(times.begin(), times.end());
+
+	double sum = 0;
+
+	for (size_t i=0; i < times.size(); i++)
+	{
+		sum += times[i];
+	}
+
+	printf("%-32s %8.2f us mean %8.2f us 99%% %8.2f us max  (%lu chars drawn)\n", name, sum / times.size() * 1e6, times[times.size() * 99 / 100] * 1e6, times.back() * 1e6, (unsigned long)list.getDrawn());
+}
+
+
+
+int main()
+{
+	const int sizes[] = {1000, 100000};
+
+	for (int s=0; s < 2; s++)
+	{
+		printf("\n%d calls in the list, %d coming in\n", sizes[s], BENCH_INJECTED);
+
+		benchInject(sizes[s], CALL_VIEW_OLDEST, "oldest first");
+		benchInject(sizes[s], CALL_VIEW_NEWEST, "newest first");
+		benchInject(sizes[s], CALL_VIEW_UNHANDLED_FIRST, "unhandled first");
+		benchInject(sizes[s], CALL_VIEW_SERVER, "by server");
+	}
+
+	return 0;
+}
@@ -0,0 +1,433 @@
+/**
+ * -----------------------------------------------------
+ * File        bench_log.cpp
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+// c++ libs
+#include <stdio.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Project
+#include "logfile.h"
+#include "logqueue.h"
+#include "logring.h"
+#include "testing.h"
+
+
+
+// Log lines on their way to the log file
+//
+// First LogFile alone: batches of LOG_DRAIN_BATCH lines, each with one
+// write and flush, small files so rotation is paid for as well.
+//
+// Then the whole way at a sustained 10000 lines/s for two seconds: lines
+// are queued as LOG does, drained into the ring every 16 ms as the idle
+// handler does and handed to a writer thread which works like
+// LogFileThread, bounded queue and dropping included. Reported are the
+// lines written and dropped, and how much of a core either side needs.
+//
+// Last what a line costs where it's logged: below the level of its
+// category LOG is one compare, its fields aren't even evaluated. Next to
+// it the same line logged, and its message formatted up front as the
+// call sites did before there were levels.
+
+
+// File of the benchmark, small so it rotates often
+#define BENCH_LOG_FILE "bench_log.log"
+#define BENCH_LOG_SIZE (1024 * 1024)
+
+// Sustained rate, lines per millisecond, and for how long
+#define BENCH_LOG_RATE 10
+#define BENCH_LOG_MS 2000
+#define BENCH_LOG_DRAIN_MS 16
+
+
+
+// A line as the client logs it, fetching calls
+static LogEntry makeLine(int number)
+{
+	char value[32];
+
+	LogEntry entry((long)time(0), LOG_LEVEL_INFO, LOG_CATEGORY_NET, "Fetched calls");
+
+	sprintf(value, "%d", number % 50);
+	entry.addField("calls", value);
+
+	sprintf(value, "%d", 20 + number % 300);
+	entry.addField("ms", value);
+
+	entry.addField("url", "http://calladmin.example.com/notice.php?from=1500000000&format=json");
+
+	return entry;
+}
+
+
+// 64bit SteamID as Steam renders it
+static std::string renderID(unsigned long long steamid)
+{
+	std::ostringstream out;
+
+	out << "[U:1:" << (steamid - 76561197960265728ULL) << "]";
+
+	return out.str();
+}
+
+
+// Remove the files of the benchmark
+static void removeFiles()
+{
+	remove(BENCH_LOG_FILE);
+
+	for (int i=1; i <= LOG_FILE_KEEP; i++)
+	{
+		char name[64];
+
+		sprintf(name, "%s.%d", BENCH_LOG_FILE, i);
+		remove(name);
+	}
+}
+
+
+
+// A batch of lines written
+class WriteBatch : public BenchCase
+{
+private:
+	LogFile file;
+	std::vector<LogEntry> lines;
+
+public:
+	WriteBatch()
+	{
+		file.open(BENCH_LOG_FILE, BENCH_LOG_SIZE);
+
+		for (int i=0; i < LOG_DRAIN_BATCH; i++)
+		{
+			lines.push_back(makeLine(i));
+		}
+	}
+
+	virtual void run()
+	{
+		file.write(lines);
+	}
+};
+
+
+
+// A line being logged as LogLine does, without waking a UI
+class BenchLine
+{
+private:
+	LogQueue& queue;
+	LogEntry entry;
+
+public:
+	BenchLine(LogQueue& logQueue, LOG_CATEGORY category, LOG_LEVEL level, const char* message) : queue(logQueue), entry((long)time(0), level, category, message) {}
+	~BenchLine() {queue.push(entry);}
+
+	BenchLine& field(const char* key, const std::string& value) {entry.addField(key, value); return *this;}
+
+	template <class T>
+	BenchLine& field(const char* key, const T& value)
+	{
+		std::ostringstream out;
+
+		out << value;
+
+		entry.addField(key, out.str());
+
+		return *this;
+	}
+};
+
+
+// A line of the client: below the level, logged, or formatted up front
+class LogAvatar : public BenchCase
+{
+public:
+	enum MODE
+	{
+		MODE_DISABLED = 0,
+		MODE_LOGGED,
+		MODE_FORMATTED
+	};
+
+private:
+	LogQueue queue;
+	LogEntry taken;
+
+	MODE mode;
+	unsigned long long steamid;
+
+public:
+	// What was formatted, so it's not optimized away
+	size_t formatted;
+
+	LogAvatar(MODE lineMode) : mode(lineMode), steamid(76561197960265728ULL), formatted(0) {}
+
+	virtual void run()
+	{
+		steamid++;
+
+		if (mode == MODE_DISABLED)
+		{
+			LOG_IF(LOG_CATEGORY_STEAM, LOG_LEVEL_DEBUG) BenchLine(queue, LOG_CATEGORY_STEAM, LOG_LEVEL_DEBUG, "Loaded avatar").field("steamid", renderID(steamid)).field("size", 64);
+		}
+		else if (mode == MODE_LOGGED)
+		{
+			LOG_IF(LOG_CATEGORY_STEAM, LOG_LEVEL_INFO) BenchLine(queue, LOG_CATEGORY_STEAM, LOG_LEVEL_INFO, "Loaded avatar").field("steamid", renderID(steamid)).field("size", 64);
+
+			// The UI thread takes it
+			queue.startDrain();
+			queue.pop(taken);
+		}
+		else
+		{
+			std::string text = "Loaded Avatar of " + renderID(steamid);
+
+			formatted += text.size();
+		}
+	}
+};
+
+
+
+// Writes the lines handed over, like LogFileThread
+class Writer
+{
+private:
+	LogFile file;
+
+	pthread_t thread;
+	pthread_mutex_t lock;
+	pthread_cond_t wake;
+
+	// Guarded by lock
+	std::vector<LogEntry> queued;
+	unsigned long dropped;
+	bool stopping;
+
+	static void* entry(void* writer) {((Writer*)writer)->work(); return NULL;}
+
+	void work()
+	{
+		std::vector<LogEntry> batch;
+
+		while (true)
+		{
+			unsigned long lost;
+			bool done;
+
+			pthread_mutex_lock(&lock);
+
+			while (queued.empty() && dropped == 0 && !stopping)
+			{
+				pthread_cond_wait(&wake, &lock);
+			}
+
+			batch.swap(queued);
+
+			lost = dropped;
+			dropped = 0;
+
+			done = stopping;
+
+			pthread_mutex_unlock(&lock);
+
+			double start = benchTime();
+
+			file.write(batch, lost);
+
+			busy += benchTime() - start;
+			written += batch.size();
+			lostLines += lost;
+
+			batch.clear();
+
+			if (done)
+			{
+				return;
+			}
+		}
+	}
+
+public:
+	// Only read after stop()
+	double busy;
+	unsigned long written;
+	unsigned long lostLines;
+
+	Writer() : dropped(0), stopping(false), busy(0), written(0), lostLines(0)
+	{
+		file.open(BENCH_LOG_FILE, BENCH_LOG_SIZE);
+
+		pthread_mutex_init(&lock, NULL);
+		pthread_cond_init(&wake, NULL);
+		pthread_create(&thread, NULL, entry, this);
+	}
+
+	~Writer()
+	{
+		pthread_cond_destroy(&wake);
+		pthread_mutex_destroy(&lock);
+	}
+
+	void add(const std::vector<LogEntry>& lines)
+	{
+		pthread_mutex_lock(&lock);
+
+		for (size_t i=0; i < lines.size(); i++)
+		{
+			if (queued.size() >= LOG_FILE_QUEUE)
+			{
+				dropped += lines.size() - i;
+
+				break;
+			}
+
+			queued.push_back(lines[i]);
+		}
+
+		pthread_cond_signal(&wake);
+		pthread_mutex_unlock(&lock);
+	}
+
+	void stop()
+	{
+		pthread_mutex_lock(&lock);
+
+		stopping = true;
+
+		pthread_cond_signal(&wake);
+		pthread_mutex_unlock(&lock);
+
+		pthread_join(thread, NULL);
+	}
+};
+
+
+// 10000 lines/s from the queue to the file
+static void sustained()
+{
+	LogQueue queue;
+	LogRing ring(LOG_CAPACITY);
+	Writer writer;
+
+	std::vector<LogEntry> fileLines;
+	LogEntry entry;
+
+	double start = benchTime();
+	double busy = 0;
+	int number = 0;
+
+	for (int tick=1; tick <= BENCH_LOG_MS; tick++)
+	{
+		double work = benchTime();
+
+		// LOG
+		for (int i=0; i < BENCH_LOG_RATE; i++)
+		{
+			queue.push(makeLine(number++));
+		}
+
+		// drainLog()
+		if (tick % BENCH_LOG_DRAIN_MS == 0 || tick == BENCH_LOG_MS)
+		{
+			queue.startDrain();
+
+			int taken = 0;
+
+			while (taken < LOG_DRAIN_BATCH && queue.pop(entry))
+			{
+				ring.add(entry);
+				fileLines.push_back(entry);
+
+				taken++;
+			}
+
+			writer.add(fileLines);
+			fileLines.clear();
+		}
+
+		busy += benchTime() - work;
+
+		// Until the next millisecond
+		double wait = start + tick / 1000.0 - benchTime();
+
+		if (wait > 0)
+		{
+			usleep((useconds_t)(wait * 1e6));
+		}
+	}
+
+	writer.stop();
+
+	double seconds = benchTime() - start;
+
+	printf("\nSustained, %d lines/s for %d ms\n", BENCH_LOG_RATE * 1000, BENCH_LOG_MS);
+	printf("%-44s %10.0f lines/s\n", "logged", number / seconds);
+	printf("%-44s %10lu lines\n", "written", writer.written);
+	printf("%-44s %10lu lines\n", "dropped", writer.lostLines);
+	printf("%-44s %10.1f %% of a core\n", "logging and draining", busy / seconds * 100);
+	printf("%-44s %10.1f %% of a core\n", "writer thread", writer.busy / seconds * 100);
+}
+
+
+
+int main()
+{
+	removeFiles();
+
+	printf("\nLog file, batches of %d lines\n", LOG_DRAIN_BATCH);
+
+	WriteBatch batch;
+
+	BenchResult result = runBench(batch);
+
+	printBench("write a batch", result);
+	printf("%-44s %10.0f lines/s\n", "written", LOG_DRAIN_BATCH * 1e9 / result.nsPerCall);
+
+	removeFiles();
+
+	sustained();
+
+	removeFiles();
+
+
+	printf("\nA line where it's logged\n");
+
+	LogAvatar disabled(LogAvatar::MODE_DISABLED);
+	LogAvatar logged(LogAvatar::MODE_LOGGED);
+	LogAvatar formatted(LogAvatar::MODE_FORMATTED);
+
+	printBench("LOG below the level", runBench(disabled));
+	printBench("LOG logged and taken", runBench(logged));
+	printBench("message formatted up front", runBench(formatted));
+
+	return 0;
+}
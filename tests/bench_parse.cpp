@@ -0,0 +1,188 @@
+/**
+ * -----------------------------------------------------
+ * File        bench_parse.cpp
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+// c++ libs
+#include <string.h>
+#include <vector>
+
+// Parsers
+#include "tinyxml2/tinyxml2.h"
+#include "json.h"
+
+// Project
+#include "api.h"
+#include "payloads.h"
+#include "testing.h"
+
+
+
+// Parsing in place against parsing a copy of the body
+//
+// The curl thread writes the response into the body buffer, so every run
+// starts with filling it from the payload, as the transfer would. After
+// that the in place parsers work on it directly, the copying ones first
+// copy it into a buffer of their own.
+
+
+// Body as the transfer leaves it
+class Body
+{
+protected:
+	const std::string& payload;
+	std::vector<char> body;
+
+	void receive()
+	{
+		body.resize(payload.size() + 1);
+
+		memcpy(&body[0], payload.data(), payload.size());
+		body[payload.size()] = '\0';
+	}
+
+public:
+	Body(const std::string& data) : payload(data) {}
+};
+
+
+// tinyxml2 in place
+class XmlInSitu : public Body, public BenchCase
+{
+public:
+	XmlInSitu(const std::string& data) : Body(data) {}
+
+	virtual void run()
+	{
+		receive();
+
+		tinyxml2::XMLDocument doc;
+
+		doc.ParseInSitu(&body[0], payload.size());
+	}
+};
+
+
+// tinyxml2 on its own copy
+class XmlCopy : public Body, public BenchCase
+{
+public:
+	XmlCopy(const std::string& data) : Body(data) {}
+
+	virtual void run()
+	{
+		receive();
+
+		tinyxml2::XMLDocument doc;
+
+		doc.Parse(&body[0], payload.size());
+	}
+};
+
+
+// JSON reader in place
+class JsonInSitu : public Body, public BenchCase
+{
+public:
+	JsonInSitu(const std::string& data) : Body(data) {}
+
+	virtual void run()
+	{
+		receive();
+
+		JsonReader reader(&body[0], payload.size());
+
+		while (reader.next() > JSON_ERROR);
+	}
+};
+
+
+// JSON reader on a copy
+class JsonCopy : public Body, public BenchCase
+{
+public:
+	JsonCopy(const std::string& data) : Body(data) {}
+
+	virtual void run()
+	{
+		receive();
+
+		std::vector<char> copy(body);
+
+		JsonReader reader(&copy[0], payload.size());
+
+		while (reader.next() > JSON_ERROR);
+	}
+};
+
+
+// Whole decoder, in place as the client does it
+class DecodeNotice : public Body, public BenchCase
+{
+public:
+	DecodeNotice(const std::string& data) : Body(data) {}
+
+	virtual void run()
+	{
+		receive();
+
+		ApiNotice notice;
+
+		decodeNotice("", body, notice);
+	}
+};
+
+
+
+int main()
+{
+	const int sizes[] = {10, 100, 1000};
+	const int texts[] = {0, 2000};
+
+	for (int t=0; t < 2; t++)
+	{
+		for (int s=0; s < 3; s++)
+		{
+			std::string xml = makeNotice(API_FORMAT_XML, sizes[s], texts[t]);
+			std::string json = makeNotice(API_FORMAT_JSON, sizes[s], texts[t]);
+
+			printf("\nnotice.php, %d calls, reasons of %d chars: XML %d bytes, JSON %d bytes\n", sizes[s], texts[t], (int)xml.size(), (int)json.size());
+
+			XmlInSitu xmlInSitu(xml);
+			XmlCopy xmlCopy(xml);
+			JsonInSitu jsonInSitu(json);
+			JsonCopy jsonCopy(json);
+			DecodeNotice decodeXml(xml);
+			DecodeNotice decodeJson(json);
+
+			printBench("xml parse in place", runBench(xmlInSitu), xml.size());
+			printBench("xml parse of a copy", runBench(xmlCopy), xml.size());
+			printBench("json read in place", runBench(jsonInSitu), json.size());
+			printBench("json read of a copy", runBench(jsonCopy), json.size());
+			printBench("decodeNotice xml", runBench(decodeXml), xml.size());
+			printBench("decodeNotice json", runBench(decodeJson), json.size());
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,152 @@
+/**
+ * -----------------------------------------------------
+ * File        bench_scan.cpp
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+// c++ libs
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+// Parsers
+#include "tinyxml2/tinyxml2.h"
+
+// Project
+#include "api.h"
+#include "payloads.h"
+#include "testing.h"
+
+
+
+// Throughput of the scans of tinyxml2 on large responses
+//
+// Built twice: bench_scan dispatches the scans to the widest vector unit
+// of the CPU, bench_scan_scalar is built with TIXML_NO_SIMD. Both measure
+// the kernels on their own and whole parses of large notice.php and
+// trackers.php responses.
+
+
+// Text without any delimiter, the worst case of FindAny
+class FindAnyRun : public BenchCase
+{
+	std::vector<char> text;
+
+public:
+	FindAnyRun(size_t length) : text(length + 1, 'x')
+	{
+		text[length] = '\0';
+	}
+
+	virtual void run()
+	{
+		if (*tinyxml2::XMLUtil::FindAny(&text[0], '<', '&', '\r') != '\0')
+		{
+			fprintf(stderr, "FindAny stopped early\n");
+		}
+	}
+};
+
+
+// One long run of whitespace
+class WhiteSpaceRun : public BenchCase
+{
+	std::vector<char> text;
+
+public:
+	WhiteSpaceRun(size_t length) : text(length + 1, ' ')
+	{
+		for (size_t i=0; i < length; i += 7)
+		{
+			text[i] = (i % 2 == 0) ? '\t' : '\n';
+		}
+
+		text[length] = '\0';
+	}
+
+	virtual void run()
+	{
+		if (*tinyxml2::XMLUtil::SkipWhiteSpaceRun(&text[0]) != '\0')
+		{
+			fprintf(stderr, "SkipWhiteSpaceRun stopped early\n");
+		}
+	}
+};
+
+
+// Whole parse in place, refilled as the transfer would
+class ParseXml : public BenchCase
+{
+	const std::string& payload;
+	std::vector<char> body;
+
+public:
+	ParseXml(const std::string& data) : payload(data), body(data.size() + 1) {}
+
+	virtual void run()
+	{
+		memcpy(&body[0], payload.data(), payload.size());
+		body[payload.size()] = '\0';
+
+		tinyxml2::XMLDocument doc;
+
+		if (doc.ParseInSitu(&body[0], payload.size()) != tinyxml2::XML_SUCCESS)
+		{
+			fprintf(stderr, "Payload doesn't parse\n");
+		}
+	}
+};
+
+
+
+int main()
+{
+#if defined(TIXML_NO_SIMD)
+	printf("\nScans: scalar\n");
+#else
+	printf("\nScans: widest vector unit of the CPU\n");
+#endif
+
+	const size_t runLength = 1 << 20;
+
+	FindAnyRun findAny(runLength);
+	WhiteSpaceRun whiteSpace(runLength);
+
+	printBench("FindAny, 1 MB of text", runBench(findAny), runLength);
+	printBench("SkipWhiteSpaceRun, 1 MB", runBench(whiteSpace), runLength);
+
+
+	std::string shortFields = makeNotice(API_FORMAT_XML, 10000);
+	std::string longReasons = makeNotice(API_FORMAT_XML, 1000, 2000);
+	std::string trackers = makeTrackers(API_FORMAT_XML, 20000);
+
+	ParseXml parseShort(shortFields);
+	ParseXml parseLong(longReasons);
+	ParseXml parseTrackers(trackers);
+
+	printBench("notice.php, 10000 calls", runBench(parseShort, 0.5), shortFields.size());
+	printBench("notice.php, 1000 long reasons", runBench(parseLong, 0.5), longReasons.size());
+	printBench("trackers.php, 20000 trackers", runBench(parseTrackers, 0.5), trackers.size());
+
+	return 0;
+}
@@ -0,0 +1,216 @@
+/**
+ * -----------------------------------------------------
+ * File        bench_store.cpp
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+// c++ libs
+#include <stdio.h>
+#include <vector>
+
+// Project
+#include "callstore.h"
+#include "payloads.h"
+#include "testing.h"
+
+
+
+// Finding a duplicate among 50, 1000 and 100000 stored calls
+//
+// Every fetch of notice.php looks up each call it returns, so this is
+// paid for every call every few seconds. The scan over all calls is what
+// the store did before it had an index.
+//
+// Then the rows of the views, which the store keeps in order: finding the
+// call of a row and the row of a call, and a call put into all of them.
+
+
+// Calls to look up, one after the other
+class Lookup : public BenchCase
+{
+protected:
+	CallStore& store;
+	std::vector<CallRecord*>& probes;
+	size_t next;
+
+	CallRecord& probe()
+	{
+		CallRecord& record = *probes[next];
+
+		next = (next + 1) % probes.size();
+
+		return record;
+	}
+
+public:
+	Lookup(CallStore& callStore, std::vector<CallRecord*>& records) : store(callStore), probes(records), next(0) {}
+};
+
+
+class FindIndexed : public Lookup
+{
+public:
+	FindIndexed(CallStore& callStore, std::vector<CallRecord*>& records) : Lookup(callStore, records) {}
+
+	virtual void run()
+	{
+		store.find(probe());
+	}
+};
+
+
+class FindScan : public Lookup
+{
+public:
+	FindScan(CallStore& callStore, std::vector<CallRecord*>& records) : Lookup(callStore, records) {}
+
+	virtual void run()
+	{
+		const CallRecord& record = probe();
+
+		for (CallHandle handle = store.getFirst(); handle != INVALID_CALL; handle = store.getNext(handle))
+		{
+			if (*store.get(handle) == record)
+			{
+				return;
+			}
+		}
+	}
+};
+
+
+
+// Rows of the views: what the call list asks for when it draws a row,
+// keeps the selection and applies a change
+class ViewRow : public BenchCase
+{
+private:
+	CallStore& store;
+	CALL_VIEW view;
+	long row;
+
+public:
+	ViewRow(CallStore& callStore, CALL_VIEW callView) : store(callStore), view(callView), row(0) {}
+
+	virtual void run()
+	{
+		long count = store.getViewCount(view);
+
+		row = (row + 7919) % count;
+
+		store.getRow(view, store.getAt(view, row));
+	}
+};
+
+
+// A call from the past goes into every view and out again
+class AddPast : public BenchCase
+{
+private:
+	CallStore& store;
+	CallRecord* record;
+
+public:
+	AddPast(CallStore& callStore, CallRecord* past) : store(callStore), record(past) {}
+
+	virtual void run()
+	{
+		CallHandle handle = store.add(record);
+
+		store.setHandled(handle);
+
+		// Taken over again
+		CallRecord* copy = new CallRecord(*record);
+
+		store.remove(handle);
+
+		record = copy;
+		record->handled = false;
+	}
+
+	~AddPast() {delete record;}
+};
+
+
+
+int main()
+{
+	const int sizes[] = {50, 1000, 100000};
+
+	for (int s=0; s < 3; s++)
+	{
+		CallStore store;
+
+		store.setBudget((size_t)1 << 30);
+
+		for (int i=0; i < sizes[s]; i++)
+		{
+			store.add(makeRecord(i));
+		}
+
+		// Stored ones, spread over the store, and new ones
+		std::vector<CallRecord*> hits;
+		std::vector<CallRecord*> misses;
+
+		for (int i=0; i < 256; i++)
+		{
+			hits.push_back(makeRecord((int)((i * 7919LL) % sizes[s])));
+			misses.push_back(makeRecord(sizes[s] + i));
+		}
+
+		printf("\n%d stored calls\n", sizes[s]);
+
+		FindIndexed indexedHit(store, hits);
+		FindIndexed indexedMiss(store, misses);
+		FindScan scanHit(store, hits);
+		FindScan scanMiss(store, misses);
+
+		printBench("find, stored call", runBench(indexedHit));
+		printBench("find, new call", runBench(indexedMiss));
+		printBench("scan, stored call", runBench(scanHit));
+		printBench("scan, new call", runBench(scanMiss));
+
+		ViewRow byTime(store, CALL_VIEW_NEWEST);
+		ViewRow byState(store, CALL_VIEW_UNHANDLED_FIRST);
+		ViewRow byServer(store, CALL_VIEW_SERVER);
+
+		printBench("row and call, newest first", runBench(byTime));
+		printBench("row and call, unhandled first", runBench(byState));
+		printBench("row and call, by server", runBench(byServer));
+
+		CallRecord* past = makeRecord(sizes[s] + 1000);
+
+		past->reportedAt = store.get(store.getAt(CALL_VIEW_OLDEST, 0))->reportedAt + 1;
+
+		AddPast addPast(store, past);
+
+		printBench("add, handle and remove a past call", runBench(addPast));
+
+		for (size_t i=0; i < hits.size(); i++)
+		{
+			delete hits[i];
+			delete misses[i];
+		}
+	}
+
+	return 0;
+}
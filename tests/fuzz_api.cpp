@@ -0,0 +1,125 @@
+/**
+ * -----------------------------------------------------
+ * File        fuzz_api.cpp
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+// c++ libs
+#include <string.h>
+#include <vector>
+
+// Project
+#include "api.h"
+#include "fuzzing.h"
+
+
+
+// The decoders of the web API on arbitrary bodies
+//
+// Whatever a webscript sends, a decoder has to return a status without
+// reading or writing outside the body, and what it returns on API_OK has to
+// point into the body. Every string of the result is read once, so the
+// sanitizers see pointers that went wrong.
+
+
+// Lengths read, kept so the reads aren't optimized away
+static volatile size_t readLength;
+
+
+// Read a string of the result completely
+static size_t touch(const char* string)
+{
+	return (string != NULL) ? strlen(string) : 0;
+}
+
+
+// Read the fields of the base response
+static size_t touchResponse(const ApiResponse& response)
+{
+	return touch(response.getErrorType()) + touch(response.getErrorText()) + touch(getFormatName(response.format));
+}
+
+
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+	if (size < 1)
+	{
+		return 0;
+	}
+
+	// Body as the curl thread leaves it: the bytes and a terminator
+	std::vector<char> body(data + 1, data + size);
+
+	if (!body.empty())
+	{
+		body.push_back('\0');
+	}
+
+	size_t read = 0;
+
+	switch (data[0] % FUZZ_API_DECODERS)
+	{
+		case FUZZ_API_NOTICE:
+		{
+			ApiNotice notice;
+
+			decodeNotice("", body, notice);
+			read += touchResponse(notice);
+
+			for (std::vector<ApiCall>::iterator call = notice.calls.begin(); call != notice.calls.end(); ++call)
+			{
+				read += touch(call->callID) + touch(call->fullIP) + touch(call->serverName) + touch(call->targetName);
+				read += touch(call->targetReason) + touch(call->clientName);
+			}
+
+			break;
+		}
+		case FUZZ_API_TRACKERS:
+		{
+			ApiTrackers trackers;
+
+			decodeTrackers("", body, trackers);
+			read += touchResponse(trackers);
+
+			for (std::vector<const char*>::iterator tracker = trackers.trackerIDs.begin(); tracker != trackers.trackerIDs.end(); ++tracker)
+			{
+				read += touch(*tracker);
+			}
+
+			break;
+		}
+		case FUZZ_API_TAKEOVER:
+		{
+			ApiTakeover takeover;
+
+			decodeTakeover("", body, takeover);
+			read += touchResponse(takeover);
+
+			break;
+		}
+	}
+
+	readLength = read;
+
+	return 0;
+}
@@ -0,0 +1,129 @@
+/**
+ * -----------------------------------------------------
+ * File        fuzz_binary.cpp
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+// c++ libs
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+// Project
+#include "api.h"
+#include "fuzzing.h"
+#include "payloads.h"
+
+
+
+// The binary feed of notice.php on arbitrary bytes
+//
+// The input is the feed behind its magic, so every input takes the binary
+// path. A feed has to decode completely or not at all. One that decodes
+// has to survive a round trip: encoded again and decoded, it gives the
+// same calls.
+
+
+// Same strings, as the client sees them
+static bool same(const char* x, const char* y)
+{
+	return strcmp(x, y) == 0;
+}
+
+
+// Same calls?
+static bool same(const ApiNotice& x, const ApiNotice& y)
+{
+	if (x.foundRows != y.foundRows || x.calls.size() != y.calls.size())
+	{
+		return false;
+	}
+
+	for (size_t i=0; i < x.calls.size(); i++)
+	{
+		const ApiCall& a = x.calls[i];
+		const ApiCall& b = y.calls[i];
+
+		if (!same(a.callID, b.callID) || !same(a.fullIP, b.fullIP) || !same(a.serverName, b.serverName) || !same(a.targetName, b.targetName)
+		    || !same(a.targetReason, b.targetReason) || !same(a.clientName, b.clientName)
+		    || a.targetID != b.targetID || a.clientID != b.clientID || a.reportedAt != b.reportedAt || a.handled != b.handled || a.found != b.found)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+// Report a broken invariant, libFuzzer and the driver keep the input on abort
+static void fail(const char* what)
+{
+	fprintf(stderr, "fuzz_binary: %s\n", what);
+
+	abort();
+}
+
+
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+	std::string feed = API_BINARY_MAGIC + std::string((const char*)data, size);
+	std::vector<char> body = toBody(feed);
+	ApiNotice notice;
+
+	API_STATUS status = decodeNotice("", body, notice);
+
+	if (notice.format != API_FORMAT_BINARY)
+	{
+		fail("feed not taken for binary");
+	}
+
+	if (status == API_PARSE_ERROR && !notice.calls.empty())
+	{
+		fail("part of a broken feed decoded");
+	}
+
+	if (status != API_OK)
+	{
+		return 0;
+	}
+
+
+	// Round trip
+	std::vector<char> again = toBody(encodeNotice(notice));
+	ApiNotice decoded;
+
+	if (decodeNotice("", again, decoded) != API_OK)
+	{
+		fail("encoded feed doesn't decode");
+	}
+
+	if (!same(notice, decoded))
+	{
+		fail("round trip changed the calls");
+	}
+
+	return 0;
+}
@@ -0,0 +1,299 @@
+/**
+ * -----------------------------------------------------
+ * File        fuzz_main.cpp
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+// c++ libs
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+	#include <windows.h>
+#else
+	#include <dirent.h>
+	#include <sys/stat.h>
+#endif
+
+// Project
+#include "fuzzing.h"
+
+
+
+// Driver of the fuzz targets without libFuzzer
+//
+// Runs every input of the corpus once and then mutations of them: bytes
+// flipped, inserted, erased or copied from another input, and inputs cut
+// or spliced together. There's no coverage feedback, so it finds less
+// than libFuzzer, but it needs nothing but the compiler and the sanitizers.
+
+
+// Inputs of the corpus
+static std::vector<std::string> corpus;
+
+
+// Mutations, own generator so every seed runs the same everywhere
+static unsigned long long state = 1;
+
+static unsigned int nextRandom(unsigned int limit)
+{
+	state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+
+	return (limit > 0) ? (unsigned int)(state >> 33) % limit : 0;
+}
+
+
+
+// Read an input file
+static void addFile(const std::string& path)
+{
+	FILE* file = fopen(path.c_str(), "rb");
+
+	if (file == NULL)
+	{
+		fprintf(stderr, "Couldn't open %s\n", path.c_str());
+
+		return;
+	}
+
+	std::string input;
+	char buffer[4096];
+	size_t read;
+
+	while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+	{
+		input.append(buffer, read);
+	}
+
+	fclose(file);
+
+	corpus.push_back(input);
+}
+
+
+// Read a file or every file of a directory
+static void addPath(const std::string& path)
+{
+#if defined(_WIN32)
+	WIN32_FIND_DATAA found;
+	HANDLE find = FindFirstFileA((path + "\\*").c_str(), &found);
+
+	if (find == INVALID_HANDLE_VALUE)
+	{
+		addFile(path);
+
+		return;
+	}
+
+	do
+	{
+		if (!(found.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+		{
+			addFile(path + "\\" + found.cFileName);
+		}
+	}
+	while (FindNextFileA(find, &found));
+
+	FindClose(find);
+#else
+	struct stat info;
+
+	if (stat(path.c_str(), &info) != 0 || !S_ISDIR(info.st_mode))
+	{
+		addFile(path);
+
+		return;
+	}
+
+	DIR* dir = opendir(path.c_str());
+	struct dirent* entry;
+
+	while (dir != NULL && (entry = readdir(dir)) != NULL)
+	{
+		if (entry->d_name[0] != '.')
+		{
+			addFile(path + "/" + entry->d_name);
+		}
+	}
+
+	if (dir != NULL)
+	{
+		closedir(dir);
+	}
+#endif
+}
+
+
+
+// Change an input a bit
+static void mutate(std::string& input, size_t maxLength)
+{
+	int changes = 1 + nextRandom(4);
+
+	for (int i=0; i < changes; i++)
+	{
+		size_t at = nextRandom((unsigned int)input.size() + 1);
+
+		switch (nextRandom(7))
+		{
+			// Flip a bit
+			case 0:
+				if (!input.empty())
+				{
+					input[at % input.size()] ^= (char)(1 << nextRandom(8));
+				}
+
+				break;
+
+			// Insert a byte, often one the parsers care about
+			case 1:
+			{
+				const char special[] = "<>/\"\\{}[]:,0123456789 \0\x7f\x80\xff";
+
+				input.insert(at, 1, (nextRandom(2) == 0) ? special[nextRandom(sizeof(special) - 1)] : (char)nextRandom(256));
+
+				break;
+			}
+
+			// Erase some bytes
+			case 2:
+				input.erase(at, 1 + nextRandom(16));
+
+				break;
+
+			// Cut the input
+			case 3:
+				input.resize(at);
+
+				break;
+
+			// Repeat a part
+			case 4:
+			{
+				std::string part = input.substr(at, nextRandom(64));
+
+				input.insert(nextRandom((unsigned int)input.size() + 1), part);
+
+				break;
+			}
+
+			// Take over a part of another input
+			case 5:
+			{
+				const std::string& other = corpus[nextRandom((unsigned int)corpus.size())];
+				size_t from = nextRandom((unsigned int)other.size() + 1);
+
+				input.insert(at, other.substr(from, nextRandom(256)));
+
+				break;
+			}
+
+			// Overwrite with a random value, for lengths and varints
+			case 6:
+				if (!input.empty())
+				{
+					input[at % input.size()] = (char)((nextRandom(2) == 0) ? 0xff : nextRandom(256));
+				}
+
+				break;
+		}
+	}
+
+	if (input.size() > maxLength)
+	{
+		input.resize(maxLength);
+	}
+}
+
+
+// Run an input, as an own buffer so reads behind it are caught
+static void runInput(const std::string& input)
+{
+	std::vector<uint8_t> data(input.begin(), input.end());
+
+	LLVMFuzzerTestOneInput(data.empty() ? NULL : &data[0], data.size());
+}
+
+
+
+int main(int argc, char** argv)
+{
+	unsigned long runs = 100000;
+	size_t maxLength = 1 << 16;
+
+	for (int i=1; i < argc; i++)
+	{
+		if (strncmp(argv[i], "-runs=", 6) == 0)
+		{
+			runs = strtoul(argv[i] + 6, NULL, 10);
+		}
+		else if (strncmp(argv[i], "-seed=", 6) == 0)
+		{
+			state = strtoull(argv[i] + 6, NULL, 10);
+		}
+		else if (strncmp(argv[i], "-max_len=", 9) == 0)
+		{
+			maxLength = strtoul(argv[i] + 9, NULL, 10);
+		}
+		else if (argv[i][0] == '-')
+		{
+			fprintf(stderr, "Ignoring %s\n", argv[i]);
+		}
+		else
+		{
+			addPath(argv[i]);
+		}
+	}
+
+	if (corpus.empty())
+	{
+		corpus.push_back("");
+	}
+
+	for (size_t i=0; i < corpus.size(); i++)
+	{
+		runInput(corpus[i]);
+	}
+
+	for (unsigned long run=corpus.size(); run < runs; run++)
+	{
+		std::string input = corpus[nextRandom((unsigned int)corpus.size())];
+
+		// Splice two inputs now and then
+		if (nextRandom(16) == 0)
+		{
+			const std::string& other = corpus[nextRandom((unsigned int)corpus.size())];
+
+			input = input.substr(0, nextRandom((unsigned int)input.size() + 1)) + other.substr(nextRandom((unsigned int)other.size() + 1));
+		}
+
+		mutate(input, maxLength);
+		runInput(input);
+	}
+
+	printf("Done %lu runs over %d inputs\n", (runs > corpus.size()) ? runs : (unsigned long)corpus.size(), (int)corpus.size());
+
+	return 0;
+}
@@ -0,0 +1,65 @@
+#ifndef FUZZING_H
+#define FUZZING_H
+
+/**
+ * -----------------------------------------------------
+ * File        fuzzing.h
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#pragma once
+
+
+// c++ libs
+#include <stddef.h>
+#include <stdint.h>
+
+
+
+// Fuzz targets
+//
+// Each target is an own program defining LLVMFuzzerTestOneInput. Built with
+// clang++ and -fsanitize=fuzzer it's a libFuzzer target, otherwise
+// fuzz_main.cpp drives it: it runs the inputs given on the command line,
+// files or directories, and then mutations of them.
+//
+//   -runs=N      inputs to run, mutations included
+//   -seed=N      seed of the mutations
+//   -max_len=N   longest mutation
+//
+// make_corpus writes the seeds of every target below tests/build/corpus.
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+
+
+// fuzz_api: the first byte picks the decoder, the rest is the body
+enum FUZZ_API
+{
+	FUZZ_API_NOTICE = 0,
+	FUZZ_API_TRACKERS,
+	FUZZ_API_TAKEOVER,
+
+	FUZZ_API_DECODERS,
+};
+
+
+#endif
@@ -0,0 +1,130 @@
+/**
+ * -----------------------------------------------------
+ * File        make_corpus.cpp
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+// c++ libs
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+// Project
+#include "api.h"
+#include "fuzzing.h"
+#include "payloads.h"
+
+
+
+// Seeds of the fuzz targets
+//
+// Writes valid payloads of every kind into a directory per target, below
+// the directory given. The directories have to exist.
+
+
+// Directory to write to
+static std::string root;
+
+// Seeds written
+static int written = 0;
+
+
+// Write a seed of a target
+static bool writeSeed(const char* target, const std::string& name, const std::string& input)
+{
+	std::string path = root + "/" + target + "/" + name;
+	FILE* file = fopen(path.c_str(), "wb");
+
+	if (file == NULL)
+	{
+		fprintf(stderr, "Couldn't write %s\n", path.c_str());
+
+		return false;
+	}
+
+	bool ok = fwrite(input.data(), 1, input.size(), file) == input.size();
+
+	ok = (fclose(file) == 0) && ok;
+	written++;
+
+	return ok;
+}
+
+
+// Seed of fuzz_api: the decoder and the body
+static bool writeApiSeed(FUZZ_API decoder, const std::string& name, const std::string& payload)
+{
+	return writeSeed("fuzz_api", name, (char)decoder + payload);
+}
+
+
+// Seed of fuzz_binary: the feed behind its magic
+static bool writeBinarySeed(const std::string& name, const std::string& feed)
+{
+	return writeSeed("fuzz_binary", name, feed.substr(strlen(API_BINARY_MAGIC)));
+}
+
+
+
+int main(int argc, char** argv)
+{
+	if (argc != 2)
+	{
+		fprintf(stderr, "Usage: %s <corpus directory>\n", argv[0]);
+
+		return 1;
+	}
+
+	root = argv[1];
+
+	const API_FORMAT formats[] = {API_FORMAT_XML, API_FORMAT_JSON, API_FORMAT_BINARY};
+	const char* names[] = {"xml", "json", "binary"};
+
+	bool ok = true;
+
+	for (int f=0; f < 3; f++)
+	{
+		std::string format = names[f];
+
+		ok = writeApiSeed(FUZZ_API_NOTICE, "notice-empty." + format, makeNotice(formats[f], 0)) && ok;
+		ok = writeApiSeed(FUZZ_API_NOTICE, "notice-one." + format, makeNotice(formats[f], 1)) && ok;
+		ok = writeApiSeed(FUZZ_API_NOTICE, "notice-some." + format, makeNotice(formats[f], 5, 40, 7)) && ok;
+
+		// Binary is notice.php only
+		if (formats[f] != API_FORMAT_BINARY)
+		{
+			ok = writeApiSeed(FUZZ_API_TRACKERS, "trackers-empty." + format, makeTrackers(formats[f], 0)) && ok;
+			ok = writeApiSeed(FUZZ_API_TRACKERS, "trackers-some." + format, makeTrackers(formats[f], 4)) && ok;
+			ok = writeApiSeed(FUZZ_API_TAKEOVER, "takeover-success." + format, makeTakeover(formats[f], true)) && ok;
+			ok = writeApiSeed(FUZZ_API_TAKEOVER, "takeover-error." + format, makeTakeover(formats[f], false)) && ok;
+			ok = writeApiSeed(FUZZ_API_NOTICE, "notice-error." + format, makeTakeover(formats[f], false)) && ok;
+		}
+	}
+
+	ok = writeBinarySeed("empty", makeNotice(API_FORMAT_BINARY, 0)) && ok;
+	ok = writeBinarySeed("one", makeNotice(API_FORMAT_BINARY, 1)) && ok;
+	ok = writeBinarySeed("some", makeNotice(API_FORMAT_BINARY, 8, 60, 3)) && ok;
+
+	printf("Wrote %d seeds to %s\n", written, root.c_str());
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,273 @@
+/**
+ * -----------------------------------------------------
+ * File        payloads.cpp
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+// c++ libs
+#include <stdio.h>
+
+// Project
+#include "payloads.h"
+#include "codec.h"
+
+
+
+// First report time
+#define PAYLOAD_TIME 1500000000L
+
+// Different servers, players and reasons
+#define PAYLOAD_SERVERS 20
+#define PAYLOAD_PLAYERS 200
+#define PAYLOAD_REASONS 10
+
+
+static const char* reasons[PAYLOAD_REASONS] =
+{
+	"Aimbot", "Wallhack", "Spinbot", "Teamkilling", "Spamming",
+	"Insulting admins", "Ghosting", "Micspam", "Griefing", "Exploiting a map bug"
+};
+
+
+
+// Number to a string
+static std::string toText(unsigned long long value)
+{
+	char buffer[32];
+
+	sprintf(buffer, "%llu", value);
+
+	return buffer;
+}
+
+
+// 64bit SteamID of a player
+static unsigned long long playerID(int player)
+{
+	return 76561197960265728ULL + (unsigned long long)(1000 + player) * 2 + (player & 1);
+}
+
+
+// The n-th call
+PayloadCall makeCall(int number, int textLength)
+{
+	PayloadCall call;
+
+	int target = (number * 13) % PAYLOAD_PLAYERS;
+	int client = (number * 31 + 5) % PAYLOAD_PLAYERS;
+
+	call.callID = toText(number + 1);
+	call.fullIP = "10.0." + toText((number * 7) % PAYLOAD_SERVERS) + ".1:27015";
+	call.serverName = "Community Server #" + toText((number * 7) % PAYLOAD_SERVERS) + " | Dust2 only";
+	call.targetName = "Player " + toText(target);
+	call.targetReason = reasons[number % PAYLOAD_REASONS];
+	call.clientName = "Player " + toText(client);
+	call.targetID = playerID(target);
+	call.clientID = playerID(client);
+	call.reportedAt = PAYLOAD_TIME + number * 7L;
+	call.handled = (number % 3 == 0);
+
+	// Long reasons
+	while ((int)call.targetReason.size() < textLength)
+	{
+		call.targetReason += " and some more details about it";
+	}
+
+	return call;
+}
+
+
+// The n-th call as record
+CallRecord* makeRecord(int number, int textLength)
+{
+	PayloadCall call = makeCall(number, textLength);
+
+	CallRecord* record = new CallRecord();
+
+	record->callID = call.callID;
+	record->fullIP = call.fullIP;
+	record->serverName = call.serverName.c_str();
+	record->targetName = call.targetName.c_str();
+	record->targetReason = call.targetReason.c_str();
+	record->clientName = call.clientName.c_str();
+	record->targetID = call.targetID;
+	record->clientID = call.clientID;
+	record->reportedAt = call.reportedAt;
+	record->handled = call.handled;
+
+	return record;
+}
+
+
+
+// STEAM_0:Y:Z of a 64bit SteamID
+static std::string steamText(unsigned long long steamid)
+{
+	char buffer[32];
+
+	formatSteamID(steamid, buffer, sizeof(buffer));
+
+	return buffer;
+}
+
+
+// Field of a record
+static void addField(std::string& out, API_FORMAT format, const char* name, const std::string& value, bool last = false)
+{
+	if (format == API_FORMAT_JSON)
+	{
+		out += (std::string)"\"" + name + "\": \"" + value + "\"" + (last ? "" : ", ");
+	}
+	else
+	{
+		out += (std::string)"\t\t<" + name + ">" + value + "</" + name + ">\n";
+	}
+}
+
+
+// notice.php
+std::string makeNotice(API_FORMAT format, int calls, int textLength, int first)
+{
+	std::string out;
+
+	if (format == API_FORMAT_BINARY)
+	{
+		out = API_BINARY_MAGIC;
+
+		writeVarint(out, calls);
+		writeString(out, "");
+		writeVarint(out, calls);
+
+		for (int i=0; i < calls; i++)
+		{
+			CallRecord* record = makeRecord(first + i, textLength);
+
+			writeCall(out, *record);
+
+			delete record;
+		}
+
+		return out;
+	}
+
+
+	if (format == API_FORMAT_JSON)
+	{
+		out = "{\"foundRows\": \"" + toText(calls) + "\", \"singleReport\": [";
+	}
+	else
+	{
+		out = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<CallAdmin>\n\t<foundRows>" + toText(calls) + "</foundRows>\n";
+	}
+
+	for (int i=0; i < calls; i++)
+	{
+		PayloadCall call = makeCall(first + i, textLength);
+
+		out += (format == API_FORMAT_JSON) ? ((i > 0) ? ", {" : "{") : "\t<singleReport>\n";
+
+		addField(out, format, "callID", call.callID);
+		addField(out, format, "fullIP", call.fullIP);
+		addField(out, format, "serverName", call.serverName);
+		addField(out, format, "targetName", call.targetName);
+		addField(out, format, "targetID", steamText(call.targetID));
+		addField(out, format, "targetReason", call.targetReason);
+		addField(out, format, "clientName", call.clientName);
+		addField(out, format, "clientID", steamText(call.clientID));
+		addField(out, format, "reportedAt", toText(call.reportedAt));
+		addField(out, format, "callHandled", call.handled ? "1" : "0", true);
+
+		out += (format == API_FORMAT_JSON) ? "}" : "\t</singleReport>\n";
+	}
+
+	out += (format == API_FORMAT_JSON) ? "]}" : "</CallAdmin>\n";
+
+	return out;
+}
+
+
+// trackers.php
+std::string makeTrackers(API_FORMAT format, int trackers)
+{
+	std::string out = (format == API_FORMAT_JSON) ? "{\"singleTracker\": [" : "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<CallAdmin>\n";
+
+	for (int i=0; i < trackers; i++)
+	{
+		std::string id = steamText(playerID(i));
+
+		if (format == API_FORMAT_JSON)
+		{
+			out += ((i > 0) ? ", {\"trackerID\": \"" : "{\"trackerID\": \"") + id + "\"}";
+		}
+		else
+		{
+			out += "\t<singleTracker>\n\t\t<trackerID>" + id + "</trackerID>\n\t</singleTracker>\n";
+		}
+	}
+
+	out += (format == API_FORMAT_JSON) ? "]}" : "</CallAdmin>\n";
+
+	return out;
+}
+
+
+// takeover.php
+std::string makeTakeover(API_FORMAT format, bool success)
+{
+	if (format == API_FORMAT_JSON)
+	{
+		return success ? "{\"success\": \"1\"}" : "{\"error\": \"Call is already handled\"}";
+	}
+
+	return success ? "<CallAdmin><success>1</success></CallAdmin>" : "<CallAdmin><error>Call is already handled</error></CallAdmin>";
+}
+
+
+
+// Binary feed of a decoded notice.php
+std::string encodeNotice(const ApiNotice& notice)
+{
+	std::string out = API_BINARY_MAGIC;
+
+	writeVarint(out, (unsigned long long)notice.foundRows);
+	writeString(out, notice.getErrorText());
+	writeVarint(out, notice.calls.size());
+
+	for (size_t i=0; i < notice.calls.size(); i++)
+	{
+		writeCall(out, CallRecord(notice.calls[i]));
+	}
+
+	return out;
+}
+
+
+
+// Body for the decoders
+std::vector<char> toBody(const std::string& payload)
+{
+	std::vector<char> body(payload.begin(), payload.end());
+
+	body.push_back('\0');
+
+	return body;
+}
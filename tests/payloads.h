@@ -0,0 +1,90 @@
+#ifndef PAYLOADS_H
+#define PAYLOADS_H
+
+/**
+ * -----------------------------------------------------
+ * File        payloads.h
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#pragma once
+
+
+// c++ libs
+#include <string>
+#include <vector>
+
+// Project
+#include "api.h"
+#include "callstore.h"
+
+
+
+// Synthetic responses of the web API, the same on every run
+//
+// Calls come from a few servers, players and reasons, like a real feed.
+// textLength pads reasons to long texts, where scanning dominates parsing.
+
+
+// Fields of a synthetic call
+struct PayloadCall
+{
+	std::string callID;
+	std::string fullIP;
+	std::string serverName;
+	std::string targetName;
+	std::string targetReason;
+	std::string clientName;
+
+	unsigned long long targetID;
+	unsigned long long clientID;
+
+	long reportedAt;
+	bool handled;
+};
+
+
+// The n-th call
+PayloadCall makeCall(int number, int textLength = 0);
+
+// The n-th call as record of the store
+CallRecord* makeRecord(int number, int textLength = 0);
+
+
+// notice.php with the calls from a number on
+std::string makeNotice(API_FORMAT format, int calls, int textLength = 0, int first = 0);
+
+// trackers.php
+std::string makeTrackers(API_FORMAT format, int trackers);
+
+// takeover.php
+std::string makeTakeover(API_FORMAT format, bool success);
+
+
+// Binary feed of a decoded notice.php, for round trips
+std::string encodeNotice(const ApiNotice& notice);
+
+
+// Body for the decoders: the bytes and their terminator
+std::vector<char> toBody(const std::string& payload);
+
+
+#endif
@@ -0,0 +1,351 @@
+/**
+ * -----------------------------------------------------
+ * File        standin.cpp
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+// c++ libs
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+// Project
+#include "api.h"
+#include "payloads.h"
+#include "standin.h"
+
+
+
+// Answer of a path nobody knows
+static const std::string notFound;
+
+
+
+StandinServer::StandinServer(int noticeCalls) : listener(-1), port(0), running(false), calls(noticeCalls) {}
+
+StandinServer::~StandinServer()
+{
+	stop();
+}
+
+
+
+// Listen and serve in the background
+bool StandinServer::start(int listenPort)
+{
+	listener = socket(AF_INET, SOCK_STREAM, 0);
+
+	if (listener < 0)
+	{
+		return false;
+	}
+
+	int reuse = 1;
+	setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+	struct sockaddr_in address;
+
+	memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	address.sin_port = htons((unsigned short)listenPort);
+
+	socklen_t length = sizeof(address);
+
+	if (bind(listener, (struct sockaddr*)&address, sizeof(address)) != 0 || listen(listener, 16) != 0 || getsockname(listener, (struct sockaddr*)&address, &length) != 0)
+	{
+		close(listener);
+		listener = -1;
+
+		return false;
+	}
+
+	port = ntohs(address.sin_port);
+	running = true;
+
+	if (pthread_create(&thread, NULL, serve, this) != 0)
+	{
+		running = false;
+		stop();
+
+		return false;
+	}
+
+	return true;
+}
+
+
+// Stop listening, waits for the answer being sent
+void StandinServer::stop()
+{
+	if (listener < 0)
+	{
+		return;
+	}
+
+	// Wakes up accept()
+	shutdown(listener, SHUT_RDWR);
+
+	if (running)
+	{
+		pthread_join(thread, NULL);
+
+		running = false;
+	}
+
+	close(listener);
+	listener = -1;
+}
+
+
+
+// Accept connections until the listener is shut down
+void* StandinServer::serve(void* server)
+{
+	StandinServer* standin = (StandinServer*)server;
+
+	for (;;)
+	{
+		int connection = accept(standin->listener, NULL, NULL);
+
+		if (connection < 0)
+		{
+			return NULL;
+		}
+
+		standin->answer(connection);
+
+		close(connection);
+	}
+}
+
+
+// Write all of a buffer
+static bool sendAll(int connection, const char* data, size_t length)
+{
+	while (length > 0)
+	{
+		ssize_t sent = send(connection, data, length, MSG_NOSIGNAL);
+
+		if (sent <= 0)
+		{
+			return false;
+		}
+
+		data += sent;
+		length -= sent;
+	}
+
+	return true;
+}
+
+
+// Read the request of a connection and answer it
+void StandinServer::answer(int connection)
+{
+	std::string request;
+	char buffer[2048];
+
+	while (request.find("\r\n\r\n") == std::string::npos && request.size() < 65536)
+	{
+		ssize_t received = recv(connection, buffer, sizeof(buffer), 0);
+
+		if (received <= 0)
+		{
+			return;
+		}
+
+		request.append(buffer, received);
+	}
+
+	// GET <path> HTTP/1.x
+	size_t pathStart = request.find(' ');
+	size_t pathEnd = (pathStart != std::string::npos) ? request.find(' ', pathStart + 1) : std::string::npos;
+
+	if (request.compare(0, 4, "GET ") != 0 || pathEnd == std::string::npos)
+	{
+		const char badRequest[] = "HTTP/1.0 400 Bad Request\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+
+		sendAll(connection, badRequest, sizeof(badRequest) - 1);
+
+		return;
+	}
+
+	const std::string& payload = getPayload(request.substr(pathStart + 1, pathEnd - pathStart - 1));
+
+	char header[256];
+
+	if (&payload == &notFound)
+	{
+		snprintf(header, sizeof(header), "HTTP/1.0 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+	}
+	else
+	{
+		snprintf(header, sizeof(header), "HTTP/1.0 200 OK\r\nContent-Type: text/plain\r\nContent-Length: %lu\r\nConnection: close\r\n\r\n", (unsigned long)payload.size());
+	}
+
+	// Header and body at once, so there's no delay between them
+	std::string response = header + payload;
+
+	sendAll(connection, response.data(), response.size());
+}
+
+
+
+// Value of a parameter of the query, empty if there's none
+static std::string getParameter(const std::string& path, const char* name)
+{
+	std::string key = (std::string)name + "=";
+
+	for (size_t at = path.find('?'); at != std::string::npos; at = path.find('&', at + 1))
+	{
+		if (path.compare(at + 1, key.size(), key) == 0)
+		{
+			size_t end = path.find('&', at + 1);
+
+			return path.substr(at + 1 + key.size(), (end == std::string::npos) ? std::string::npos : end - at - 1 - key.size());
+		}
+	}
+
+	return "";
+}
+
+
+// Payload of a path
+const std::string& StandinServer::getPayload(const std::string& path)
+{
+	std::string format = getParameter(path, "format");
+	API_FORMAT apiFormat = (format == "json") ? API_FORMAT_JSON : ((format == "binary") ? API_FORMAT_BINARY : API_FORMAT_XML);
+
+	std::string page = path.substr(0, path.find('?'));
+
+	// Only notice.php knows the binary feed
+	if (page != "/notice.php" && apiFormat == API_FORMAT_BINARY)
+	{
+		apiFormat = API_FORMAT_XML;
+	}
+
+	int noticeCalls = calls;
+	std::string limit = getParameter(path, "limit");
+
+	if (!limit.empty() && atoi(limit.c_str()) < noticeCalls)
+	{
+		noticeCalls = atoi(limit.c_str());
+	}
+
+	char key[64];
+	snprintf(key, sizeof(key), "%d %d", (int)apiFormat, noticeCalls);
+
+	std::string cacheKey = page + " " + key;
+	std::map<std::string, std::string>::iterator cached = payloads.find(cacheKey);
+
+	if (cached != payloads.end())
+	{
+		return cached->second;
+	}
+
+	if (page == "/notice.php")
+	{
+		return payloads[cacheKey] = makeNotice(apiFormat, noticeCalls);
+	}
+	else if (page == "/trackers.php")
+	{
+		return payloads[cacheKey] = makeTrackers(apiFormat, 10);
+	}
+	else if (page == "/takeover.php")
+	{
+		return payloads[cacheKey] = makeTakeover(apiFormat, true);
+	}
+
+	return notFound;
+}
+
+
+
+// GET over a new connection, as curl does for every request
+bool standinFetch(int port, const std::string& path, std::vector<char>& body)
+{
+	body.clear();
+
+	int connection = socket(AF_INET, SOCK_STREAM, 0);
+
+	if (connection < 0)
+	{
+		return false;
+	}
+
+	int noDelay = 1;
+	setsockopt(connection, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+	struct sockaddr_in address;
+
+	memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	address.sin_port = htons((unsigned short)port);
+
+	std::string request = "GET " + path + " HTTP/1.0\r\nHost: 127.0.0.1\r\n\r\n";
+
+	if (connect(connection, (struct sockaddr*)&address, sizeof(address)) != 0 || !sendAll(connection, request.data(), request.size()))
+	{
+		close(connection);
+
+		return false;
+	}
+
+	// Whole response until the server closes
+	char buffer[16384];
+	ssize_t received;
+
+	while ((received = recv(connection, buffer, sizeof(buffer), 0)) > 0)
+	{
+		body.insert(body.end(), buffer, buffer + received);
+	}
+
+	close(connection);
+
+	// Drop the header, keep the body
+	const char separator[] = "\r\n\r\n";
+	std::vector<char>::iterator start = std::search(body.begin(), body.end(), separator, separator + 4);
+
+	if (received < 0 || start == body.end() || body.size() < 12 || memcmp(&body[9], "200", 3) != 0)
+	{
+		body.clear();
+
+		return false;
+	}
+
+	body.erase(body.begin(), start + 4);
+
+	if (!body.empty())
+	{
+		body.push_back('\0');
+	}
+
+	return true;
+}
@@ -0,0 +1,89 @@
+#ifndef STANDIN_H
+#define STANDIN_H
+
+/**
+ * -----------------------------------------------------
+ * File        standin.h
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#pragma once
+
+
+// c++ libs
+#include <map>
+#include <string>
+#include <vector>
+#include <pthread.h>
+
+
+
+// A stand-in for the web API on the loopback interface
+//
+// Answers notice.php, trackers.php and takeover.php with the synthetic
+// payloads in the format the URL asks for, so the client and the
+// benchmarks can talk HTTP without a webserver. One connection at a time,
+// each closed after its answer. POSIX sockets only.
+class StandinServer
+{
+private:
+	int listener;
+	int port;
+
+	pthread_t thread;
+	bool running;
+
+	// Calls of notice.php unless its limit is lower
+	int calls;
+
+	// Payloads by page and format, made once
+	std::map<std::string, std::string> payloads;
+
+	static void* serve(void* server);
+
+	void answer(int connection);
+
+	// No copies
+	StandinServer(const StandinServer&);
+	StandinServer& operator=(const StandinServer&);
+
+public:
+	StandinServer(int noticeCalls = 100);
+	~StandinServer();
+
+	// Listen on a port, 0 for any free one
+	bool start(int listenPort = 0);
+	void stop();
+
+	int getPort() const {return port;}
+
+	// Body of the answer to a path with query, empty if there's no such page
+	const std::string& getPayload(const std::string& path);
+};
+
+
+
+// GET a path from the stand-in, the body followed by a NUL as the curl
+// thread leaves it. Returns false if the transfer failed.
+bool standinFetch(int port, const std::string& path, std::vector<char>& body);
+
+
+#endif
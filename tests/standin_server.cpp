@@ -0,0 +1,62 @@
+/**
+ * -----------------------------------------------------
+ * File        standin_server.cpp
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+// c++ libs
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// Project
+#include "standin.h"
+
+
+
+// The stand-in web API as a program, to point a client at
+//
+//   standin_server [port] [calls]
+//
+// Then set the page of the client to http://127.0.0.1:<port>, any key is
+// fine. notice.php answers with the given number of calls.
+int main(int argc, char** argv)
+{
+	int port = (argc > 1) ? atoi(argv[1]) : 8080;
+	int calls = (argc > 2) ? atoi(argv[2]) : 100;
+
+	StandinServer server(calls);
+
+	if (!server.start(port))
+	{
+		fprintf(stderr, "Couldn't listen on port %d\n", port);
+
+		return 1;
+	}
+
+	printf("Serving %d calls on http://127.0.0.1:%d\n", calls, server.getPort());
+
+	for (;;)
+	{
+		pause();
+	}
+}
@@ -0,0 +1,319 @@
+/**
+ * -----------------------------------------------------
+ * File        test_api.cpp
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+// c++ libs
+#include <string.h>
+
+// Project
+#include "api.h"
+#include "payloads.h"
+#include "testing.h"
+
+
+
+// Decoded calls against the ones the payload was made of
+static void checkCalls(const ApiNotice& notice, int calls, int textLength)
+{
+	CHECK(notice.foundRows == calls);
+	CHECK((int)notice.calls.size() == calls);
+
+	for (size_t i=0; i < notice.calls.size(); i++)
+	{
+		const ApiCall& call = notice.calls[i];
+		PayloadCall expected = makeCall((int)i, textLength);
+
+		CHECK(call.found == API_CALL_FIELDS);
+		CHECK(expected.callID == call.callID);
+		CHECK(expected.fullIP == call.fullIP);
+		CHECK(expected.serverName == call.serverName);
+		CHECK(expected.targetName == call.targetName);
+		CHECK(expected.targetReason == call.targetReason);
+		CHECK(expected.clientName == call.clientName);
+		CHECK(expected.targetID == call.targetID);
+		CHECK(expected.clientID == call.clientID);
+		CHECK(expected.reportedAt == call.reportedAt);
+		CHECK(expected.handled == call.handled);
+	}
+}
+
+
+
+// Every format decodes to the same calls
+static void testNotice()
+{
+	const API_FORMAT formats[] = {API_FORMAT_XML, API_FORMAT_JSON, API_FORMAT_BINARY};
+
+	for (int f=0; f < 3; f++)
+	{
+		for (int calls=0; calls <= 50; calls += 25)
+		{
+			std::vector<char> body = toBody(makeNotice(formats[f], calls, (calls == 50) ? 500 : 0));
+			ApiNotice notice;
+
+			CHECK(decodeNotice("", body, notice) == API_OK);
+			CHECK(notice.format == formats[f]);
+			CHECK(notice.error == NULL);
+
+			checkCalls(notice, calls, (calls == 50) ? 500 : 0);
+		}
+	}
+}
+
+
+// The body is only as big as the response and its terminator
+static void testExactBody()
+{
+	// A value right at the end of the body is terminated in the terminator's
+	// place, AddressSanitizer sees any write behind it
+	std::vector<char> body = toBody("{\"success\": 1}");
+
+	ApiTakeover takeover;
+
+	CHECK(decodeTakeover("", body, takeover) == API_OK);
+	CHECK(takeover.success);
+	CHECK(takeover.format == API_FORMAT_JSON);
+
+
+	// The last string of a binary feed ends at the end of the body
+	std::string payload = makeNotice(API_FORMAT_BINARY, 1);
+
+	body = toBody(payload);
+
+	ApiNotice notice;
+
+	CHECK(decodeNotice("", body, notice) == API_OK);
+	CHECK(notice.calls.size() == 1);
+	CHECK(body.size() == payload.size() + 1);
+}
+
+
+// Failures set their status and error
+static void testErrors()
+{
+	std::vector<char> empty;
+	ApiNotice notice;
+
+	CHECK(decodeNotice("", empty, notice) == API_CONNECTION_ERROR);
+	CHECK(notice.getErrorMessage() == "CURL Error: Couldn't init. CURL connection");
+
+
+	std::vector<char> body = toBody(makeNotice(API_FORMAT_XML, 3));
+	ApiNotice failed;
+
+	CHECK(decodeNotice("Timeout was reached", body, failed) == API_CONNECTION_ERROR);
+	CHECK(strcmp(failed.getErrorText(), "Timeout was reached") == 0);
+
+
+	body = toBody("<CallAdmin><foundRows>1</foundRows>");
+	ApiNotice broken;
+
+	CHECK(decodeNotice("", body, broken) == API_PARSE_ERROR);
+	CHECK(strcmp(broken.getErrorType(), "XML") == 0);
+
+
+	body = toBody("{\"foundRows\": [1, 2");
+	ApiNotice brokenJson;
+
+	CHECK(decodeNotice("", body, brokenJson) == API_PARSE_ERROR);
+	CHECK(strcmp(brokenJson.getErrorType(), "JSON") == 0);
+
+
+	// Cut off feeds never decode to part of the calls
+	std::string binary = makeNotice(API_FORMAT_BINARY, 5);
+
+	for (size_t length = 4; length < binary.size(); length++)
+	{
+		body = toBody(binary.substr(0, length));
+		ApiNotice cut;
+
+		CHECK(decodeNotice("", body, cut) == API_PARSE_ERROR);
+		CHECK(cut.calls.empty());
+	}
+
+
+	body = toBody(makeTakeover(API_FORMAT_XML, false));
+	ApiTakeover takeover;
+
+	CHECK(decodeTakeover("", body, takeover) == API_ERROR);
+	CHECK(!takeover.success);
+	CHECK(takeover.getErrorMessage() == "API Error: Call is already handled");
+}
+
+
+// trackers.php in both text formats
+static void testTrackers()
+{
+	const API_FORMAT formats[] = {API_FORMAT_XML, API_FORMAT_JSON};
+
+	for (int f=0; f < 2; f++)
+	{
+		std::vector<char> body = toBody(makeTrackers(formats[f], 12));
+		ApiTrackers trackers;
+
+		CHECK(decodeTrackers("", body, trackers) == API_OK);
+		CHECK(trackers.trackerIDs.size() == 12);
+
+		for (size_t i=0; i < trackers.trackerIDs.size(); i++)
+		{
+			CHECK(parseSteamID(trackers.trackerIDs[i]) == 76561197960265728ULL + (1000 + i) * 2 + (i & 1));
+		}
+	}
+}
+
+
+// takeover.php in both text formats
+static void testTakeover()
+{
+	const API_FORMAT formats[] = {API_FORMAT_XML, API_FORMAT_JSON};
+
+	for (int f=0; f < 2; f++)
+	{
+		std::vector<char> body = toBody(makeTakeover(formats[f], true));
+		ApiTakeover takeover;
+
+		CHECK(decodeTakeover("", body, takeover) == API_OK);
+		CHECK(takeover.success);
+		CHECK(takeover.format == formats[f]);
+	}
+}
+
+
+// Shortest cut of a text response which isn't complete
+// A lone XML declaration is an empty answer, so cuts start in the root
+static size_t firstCut(API_FORMAT format, const std::string& payload)
+{
+	return (format == API_FORMAT_XML) ? payload.find("<CallAdmin") + 1 : 1;
+}
+
+
+// Cut off text responses fail as a whole, whatever the cut
+static void testTruncated()
+{
+	const API_FORMAT formats[] = {API_FORMAT_XML, API_FORMAT_JSON};
+
+	for (int f=0; f < 2; f++)
+	{
+		std::string payload = makeNotice(formats[f], 3);
+
+		for (size_t length = firstCut(formats[f], payload); length + 1 < payload.size(); length++)
+		{
+			std::vector<char> body = toBody(payload.substr(0, length));
+			ApiNotice cut;
+
+			CHECK(decodeNotice("", body, cut) == API_PARSE_ERROR);
+		}
+
+		payload = makeTrackers(formats[f], 3);
+
+		for (size_t length = firstCut(formats[f], payload); length + 1 < payload.size(); length++)
+		{
+			std::vector<char> body = toBody(payload.substr(0, length));
+			ApiTrackers cut;
+
+			CHECK(decodeTrackers("", body, cut) == API_PARSE_ERROR);
+		}
+	}
+}
+
+
+// A decoded binary feed encodes to the same bytes again
+static void testBinaryRoundTrip()
+{
+	std::string feed = makeNotice(API_FORMAT_BINARY, 20, 100, 4);
+	std::vector<char> body = toBody(feed);
+	ApiNotice notice;
+
+	CHECK(decodeNotice("", body, notice) == API_OK);
+	CHECK(encodeNotice(notice) == feed);
+}
+
+
+// URLs ask for JSON unless told otherwise
+static void testURLs()
+{
+	ApiNoticeRequest notice;
+
+	notice.initial = true;
+	notice.limit = 25;
+
+	CHECK(buildURL("http://x", "k", notice) == "http://x/notice.php?from=0&from_type=unixtime&key=k&sort=desc&limit=25&format=json");
+
+	notice.format = API_FORMAT_BINARY;
+	CHECK(buildURL("http://x", "k", notice) == "http://x/notice.php?from=0&from_type=unixtime&key=k&sort=desc&limit=25&format=binary");
+
+	notice.format = API_FORMAT_XML;
+	CHECK(buildURL("http://x", "k", notice) == "http://x/notice.php?from=0&from_type=unixtime&key=k&sort=desc&limit=25");
+
+
+	ApiTrackersRequest trackers;
+
+	trackers.interval = 60;
+	CHECK(buildURL("http://x", "k", trackers) == "http://x/trackers.php?from=60&from_type=interval&key=k&format=json");
+
+
+	ApiTakeoverRequest takeover;
+
+	takeover.callID = "7";
+	CHECK(buildURL("http://x", "k", takeover) == "http://x/takeover.php?callid=7&key=k&format=json");
+
+	takeover.format = API_FORMAT_XML;
+	CHECK(buildURL("http://x", "k", takeover) == "http://x/takeover.php?callid=7&key=k");
+}
+
+
+// SteamID conversions
+static void testSteamIDs()
+{
+	char buffer[32];
+
+	CHECK(parseSteamID("STEAM_0:1:12345") == 76561197960265728ULL + 12345 * 2 + 1);
+	CHECK(parseSteamID("STEAM_1:0:7") == 76561197960265728ULL + 14);
+	CHECK(parseSteamID("STEAM_0:2:1") == 0);
+	CHECK(parseSteamID("STEAM_0:0:0") == 0);
+	CHECK(parseSteamID("garbage") == 0);
+
+	formatSteamID(76561197960265728ULL + 12345 * 2 + 1, buffer, sizeof(buffer));
+	CHECK(strcmp(buffer, "STEAM_0:1:12345") == 0);
+
+	formatSteamID(5, buffer, sizeof(buffer));
+	CHECK(buffer[0] == '\0');
+}
+
+
+
+int main()
+{
+	testNotice();
+	testExactBody();
+	testErrors();
+	testTrackers();
+	testTakeover();
+	testTruncated();
+	testBinaryRoundTrip();
+	testURLs();
+	testSteamIDs();
+
+	return checkExit();
+}
@@ -0,0 +1,305 @@
+/**
+ * -----------------------------------------------------
+ * File        test_callindex.cpp
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+// c++ libs
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+// Project
+#include "callindex.h"
+#include "payloads.h"
+#include "testing.h"
+
+
+
+// 64bit SteamID of an account
+#define STEAMID(account) (76561197960265728ULL + (account))
+
+
+
+// Documents of the small index, not dense on purpose
+static const unsigned int documents[] = {2, 5, 9, 14};
+
+// Fields of its calls
+static const char* fields[][5] =
+{
+	// Server, target, reason, client, callID
+	{"Dust2 Community", "Alice", "Aimbot", "Bob", "1"},
+	{"Office Server", "Bob", "Wallhack and AIMBOT", "Carol", "2"},
+	{"Dust2 Community", "Carol", "Spamming", "Alice", "3"},
+	{"Italy Server", "Dave", "Wallhacking", "Eve", "4"},
+};
+
+// SteamIDs of target and client
+static const unsigned long long ids[][2] =
+{
+	{STEAMID(11), STEAMID(12)},
+	{STEAMID(12), STEAMID(13)},
+	{STEAMID(13), STEAMID(11)},
+	{STEAMID(14), STEAMID(15)},
+};
+
+
+
+// Index of the four calls above
+static void makeIndex(CallIndex& index)
+{
+	for (int i=0; i < 4; i++)
+	{
+		CallRecord record;
+
+		record.serverName = fields[i][0];
+		record.targetName = fields[i][1];
+		record.targetReason = fields[i][2];
+		record.clientName = fields[i][3];
+		record.callID = fields[i][4];
+		record.targetID = ids[i][0];
+		record.clientID = ids[i][1];
+		record.reportedAt = 1500000000L + i;
+
+		index.add(documents[i], record);
+	}
+}
+
+
+// Documents a query finds, newest first
+static std::vector<unsigned int> search(const CallIndex& index, const char* query, size_t limit = 100)
+{
+	std::vector<unsigned int> results;
+
+	index.search(query, results, limit);
+
+	return results;
+}
+
+
+// The expected documents, by number of the call
+static std::vector<unsigned int> expect(int first = -1, int second = -1, int third = -1)
+{
+	std::vector<unsigned int> result;
+	int calls[] = {first, second, third};
+
+	for (int i=0; i < 3; i++)
+	{
+		if (calls[i] != -1)
+		{
+			result.push_back(documents[calls[i]]);
+		}
+	}
+
+	return result;
+}
+
+
+
+// Whole words find the calls holding them, whatever their case
+static void testWords()
+{
+	CallIndex index;
+
+	makeIndex(index);
+
+	CHECK(index.getCount() == 4);
+
+	CHECK(search(index, "aimbot ") == expect(1, 0));
+	CHECK(search(index, "AimBot ") == expect(1, 0));
+	CHECK(search(index, "wallhack ") == expect(1));
+	CHECK(search(index, "alice ") == expect(2, 0));
+	CHECK(search(index, "dust2 ") == expect(2, 0));
+	CHECK(search(index, "eve ") == expect(3));
+
+	// Nothing, or nothing to look for
+	CHECK(search(index, "zyx ").empty());
+	CHECK(search(index, "").empty());
+	CHECK(search(index, "  ,. ").empty());
+
+	// The newest ones up to the limit
+	CHECK(search(index, "server ", 1) == expect(3));
+	CHECK(search(index, "server ", 5) == expect(3, 1));
+}
+
+
+// All words of a query have to match
+static void testAnd()
+{
+	CallIndex index;
+
+	makeIndex(index);
+
+	CHECK(search(index, "dust2 alice ") == expect(2, 0));
+	CHECK(search(index, "dust2 aimbot ") == expect(0));
+	CHECK(search(index, "aimbot carol ") == expect(1));
+	CHECK(search(index, "office  bob   wallhack ") == expect(1));
+	CHECK(search(index, "dust2 eve ").empty());
+
+	// Split at anything that isn't a word character
+	CHECK(search(index, "dust2,aimbot ") == expect(0));
+}
+
+
+// The last word also matches as a prefix while it's typed
+static void testPrefix()
+{
+	CallIndex index;
+
+	makeIndex(index);
+
+	CHECK(search(index, "wall") == expect(3, 1));
+	CHECK(search(index, "wallhacki") == expect(3));
+	CHECK(search(index, "a") == expect(2, 1, 0));
+	CHECK(search(index, "server it") == expect(3));
+	CHECK(search(index, "dust2 c") == expect(2, 0));
+
+	// Only the last word
+	CHECK(search(index, "wall server").empty());
+	CHECK(search(index, "wallhack server") == expect(1));
+}
+
+
+// A STEAM_X:Y:Z is looked up as its 64bit SteamID, target or client
+static void testSteamID()
+{
+	CallIndex index;
+
+	makeIndex(index);
+
+	char steamid[32];
+
+	formatSteamID(STEAMID(12), steamid, sizeof(steamid));
+
+	CHECK(search(index, steamid) == expect(1, 0));
+	CHECK(search(index, ((std::string)steamid + " office").c_str()) == expect(1));
+
+	formatSteamID(STEAMID(14), steamid, sizeof(steamid));
+
+	std::string lower = steamid;
+
+	lower.replace(0, 5, "steam");
+
+	CHECK(search(index, lower.c_str()) == expect(3));
+	CHECK(search(index, "76561197960265739") == expect(2, 0));
+
+	formatSteamID(STEAMID(99), steamid, sizeof(steamid));
+
+	CHECK(search(index, steamid).empty());
+}
+
+
+// Does a call hold all words of a query, the last one as a prefix if wanted?
+static bool matches(const CallRecord& record, const std::vector<std::string>& query, bool prefix)
+{
+	std::vector<std::string> words;
+	char steamid[32];
+
+	CallIndex::split(record.serverName.str(), words);
+	CallIndex::split(record.targetName.str(), words);
+	CallIndex::split(record.clientName.str(), words);
+	CallIndex::split(record.targetReason.str(), words);
+
+	sprintf(steamid, "%llu", record.targetID);
+	words.push_back(steamid);
+
+	sprintf(steamid, "%llu", record.clientID);
+	words.push_back(steamid);
+
+	for (size_t i=0; i < query.size(); i++)
+	{
+		bool found = false;
+
+		for (size_t j=0; j < words.size() && !found; j++)
+		{
+			found = (prefix && i == query.size() - 1) ? (words[j].compare(0, query[i].size(), query[i]) == 0) : (words[j] == query[i]);
+		}
+
+		if (!found)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+// Many calls find the same as checking each of them, with few and with
+// many matches and with words added after the index was sorted
+static void testMany()
+{
+	static const char* queries[] = {"player 1", "player 17 ", "community 3", "dust2 wall", "7656119", "ex", "a", "micspam spinbot", "insulting admins"};
+
+	CallIndex index;
+	std::vector<CallRecord*> records;
+
+	for (int round=0; round < 2; round++)
+	{
+		for (int i = round * 2000; i < (round + 1) * 2000; i++)
+		{
+			records.push_back(makeRecord(i));
+
+			index.add((unsigned int)(i * 3), *records.back());
+		}
+
+		for (size_t q=0; q < sizeof(queries) / sizeof(queries[0]); q++)
+		{
+			std::vector<std::string> words;
+			std::vector<unsigned int> expected;
+
+			// A trailing space makes the last word whole
+			bool prefix = (queries[q][strlen(queries[q]) - 1] != ' ');
+
+			CallIndex::split(queries[q], words);
+
+			for (size_t i = records.size(); i > 0; i--)
+			{
+				if (matches(*records[i - 1], words, prefix))
+				{
+					expected.push_back((unsigned int)((i - 1) * 3));
+				}
+			}
+
+			CHECK(search(index, queries[q], records.size()) == expected);
+		}
+	}
+
+	for (size_t i=0; i < records.size(); i++)
+	{
+		delete records[i];
+	}
+}
+
+
+
+int main()
+{
+	testWords();
+	testAnd();
+	testPrefix();
+	testSteamID();
+	testMany();
+
+	return checkExit();
+}
@@ -0,0 +1,244 @@
+/**
+ * -----------------------------------------------------
+ * File        test_callstats.cpp
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+// c++ libs
+#include <stdio.h>
+#include <time.h>
+#include <string>
+
+// Project
+#include "callstats.h"
+#include "testing.h"
+
+
+
+// 64bit SteamID of an account
+#define STEAMID(account) (76561197960265728ULL + (account))
+
+// Report time of the calls
+#define STATS_TIME 1500000000L
+
+
+
+// A call on a server for a reason, of a player
+static CallRecord* makeCall(const char* server, const char* reason, unsigned long long steamid, long reportedAt, bool handled = false)
+{
+	CallRecord* record = new CallRecord();
+	char name[32];
+
+	sprintf(name, "Player %llu", steamid - STEAMID(0));
+
+	record->callID = "1";
+	record->serverName = server;
+	record->targetReason = reason;
+	record->targetName = name;
+	record->targetID = steamid;
+	record->reportedAt = reportedAt;
+	record->handled = handled;
+
+	return record;
+}
+
+
+// Count a call, and its handling if handledAt isn't -1
+static void addCall(CallStats& stats, const char* server, const char* reason, unsigned long long steamid, long reportedAt, long handledAt = -1)
+{
+	CallRecord* record = makeCall(server, reason, steamid, reportedAt);
+
+	stats.addCall(*record);
+
+	if (handledAt != -1)
+	{
+		stats.addHandled(*record, handledAt);
+	}
+
+	delete record;
+}
+
+
+// Does the CSV have the line?
+static bool hasLine(const std::string& csv, const std::string& line)
+{
+	return csv.find("\n" + line + "\n") != std::string::npos;
+}
+
+
+// Hour of the day a call is counted in
+static int hourOf(long reportedAt)
+{
+	time_t tt = (time_t)reportedAt;
+
+	return localtime(&tt)->tm_hour;
+}
+
+
+
+// Calls and handlings are counted per server and reason, the handling
+// time goes into the average and its bucket
+static void testCounts()
+{
+	CallStats stats;
+
+	// 6 on A, 4 on B, 2 of them came in handled
+	for (int i=0; i < 10; i++)
+	{
+		CallRecord* record = makeCall((i < 6) ? "Server A" : "Server B", (i % 2 == 0) ? "Aimbot" : "Wallhack", STEAMID(i), STATS_TIME, i == 7 || i == 8);
+
+		stats.addCall(*record);
+
+		delete record;
+	}
+
+	// Handled after 30 seconds, 5 minutes, 2 hours and at an unknown time
+	addCall(stats, "Server A", "Aimbot", STEAMID(20), STATS_TIME, STATS_TIME + 30);
+	addCall(stats, "Server A", "Spamming", STEAMID(21), STATS_TIME, STATS_TIME + 5 * 60);
+	addCall(stats, "Server B", "Aimbot", STEAMID(22), STATS_TIME, STATS_TIME + 2 * 3600);
+	addCall(stats, "Server B", "Aimbot", STEAMID(23), STATS_TIME, 0);
+
+	const CallCounts& total = stats.getTotal();
+
+	CHECK(total.calls == 14);
+	CHECK(total.handled == 6);
+	CHECK(total.timed == 3);
+	CHECK(total.handleTime == 30 + 5 * 60 + 2 * 3600);
+
+	// Up to 1, 2, 4, 8 ... minutes
+	for (int i=0; i < STATS_TIME_BUCKETS; i++)
+	{
+		CHECK(total.timeBuckets[i] == ((i == 0 || i == 3 || i == 7) ? 1U : 0U));
+	}
+
+	std::string csv = stats.getCSV();
+
+	CHECK(hasLine(csv, "total,,14,6,3,2510"));
+	CHECK(hasLine(csv, "server,\"Server A\",8,2,2,165"));
+	CHECK(hasLine(csv, "server,\"Server B\",6,4,1,7200"));
+	CHECK(hasLine(csv, "reason,\"Aimbot\",8,4,2,3615"));
+	CHECK(hasLine(csv, "reason,\"Wallhack\",5,1,0,0"));
+	CHECK(hasLine(csv, "reason,\"Spamming\",1,1,1,300"));
+	CHECK(hasLine(csv, "handling_time,\"< 1 min\",1,,,"));
+	CHECK(hasLine(csv, "handling_time,\"< 8 min\",1,,,"));
+	CHECK(hasLine(csv, "handling_time,\"< 128 min\",1,,,"));
+
+	// Most calls first
+	CHECK(csv.find("server,\"Server A\"") < csv.find("server,\"Server B\""));
+
+	// A call without a server counts as "-"
+	addCall(stats, "", "Aimbot", 0, STATS_TIME);
+
+	CHECK(hasLine(stats.getCSV(), "server,\"-\",1,0,0,0"));
+}
+
+
+// Calls are counted by the hour of the day they were reported in
+static void testHours()
+{
+	CallStats stats;
+
+	int expected[24] = {0};
+
+	for (int i=0; i < 100; i++)
+	{
+		long reportedAt = STATS_TIME + (long)i * 1234;
+
+		addCall(stats, "Server", "Reason", STEAMID(1), reportedAt);
+
+		expected[hourOf(reportedAt)]++;
+	}
+
+	std::string csv = stats.getCSV();
+
+	for (int hour=0; hour < 24; hour++)
+	{
+		char line[32];
+
+		sprintf(line, "hour,%02d,%d,,,", hour, expected[hour]);
+
+		CHECK(hasLine(csv, line));
+	}
+}
+
+
+// The most reported players are found among many reported once, their
+// estimates are never too low and with this few players exact
+static void testTopPlayers()
+{
+	CallStats stats;
+
+	// Players 1..12 reported 10 * n times, between 3000 others reported once
+	for (int round=0; round < 120; round++)
+	{
+		for (int player=1; player <= 12; player++)
+		{
+			if (round < player * 10)
+			{
+				addCall(stats, "Server", "Reason", STEAMID(player), STATS_TIME);
+			}
+		}
+
+		for (int i=0; i < 25; i++)
+		{
+			addCall(stats, "Server", "Reason", STEAMID(1000 + round * 25 + i), STATS_TIME);
+		}
+	}
+
+	const std::vector<ReportedPlayer>& top = stats.getTopPlayers();
+
+	CHECK(top.size() == STATS_TOP_PLAYERS);
+
+	for (size_t i=0; i < top.size(); i++)
+	{
+		unsigned long long player = top[i].steamID - STEAMID(0);
+
+		// The 10 of them reported most
+		CHECK(player >= 3 && player <= 12);
+
+		CHECK(top[i].reports >= player * 10 && top[i].reports <= player * 10 + 2);
+
+		char name[32];
+
+		sprintf(name, "Player %llu", player);
+
+		CHECK(top[i].name == name);
+	}
+
+	// Cleared with the rest
+	stats.clear();
+
+	CHECK(stats.getTopPlayers().empty());
+	CHECK(stats.getTotal().calls == 0);
+	CHECK(stats.getCSV().find("server,") == std::string::npos);
+}
+
+
+
+int main()
+{
+	testCounts();
+	testHours();
+	testTopPlayers();
+
+	return checkExit();
+}
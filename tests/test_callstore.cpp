@@ -0,0 +1,541 @@
+/**
+ * -----------------------------------------------------
+ * File        test_callstore.cpp
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+// c++ libs
+#include <stdio.h>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+// Project
+#include "callstore.h"
+#include "payloads.h"
+#include "testing.h"
+
+
+
+// Duplicates are found by callID and reportedAt, whatever else differs
+static void testFind()
+{
+	CallStore store;
+
+	for (int i=0; i < 100; i++)
+	{
+		CHECK(store.add(makeRecord(i)) != INVALID_CALL);
+	}
+
+	CHECK(store.getCount() == 100);
+
+	for (int i=0; i < 100; i++)
+	{
+		CallRecord* probe = makeRecord(i);
+
+		probe->handled = !probe->handled;
+		probe->serverName = "Another server";
+
+		CallHandle found = store.find(*probe);
+
+		CHECK(found != INVALID_CALL);
+		CHECK(found != INVALID_CALL && *store.get(found) == *probe);
+
+		// Same ID at another time is another call
+		probe->reportedAt++;
+		CHECK(store.find(*probe) == INVALID_CALL);
+
+		delete probe;
+	}
+
+	CallRecord* missing = makeRecord(1000);
+
+	CHECK(store.find(*missing) == INVALID_CALL);
+
+	delete missing;
+}
+
+
+// Handles of removed calls find nothing, even when the place is reused
+static void testHandles()
+{
+	CallStore store;
+
+	CallHandle first = store.add(makeRecord(1));
+	CallHandle second = store.add(makeRecord(2));
+
+	store.remove(first);
+
+	CHECK(store.get(first) == NULL);
+	CHECK(store.getCount() == 1);
+
+	CallRecord* again = makeRecord(1);
+	CHECK(store.find(*again) == INVALID_CALL);
+
+	CallHandle reused = store.add(again);
+
+	CHECK(reused != first);
+	CHECK(store.get(first) == NULL);
+	CHECK(store.get(reused) == again);
+	CHECK(store.find(*again) == reused);
+	CHECK(store.get(second) != NULL);
+
+	store.remove(first);
+	CHECK(store.getCount() == 2);
+}
+
+
+// A place reused more often than 11 bits of generation could count
+static void testGenerations()
+{
+	CallStore store;
+
+	CallHandle old = store.add(makeRecord(0));
+
+	store.remove(old);
+
+	for (int i=1; i <= 5000; i++)
+	{
+		CallHandle handle = store.add(makeRecord(i));
+
+		CHECK((handle & CALL_PLACE_MASK) == (old & CALL_PLACE_MASK));
+		CHECK(handle != old);
+
+		store.remove(handle);
+	}
+
+	CallHandle last = store.add(makeRecord(1));
+
+	CHECK(store.get(old) == NULL);
+	CHECK(store.get(last) != NULL);
+	CHECK(last > 0);
+}
+
+
+// The index stays right through many adds and removes, deleted entries
+// and rehashes included
+static void testChurn()
+{
+	CallStore store;
+	std::vector<CallHandle> handles;
+
+	for (int round=0; round < 20; round++)
+	{
+		for (int i=0; i < 500; i++)
+		{
+			handles.push_back(store.add(makeRecord(round * 500 + i)));
+		}
+
+		// Drop every other one of this round
+		for (int i=0; i < 500; i += 2)
+		{
+			store.remove(handles[round * 500 + i]);
+		}
+	}
+
+	CHECK(store.getCount() == 20 * 250);
+
+	for (int number=0; number < 20 * 500; number++)
+	{
+		CallRecord* probe = makeRecord(number);
+		CallHandle found = store.find(*probe);
+
+		CHECK((number % 2 == 0) ? (found == INVALID_CALL) : (found == handles[number]));
+
+		delete probe;
+	}
+
+	store.clear();
+
+	CHECK(store.getCount() == 0);
+	CHECK(store.getMemory() == 0);
+}
+
+
+
+// A call of its own reason, so its strings are freed with it
+static CallRecord* makeOwnRecord(int number)
+{
+	CallRecord* record = makeRecord(number);
+	char reason[32];
+
+	sprintf(reason, "Reason %d", number);
+
+	record->targetReason = reason;
+
+	return record;
+}
+
+
+// Memory the calls of a store take, their interned strings included
+static size_t usedMemory(const CallStore& store)
+{
+	return store.getMemory() + call_strings.getMemory();
+}
+
+
+// The store stays under its budget, giving up handled calls before
+// unhandled ones, one at a time, and counts the memory back as calls go
+static void testBudget()
+{
+	CallStore store;
+
+	size_t strings = call_strings.getMemory();
+
+	store.setBudget(strings + 40 * 1024);
+
+	// Calls in the order they're given up, by state
+	std::deque<CallHandle> handled;
+	std::deque<CallHandle> unhandled;
+
+	int number = 0;
+
+
+	// Fill it: a call fits exactly as long as it has room
+	while (true)
+	{
+		CallRecord* record = makeOwnRecord(number++);
+
+		if (!store.hasRoom(*record))
+		{
+			CHECK(usedMemory(store) + CallStore::getSize(*record) > store.getBudget());
+
+			delete record;
+
+			break;
+		}
+
+		CallHandle handle = store.add(record);
+
+		(record->handled ? handled : unhandled).push_back(handle);
+
+		CHECK(usedMemory(store) <= store.getBudget());
+	}
+
+	CHECK(store.getCount() > 50 && !handled.empty() && !unhandled.empty());
+
+	int full = store.getCount();
+
+
+	// Keep adding as the client does, some calls get handled meanwhile
+	for (int i=0; i < 2000; i++)
+	{
+		if (i % 5 == 0 && !unhandled.empty())
+		{
+			CallHandle handle = unhandled[unhandled.size() / 2];
+
+			store.setHandled(handle);
+
+			unhandled.erase(unhandled.begin() + unhandled.size() / 2);
+			handled.push_back(handle);
+		}
+
+		CallRecord* record = makeOwnRecord(number++);
+
+		while (store.getCount() > 0 && !store.hasRoom(*record))
+		{
+			CallHandle oldest = store.getOldest();
+
+			// The one handled longest ago, or the first unhandled if none is
+			if (!handled.empty())
+			{
+				CHECK(oldest == handled.front() && store.get(oldest)->handled);
+
+				handled.pop_front();
+			}
+			else
+			{
+				CHECK(oldest == unhandled.front() && !store.get(oldest)->handled);
+
+				unhandled.pop_front();
+			}
+
+			size_t before = usedMemory(store);
+
+			store.remove(oldest);
+
+			CHECK(usedMemory(store) < before);
+		}
+
+		CallHandle handle = store.add(record);
+
+		(record->handled ? handled : unhandled).push_back(handle);
+
+		CHECK(usedMemory(store) <= store.getBudget());
+		CHECK(store.getCount() >= full - 2 && store.getCount() <= full + 2);
+	}
+
+	CHECK((int)(handled.size() + unhandled.size()) == store.getCount());
+
+
+	// All memory back, the strings of the pool included
+	store.clear();
+
+	CHECK(store.getMemory() == 0);
+	CHECK(call_strings.getMemory() == strings);
+}
+
+
+
+
+// Keeps the rows of a view only from what it's told, as the call list does
+class RowsListener : public CallStoreListener
+{
+private:
+	const CallStore& store;
+
+	CALL_VIEW view;
+	long changingRow;
+
+public:
+	std::vector<CallHandle> rows;
+
+	RowsListener(const CallStore& callStore, CALL_VIEW callView) : store(callStore), view(callView), changingRow(-1) {}
+
+	virtual void onCallAdded(CallHandle handle)
+	{
+		long row = store.getRow(view, handle);
+
+		if (row != -1)
+		{
+			rows.insert(rows.begin() + row, handle);
+		}
+	}
+
+	virtual void onCallChanging(CallHandle handle)
+	{
+		changingRow = store.getRow(view, handle);
+	}
+
+	virtual void onCallChanged(CallHandle handle)
+	{
+		if (changingRow != -1)
+		{
+			rows.erase(rows.begin() + changingRow);
+		}
+
+		onCallAdded(handle);
+	}
+
+	virtual void onCallRemoved(CallHandle)
+	{
+		if (changingRow != -1)
+		{
+			rows.erase(rows.begin() + changingRow);
+		}
+	}
+
+	virtual void onCallsReset()
+	{
+		rows.clear();
+
+		for (long row=0; row < store.getViewCount(view); row++)
+		{
+			rows.push_back(store.getAt(view, row));
+		}
+	}
+};
+
+
+// Name of a sorted view, lower case
+static std::string sortName(const CallRecord& record, CALL_VIEW view)
+{
+	std::string name = ((view == CALL_VIEW_SERVER) ? record.serverName : record.targetName).str();
+
+	for (size_t i=0; i < name.size(); i++)
+	{
+		name[i] = (name[i] >= 'A' && name[i] <= 'Z') ? (char)(name[i] - 'A' + 'a') : name[i];
+	}
+
+	return name;
+}
+
+
+// Is x rightly in front of y in a view? Ties in time go by arrival
+static bool inOrder(const CallStore& store, CALL_VIEW view, CallHandle x, CallHandle y, std::map<CallHandle, int>& arrival)
+{
+	const CallRecord& first = *store.get((view == CALL_VIEW_NEWEST) ? y : x);
+	const CallRecord& second = *store.get((view == CALL_VIEW_NEWEST) ? x : y);
+
+	if (view == CALL_VIEW_UNHANDLED_FIRST && first.handled != second.handled)
+	{
+		return !first.handled;
+	}
+
+	if (view == CALL_VIEW_SERVER || view == CALL_VIEW_TARGET)
+	{
+		std::string a = sortName(first, view);
+		std::string b = sortName(second, view);
+
+		if (a != b)
+		{
+			return a < b;
+		}
+	}
+
+	if (first.reportedAt != second.reportedAt)
+	{
+		return first.reportedAt < second.reportedAt;
+	}
+
+	return (view == CALL_VIEW_NEWEST) ? (arrival[y] < arrival[x]) : (arrival[x] < arrival[y]);
+}
+
+
+// Every view in order, rows and calls found both ways
+static bool checkViews(const CallStore& store, std::map<CallHandle, int>& arrival)
+{
+	bool passed = true;
+
+	for (int view=0; view < CALL_VIEWS; view++)
+	{
+		long count = store.getViewCount((CALL_VIEW)view);
+		long unhandled = 0;
+
+		for (CallHandle i = store.getFirst(); i != INVALID_CALL; i = store.getNext(i))
+		{
+			unhandled += store.get(i)->handled ? 0 : 1;
+
+			if ((store.getRow((CALL_VIEW)view, i) == -1) != (view == CALL_VIEW_UNHANDLED && store.get(i)->handled))
+			{
+				passed = false;
+			}
+		}
+
+		passed = passed && (count == ((view == CALL_VIEW_UNHANDLED) ? unhandled : store.getCount()));
+		passed = passed && store.getAt((CALL_VIEW)view, -1) == INVALID_CALL && store.getAt((CALL_VIEW)view, count) == INVALID_CALL;
+
+		for (long row=0; row < count; row++)
+		{
+			CallHandle handle = store.getAt((CALL_VIEW)view, row);
+
+			passed = passed && store.get(handle) != NULL && store.getRow((CALL_VIEW)view, handle) == row;
+			passed = passed && (row == 0 || inOrder(store, (CALL_VIEW)view, store.getAt((CALL_VIEW)view, row - 1), handle, arrival));
+		}
+	}
+
+	return passed;
+}
+
+
+// Views stay in order through random adds, handlings and removes, calls
+// from the past included, and a listener can follow them row by row
+static void testViews()
+{
+	for (int view=0; view < CALL_VIEWS; view++)
+	{
+		CallStore store;
+		RowsListener listener(store, (CALL_VIEW)view);
+
+		std::vector<CallHandle> handles;
+		std::map<CallHandle, int> arrival;
+
+		unsigned int random = 12345U + view;
+		int number = 0;
+
+		store.setListener(&listener);
+
+		for (int step=0; step < 3000; step++)
+		{
+			random = random * 1103515245U + 12345U;
+
+			unsigned int choice = (random >> 16) % 8;
+
+			if (choice < 4 || handles.empty())
+			{
+				CallRecord* record = makeRecord(number++);
+
+				// Anywhere in time, often at the same time as another
+				record->reportedAt = 1500000000L + (long)((random >> 8) % 500);
+
+				CallHandle handle = store.add(record);
+
+				handles.push_back(handle);
+				arrival[handle] = number;
+			}
+			else
+			{
+				size_t which = (random >> 4) % handles.size();
+
+				if (choice < 6)
+				{
+					store.setHandled(handles[which]);
+				}
+				else
+				{
+					store.remove(handles[which]);
+
+					handles.erase(handles.begin() + which);
+				}
+			}
+
+			// Some of them at once
+			if (step % 500 == 250)
+			{
+				store.beginUpdate();
+
+				for (int i=0; i < 20 && !handles.empty(); i++)
+				{
+					store.setHandled(handles[i]);
+					store.remove(handles.back());
+
+					handles.pop_back();
+				}
+
+				store.endUpdate();
+			}
+
+			std::vector<CallHandle> expected;
+
+			for (long row=0; row < store.getViewCount((CALL_VIEW)view); row++)
+			{
+				expected.push_back(store.getAt((CALL_VIEW)view, row));
+			}
+
+			CHECK(listener.rows == expected);
+
+			if (step % 100 == 0)
+			{
+				CHECK(checkViews(store, arrival));
+			}
+		}
+
+		CHECK(checkViews(store, arrival));
+
+		store.setListener(NULL);
+	}
+}
+
+
+
+int main()
+{
+	testFind();
+	testHandles();
+	testGenerations();
+	testChurn();
+	testBudget();
+	testViews();
+
+	return checkExit();
+}
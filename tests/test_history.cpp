@@ -0,0 +1,367 @@
+/**
+ * -----------------------------------------------------
+ * File        test_history.cpp
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+// c++ libs
+#include <stdio.h>
+#include <string>
+
+// Project
+#include "callindex.h"
+#include "history.h"
+#include "payloads.h"
+#include "testing.h"
+
+
+
+// Files of the tests
+#define TEST_LOG "test_history.log"
+#define TEST_INDEX "test_history.idx"
+
+
+
+// Whole content of a file, empty if there is none
+static std::string readFile(const char* path)
+{
+	FILE* file = fopen(path, "rb");
+	std::string content;
+	char buffer[4096];
+	size_t read;
+
+	while (file != NULL && (read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+	{
+		content.append(buffer, read);
+	}
+
+	if (file != NULL)
+	{
+		fclose(file);
+	}
+
+	return content;
+}
+
+
+// Replace the content of a file
+static void writeFile(const char* path, const std::string& content)
+{
+	FILE* file = fopen(path, "wb");
+
+	if (file != NULL)
+	{
+		fwrite(content.data(), 1, content.size(), file);
+		fclose(file);
+	}
+}
+
+
+// A new history with the calls 0..calls, closed again
+static void makeHistory(int calls)
+{
+	remove(TEST_LOG);
+	remove(TEST_INDEX);
+
+	CallHistory history;
+
+	CHECK(history.open(TEST_LOG, TEST_INDEX));
+
+	for (int i=0; i < calls; i++)
+	{
+		CallRecord* record = makeRecord(i);
+
+		CHECK(history.append(*record));
+
+		delete record;
+	}
+
+	CHECK(history.getCount() == (size_t)calls);
+}
+
+
+// Is record n of the history call n, with every field?
+static bool isCall(CallHistory& history, size_t number, int call)
+{
+	CallRecord read;
+	CallRecord* record = makeRecord(call);
+
+	bool same = (history.read(number, read) == HISTORY_CALL && read == *record && read.fullIP == record->fullIP && read.handled == record->handled
+	             && read.serverName.str() == record->serverName.str() && read.targetName.str() == record->targetName.str()
+	             && read.targetReason.str() == record->targetReason.str() && read.clientName.str() == record->clientName.str()
+	             && read.targetID == record->targetID && read.clientID == record->clientID);
+
+	delete record;
+
+	return same;
+}
+
+
+// Are the records 0..calls the calls 0..calls?
+static bool hasCalls(CallHistory& history, int calls)
+{
+	bool passed = (history.getCount() == (size_t)calls);
+
+	for (int i=0; passed && i < calls; i++)
+	{
+		passed = isCall(history, (size_t)i, i);
+	}
+
+	return passed;
+}
+
+
+
+// Calls and handled marks come back after opening the history again, the
+// marked calls as handled
+static void testAppend()
+{
+	makeHistory(20);
+
+	CallHistory history;
+
+	CHECK(history.open(TEST_LOG, TEST_INDEX));
+
+	for (int i=0; i < 20; i += 4)
+	{
+		CallRecord* record = makeRecord(i);
+
+		CHECK(history.appendHandled(*record, record->reportedAt + 100));
+
+		delete record;
+	}
+
+	CHECK(history.getCount() == 25);
+
+	history.close();
+	CHECK(!history.isOpen());
+
+
+	CHECK(history.open(TEST_LOG, TEST_INDEX));
+	CHECK(history.getCount() == 25);
+	CHECK(history.getNewest() == makeCall(19).reportedAt);
+
+	for (int i=0; i < 20; i++)
+	{
+		CHECK(isCall(history, (size_t)i, i));
+	}
+
+	// Followed by an index, as the client does when it loads the history
+	CallIndex index;
+
+	for (size_t i=0; i < history.getCount(); i++)
+	{
+		CallRecord record;
+		long handledAt;
+
+		HISTORY_RECORD kind = history.read(i, record, &handledAt);
+
+		if (kind == HISTORY_CALL)
+		{
+			index.add((unsigned int)i, record);
+
+			continue;
+		}
+
+		PayloadCall call = makeCall((int)(i - 20) * 4);
+
+		CHECK(kind == HISTORY_HANDLED);
+		CHECK(record.callID == call.callID && record.reportedAt == call.reportedAt);
+		CHECK(record.serverName.str() == call.serverName && record.targetReason.str() == call.targetReason);
+		CHECK(handledAt == call.reportedAt + 100);
+
+		index.setHandled(record);
+	}
+
+	for (int i=0; i < 20; i++)
+	{
+		CallRecord* record = makeRecord(i);
+
+		// As the history has it: the state it came with
+		record->handled = false;
+
+		CHECK(index.isHandled(*record) == (i % 3 == 0 || i % 4 == 0));
+
+		delete record;
+	}
+
+	CallRecord record;
+
+	CHECK(history.read(25, record) == HISTORY_INVALID);
+
+	history.close();
+
+	remove(TEST_LOG);
+	remove(TEST_INDEX);
+}
+
+
+// A record that was only partly written is cut off, the ones before stay
+// and new ones go where it was
+static void testTornTail()
+{
+	makeHistory(10);
+
+	std::string log = readFile(TEST_LOG);
+	std::string complete = log;
+
+	// Half of a record: a header promising more than follows
+	CallRecord* record = makeRecord(10);
+
+	{
+		CallHistory history;
+
+		CHECK(history.open(TEST_LOG, TEST_INDEX));
+		CHECK(history.append(*record));
+	}
+
+	std::string grown = readFile(TEST_LOG);
+
+	CHECK(grown.size() > log.size() + 8);
+
+	for (size_t cut = log.size() + 1; cut < grown.size(); cut += 3)
+	{
+		writeFile(TEST_LOG, grown.substr(0, cut));
+
+		CallHistory history;
+
+		CHECK(history.open(TEST_LOG, TEST_INDEX));
+		CHECK(hasCalls(history, 10));
+
+		history.close();
+
+		CHECK(readFile(TEST_LOG) == complete);
+	}
+
+
+	// Appending after the cut
+	CallHistory history;
+
+	CHECK(history.open(TEST_LOG, TEST_INDEX));
+	CHECK(history.append(*record));
+	CHECK(hasCalls(history, 11));
+
+	history.close();
+
+	CHECK(readFile(TEST_LOG) == grown);
+
+	delete record;
+
+	remove(TEST_LOG);
+	remove(TEST_INDEX);
+}
+
+
+// The index is rebuilt from the log when it's missing, behind or broken
+static void testIndex()
+{
+	makeHistory(30);
+
+	std::string index = readFile(TEST_INDEX);
+
+	CHECK(index.size() == 4 + 30 * 8);
+
+	// Missing, only the first entries, garbage offsets, a wrong magic
+	std::string stale[4];
+
+	stale[1] = index.substr(0, 4 + 12 * 8);
+	stale[2] = index;
+	stale[3] = index;
+
+	stale[2][4 + 5 * 8] ^= 0x40;
+	stale[3][0] = 'X';
+
+	for (int i=0; i < 4; i++)
+	{
+		if (i == 0)
+		{
+			remove(TEST_INDEX);
+		}
+		else
+		{
+			writeFile(TEST_INDEX, stale[i]);
+		}
+
+		CallHistory history;
+
+		CHECK(history.open(TEST_LOG, TEST_INDEX));
+		CHECK(hasCalls(history, 30));
+
+		history.close();
+
+		CHECK(readFile(TEST_INDEX) == index);
+	}
+
+	remove(TEST_LOG);
+	remove(TEST_INDEX);
+}
+
+
+// A record with a changed byte is refused by its checksum, the others are still read
+static void testChecksum()
+{
+	makeHistory(5);
+
+	std::string log = readFile(TEST_LOG);
+	std::string index = readFile(TEST_INDEX);
+
+	// Into the payload of the third record
+	size_t offset = 0;
+
+	for (int i=0; i < 8; i++)
+	{
+		offset |= (size_t)(unsigned char)index[4 + 2 * 8 + i] << (i * 8);
+	}
+
+	log[offset + 8 + 3] ^= 0x01;
+
+	writeFile(TEST_LOG, log);
+
+	CallHistory history;
+	CallRecord record;
+
+	CHECK(history.open(TEST_LOG, TEST_INDEX));
+	CHECK(history.getCount() == 5);
+	CHECK(history.read(2, record) == HISTORY_INVALID);
+
+	for (int i=0; i < 5; i++)
+	{
+		CHECK(i == 2 || isCall(history, (size_t)i, i));
+	}
+
+	history.close();
+
+	remove(TEST_LOG);
+	remove(TEST_INDEX);
+}
+
+
+
+int main()
+{
+	testAppend();
+	testTornTail();
+	testIndex();
+	testChecksum();
+
+	return checkExit();
+}
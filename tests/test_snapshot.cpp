@@ -0,0 +1,350 @@
+/**
+ * -----------------------------------------------------
+ * File        test_snapshot.cpp
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+// c++ libs
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+// Project
+#include "callindex.h"
+#include "callstats.h"
+#include "snapshot.h"
+#include "codec.h"
+#include "payloads.h"
+#include "testing.h"
+
+
+
+// File of the tests
+#define TEST_SNAPSHOT "test_snapshot.dat"
+
+// Queries to compare indexes with
+static const char* queries[] = {"player", "player 1", "community", "dust2", "cheat", "1", "7656119", "10.0.3.1"};
+
+
+
+// Index and count the calls from..to, every third is handled
+static void addCalls(CallIndex& index, CallStats& stats, int from, int to)
+{
+	for (int i = from; i < to; i++)
+	{
+		CallRecord* record = makeRecord(i);
+
+		index.add((unsigned int)i, *record);
+		stats.addCall(*record);
+
+		if (record->handled)
+		{
+			stats.addHandled(*record, record->reportedAt + 60L * (i % 50));
+		}
+
+		delete record;
+	}
+}
+
+
+// Indexes find the same
+static bool sameSearches(const CallIndex& first, const CallIndex& second)
+{
+	for (size_t i=0; i < sizeof(queries) / sizeof(queries[0]); i++)
+	{
+		std::vector<unsigned int> a;
+		std::vector<unsigned int> b;
+
+		first.search(queries[i], a, 1000);
+		second.search(queries[i], b, 1000);
+
+		if (a != b)
+		{
+			return false;
+		}
+	}
+
+	return first.getCount() == second.getCount() && first.getTerms() == second.getTerms();
+}
+
+
+
+// Calls, index and statistics come back as they were written
+static void testRoundTrip()
+{
+	CallStore store;
+	CallIndex index;
+	CallStats stats;
+
+	for (int i=0; i < 50; i++)
+	{
+		store.add(makeRecord(i));
+	}
+
+	addCalls(index, stats, 0, 50);
+
+	CallSnapshot written;
+
+	written.historyCount = 50;
+	written.newest = 1234;
+	written.trackers.push_back("STEAM_0:1:2");
+	written.avatars.push_back(SnapshotAvatar(76561197960265728ULL, 99));
+
+	CHECK(written.write(TEST_SNAPSHOT, store, index, stats));
+
+
+	CallSnapshot snapshot;
+	CallIndex readIndex;
+	CallStats readStats;
+
+	CHECK(snapshot.read(TEST_SNAPSHOT, readIndex, readStats));
+	CHECK(snapshot.historyCount == 50 && snapshot.newest == 1234);
+	CHECK(snapshot.trackers.size() == 1 && snapshot.trackers[0] == "STEAM_0:1:2");
+	CHECK(snapshot.avatars.size() == 1 && snapshot.avatars[0].loadedAt == 99);
+	CHECK(snapshot.getCallCount() == 50);
+
+	CHECK(sameSearches(index, readIndex));
+	CHECK(stats.getCSV() == readStats.getCSV());
+	CHECK(stats.getReport() == readStats.getReport());
+
+
+	// The calls are duplicates of the store
+	CHECK(snapshot.restore(store) == 0);
+
+	CallStore restored;
+
+	CHECK(snapshot.read(TEST_SNAPSHOT, readIndex, readStats));
+	CHECK(snapshot.restore(restored) == 50);
+
+	CallHandle a = store.getFirst();
+	CallHandle b = restored.getFirst();
+
+	for (; a != INVALID_CALL && b != INVALID_CALL; a = store.getNext(a), b = restored.getNext(b))
+	{
+		CHECK(*store.get(a) == *restored.get(b));
+		CHECK(store.get(a)->handled == restored.get(b)->handled);
+		CHECK(store.get(a)->targetReason.str() == restored.get(b)->targetReason.str());
+	}
+
+	CHECK(a == INVALID_CALL && b == INVALID_CALL);
+
+	remove(TEST_SNAPSHOT);
+}
+
+
+// Index and statistics of a snapshot with the newer records added are the same as counting everything
+static void testTail()
+{
+	CallStore store;
+	CallIndex index;
+	CallStats stats;
+
+	addCalls(index, stats, 0, 400);
+
+	CallSnapshot written;
+
+	written.historyCount = 400;
+
+	CHECK(written.write(TEST_SNAPSHOT, store, index, stats));
+
+	addCalls(index, stats, 400, 700);
+
+
+	CallSnapshot snapshot;
+	CallIndex tailIndex;
+	CallStats tailStats;
+
+	CHECK(snapshot.read(TEST_SNAPSHOT, tailIndex, tailStats));
+
+	addCalls(tailIndex, tailStats, (int)snapshot.historyCount, 700);
+
+	CHECK(sameSearches(index, tailIndex));
+	CHECK(stats.getCSV() == tailStats.getCSV());
+	CHECK(stats.getReport() == tailStats.getReport());
+
+	remove(TEST_SNAPSHOT);
+}
+
+
+// A snapshot that is cut off or changed is ignored as a whole
+static void testBroken()
+{
+	CallStore store;
+	CallIndex index;
+	CallStats stats;
+
+	for (int i=0; i < 20; i++)
+	{
+		store.add(makeRecord(i));
+	}
+
+	addCalls(index, stats, 0, 20);
+
+	CallSnapshot written;
+
+	CHECK(written.write(TEST_SNAPSHOT, store, index, stats));
+
+	FILE* file = fopen(TEST_SNAPSHOT, "rb");
+	std::string content;
+	char buffer[4096];
+	size_t read;
+
+	while (file != NULL && (read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+	{
+		content.append(buffer, read);
+	}
+
+	if (file != NULL)
+	{
+		fclose(file);
+	}
+
+	CHECK(content.size() > 100);
+
+
+	// Every cut and a flipped byte in the payload
+	for (size_t cut = 0; cut <= content.size(); cut += (cut < 64) ? 1 : 97)
+	{
+		std::string broken = content.substr(0, cut);
+
+		if (cut == content.size())
+		{
+			broken[content.size() / 2] ^= 0x20;
+		}
+
+		file = fopen(TEST_SNAPSHOT, "wb");
+		fwrite(broken.data(), 1, broken.size(), file);
+		fclose(file);
+
+		CallSnapshot snapshot;
+		CallIndex readIndex;
+		CallStats readStats;
+
+		addCalls(readIndex, readStats, 0, 5);
+
+		CHECK(!snapshot.read(TEST_SNAPSHOT, readIndex, readStats));
+		CHECK(snapshot.getCallCount() == 0 && readIndex.getCount() == 0 && readStats.getTotal().calls == 0);
+	}
+
+	remove(TEST_SNAPSHOT);
+}
+
+
+// Calls of the index are known, the ones handled after they came in as
+// handled, also after reading the index again
+static void testHandled()
+{
+	CallStore store;
+	CallIndex index;
+	CallStats stats;
+
+	addCalls(index, stats, 0, 30);
+
+	for (int i=0; i < 30; i++)
+	{
+		if (i % 5 == 1 || i % 3 == 0)
+		{
+			CallRecord* record = makeRecord(i);
+
+			// Only new marks count
+			CHECK(index.setHandled(*record) == (i % 3 != 0));
+			CHECK(!index.setHandled(*record));
+
+			delete record;
+		}
+	}
+
+	CallSnapshot written;
+
+	CHECK(written.write(TEST_SNAPSHOT, store, index, stats));
+
+	CallSnapshot snapshot;
+	CallIndex readIndex;
+	CallStats readStats;
+
+	CHECK(snapshot.read(TEST_SNAPSHOT, readIndex, readStats));
+
+	for (int i=0; i < 30; i++)
+	{
+		CallRecord* record = makeRecord(i);
+
+		bool expected = (i % 3 == 0 || i % 5 == 1);
+
+		// As the history has it: the state it came with
+		record->handled = false;
+
+		CHECK(index.isHandled(*record) == expected);
+		CHECK(readIndex.isHandled(*record) == expected);
+		CHECK(index.isKnown(*record) && readIndex.isKnown(*record));
+
+		// Same ID at another time is another call
+		record->reportedAt++;
+		CHECK(!readIndex.isHandled(*record));
+		CHECK(!readIndex.isKnown(*record));
+
+		delete record;
+	}
+
+	remove(TEST_SNAPSHOT);
+}
+
+
+// Index and statistics with garbage behind a valid checksum are refused
+static void testGarbage()
+{
+	for (unsigned int seed = 1; seed < 200; seed++)
+	{
+		std::string payload;
+
+		for (unsigned int i=0, value = seed; i < seed * 3; i++)
+		{
+			value = value * 1103515245U + 12345U;
+			payload += (char)(value >> 16);
+		}
+
+		CodecReader reader(payload.data(), payload.size());
+		CallIndex index;
+		CallStats stats;
+
+		if (!index.read(reader))
+		{
+			CHECK(index.getCount() == 0 && index.getTerms() == 0);
+		}
+		else if (!stats.read(reader))
+		{
+			CHECK(stats.getTotal().calls == 0 && stats.getTopPlayers().empty());
+		}
+	}
+}
+
+
+
+int main()
+{
+	testRoundTrip();
+	testTail();
+	testBroken();
+	testHandled();
+	testGarbage();
+
+	return checkExit();
+}
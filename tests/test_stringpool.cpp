@@ -0,0 +1,213 @@
+/**
+ * -----------------------------------------------------
+ * File        test_stringpool.cpp
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+// c++ libs
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+// Project
+#include "callstore.h"
+#include "stringpool.h"
+#include "testing.h"
+
+
+
+// A text is stored once and dropped with its last reference
+static void testReferences()
+{
+	StringPool pool;
+
+	StringHandle first = pool.intern("Aimbot");
+	StringHandle second = pool.intern(std::string("Aimbot"));
+
+	CHECK(first == second);
+	CHECK(pool.getCount() == 1);
+	CHECK(pool.get(first) == "Aimbot");
+
+	size_t memory = pool.getMemory();
+
+	CHECK(memory > 0);
+
+	pool.addReference(first);
+
+	// Still referenced twice
+	pool.release(first);
+	pool.release(first);
+
+	CHECK(pool.getCount() == 1);
+	CHECK(pool.getMemory() == memory);
+	CHECK(pool.get(first) == "Aimbot");
+
+	// The last one
+	pool.release(first);
+
+	CHECK(pool.getCount() == 0);
+	CHECK(pool.getMemory() == 0);
+
+
+	// Its handle is reused for another text, with another serial
+	unsigned int serial = pool.getSerial(first);
+
+	StringHandle other = pool.intern("Wallhack");
+
+	CHECK(other == first);
+	CHECK(pool.getSerial(other) != serial);
+	CHECK(pool.get(other) == "Wallhack");
+
+	// Interning it again finds nothing of the old text
+	StringHandle again = pool.intern("Aimbot");
+
+	CHECK(again != other);
+	CHECK(pool.getCount() == 2);
+
+	pool.release(other);
+	pool.release(again);
+
+	CHECK(pool.getCount() == 0 && pool.getMemory() == 0);
+
+
+	// The empty string is no entry
+	CHECK(pool.intern("") == EMPTY_STRING);
+	CHECK(pool.get(EMPTY_STRING).empty());
+	CHECK(pool.getSerial(EMPTY_STRING) == 0);
+	CHECK(pool.getCount() == 0);
+
+	pool.release(EMPTY_STRING);
+	pool.addReference(EMPTY_STRING);
+}
+
+
+// Many texts through rehashes, all found again and all freed
+static void testMany()
+{
+	StringPool pool;
+	std::vector<StringHandle> handles;
+
+	for (int i=0; i < 5000; i++)
+	{
+		char text[32];
+
+		sprintf(text, "Player %d", i);
+
+		handles.push_back(pool.intern(text));
+	}
+
+	CHECK(pool.getCount() == 5000);
+
+	for (int i=0; i < 5000; i++)
+	{
+		char text[32];
+
+		sprintf(text, "Player %d", i);
+
+		CHECK(pool.intern(text) == handles[i]);
+		CHECK(pool.get(handles[i]) == text);
+	}
+
+	for (int round=0; round < 2; round++)
+	{
+		for (int i=0; i < 5000; i++)
+		{
+			pool.release(handles[i]);
+		}
+	}
+
+	CHECK(pool.getCount() == 0);
+	CHECK(pool.getMemory() == 0);
+}
+
+
+// Pooled strings hold one reference each, through copies and assignments
+static void testPooled()
+{
+	StringPool pool;
+
+	{
+		PooledString server(pool, "Dust2");
+		PooledString copy(server);
+		PooledString empty(pool);
+
+		CHECK(pool.getCount() == 1);
+		CHECK(copy.str() == "Dust2" && copy.getHandle() == server.getHandle());
+		CHECK(empty.empty() && empty.str().empty());
+
+		// Onto itself and onto the same text
+		copy = copy;
+		copy = server;
+
+		CHECK(pool.getCount() == 1);
+
+		empty = server;
+		server = "Office";
+
+		CHECK(pool.getCount() == 2);
+		CHECK(server.str() == "Office" && empty.str() == "Dust2");
+
+		copy = "Office";
+		empty = "";
+
+		// Dust2 isn't referenced anymore
+		CHECK(pool.getCount() == 1);
+		CHECK(empty.empty());
+	}
+
+	CHECK(pool.getCount() == 0);
+	CHECK(pool.getMemory() == 0);
+}
+
+
+// The strings of a call are given back with it
+static void testRecords()
+{
+	int count = call_strings.getCount();
+	size_t memory = call_strings.getMemory();
+
+	{
+		CallRecord record;
+
+		record.serverName = "A server nobody else has";
+		record.targetReason = "A reason nobody else has";
+
+		CallRecord copy(record);
+
+		CHECK(call_strings.getCount() == count + 2);
+	}
+
+	CHECK(call_strings.getCount() == count);
+	CHECK(call_strings.getMemory() == memory);
+}
+
+
+
+int main()
+{
+	testReferences();
+	testMany();
+	testPooled();
+	testRecords();
+
+	return checkExit();
+}
@@ -0,0 +1,275 @@
+/**
+ * -----------------------------------------------------
+ * File        testing.cpp
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+
+// c++ libs
+#include <stdlib.h>
+#include <new>
+
+#if defined(_WIN32)
+	#include <windows.h>
+#else
+	#include <time.h>
+#endif
+
+
+// Project
+#include "testing.h"
+
+
+
+// Failed checks
+static int failures = 0;
+
+// Allocations since the start
+static unsigned long long allocations = 0;
+static unsigned long long allocatedBytes = 0;
+
+// Bytes allocated and not freed yet
+static unsigned long long liveBytes = 0;
+
+
+
+// Check a condition
+bool checkResult(bool passed, const char* condition, const char* file, int line)
+{
+	if (!passed)
+	{
+		fprintf(stderr, "%s:%d: CHECK(%s) failed\n", file, line, condition);
+
+		failures++;
+	}
+
+	return passed;
+}
+
+
+// Exit code of the test
+int checkExit()
+{
+	if (failures > 0)
+	{
+		fprintf(stderr, "%d checks failed\n", failures);
+
+		return 1;
+	}
+
+	return 0;
+}
+
+
+
+// Seconds since an arbitrary start
+double benchTime()
+{
+#if defined(_WIN32)
+	LARGE_INTEGER frequency, counter;
+
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+
+	return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return now.tv_sec + now.tv_nsec / 1e9;
+#endif
+}
+
+
+unsigned long long benchAllocations()
+{
+	return allocations;
+}
+
+unsigned long long benchAllocatedBytes()
+{
+	return allocatedBytes;
+}
+
+unsigned long long benchLiveBytes()
+{
+	return liveBytes;
+}
+
+
+
+// Run a case
+BenchResult runBench(BenchCase& bench, double seconds)
+{
+	BenchResult result;
+
+	// Warm up caches and buffers that are kept between calls
+	for (int i=0; i < 3; i++)
+	{
+		bench.run();
+	}
+
+	unsigned long long startAllocations = allocations;
+	unsigned long long startBytes = allocatedBytes;
+
+	double start = benchTime();
+	double elapsed = 0;
+
+	// Time is only read every few calls, short cases would mostly measure it
+	unsigned long batch = 1;
+
+	while (elapsed < seconds)
+	{
+		for (unsigned long i=0; i < batch; i++)
+		{
+			bench.run();
+		}
+
+		result.calls += batch;
+		elapsed = benchTime() - start;
+
+		if (elapsed < seconds / 16)
+		{
+			batch *= 2;
+		}
+	}
+
+	result.nsPerCall = elapsed * 1e9 / result.calls;
+	result.allocsPerCall = (double)(allocations - startAllocations) / result.calls;
+	result.bytesPerCall = (double)(allocatedBytes - startBytes) / result.calls;
+
+	return result;
+}
+
+
+// Print a result
+void printBench(const char* name, const BenchResult& result, size_t inputBytes)
+{
+	printf("%-44s %12.1f ns/call %8.2f allocs/call %10.0f B/call", name, result.nsPerCall, result.allocsPerCall, result.bytesPerCall);
+
+	if (inputBytes > 0)
+	{
+		printf(" %9.1f MB/s", inputBytes / (result.nsPerCall / 1e9) / (1024 * 1024));
+	}
+
+	printf("\n");
+
+	fflush(stdout);
+}
+
+
+
+
+// Count every allocation, the benchmarks report them per call
+#if __cplusplus < 201103L
+	#define TESTING_THROW throw(std::bad_alloc)
+	#define TESTING_NOTHROW throw()
+#else
+	#define TESTING_THROW
+	#define TESTING_NOTHROW noexcept
+#endif
+
+
+// Every block starts with its size, so freeing it knows what's gone
+// The header keeps the alignment malloc gives
+#define TESTING_HEADER 16
+
+
+void* operator new(size_t size) TESTING_THROW
+{
+	allocations++;
+	allocatedBytes += size;
+	liveBytes += size;
+
+	char* memory = (char*)malloc(TESTING_HEADER + size);
+
+	if (memory == NULL)
+	{
+		throw std::bad_alloc();
+	}
+
+	*(size_t*)memory = size;
+
+	return memory + TESTING_HEADER;
+}
+
+void* operator new[](size_t size) TESTING_THROW
+{
+	return operator new(size);
+}
+
+// Without exceptions, as std::stable_sort asks for its buffer
+void* operator new(size_t size, const std::nothrow_t&) TESTING_NOTHROW
+{
+	try
+	{
+		return operator new(size);
+	}
+	catch (const std::bad_alloc&)
+	{
+		return NULL;
+	}
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) TESTING_NOTHROW
+{
+	return operator new(size, std::nothrow);
+}
+
+void operator delete(void* memory) TESTING_NOTHROW
+{
+	if (memory != NULL)
+	{
+		char* block = (char*)memory - TESTING_HEADER;
+
+		liveBytes -= *(size_t*)block;
+
+		free(block);
+	}
+}
+
+void operator delete[](void* memory) TESTING_NOTHROW
+{
+	operator delete(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) TESTING_NOTHROW
+{
+	operator delete(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) TESTING_NOTHROW
+{
+	operator delete(memory);
+}
+
+#if __cplusplus >= 201402L
+void operator delete(void* memory, size_t) noexcept
+{
+	operator delete(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept
+{
+	operator delete(memory);
+}
+#endif
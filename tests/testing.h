@@ -0,0 +1,93 @@
+#ifndef TESTING_H
+#define TESTING_H
+
+/**
+ * -----------------------------------------------------
+ * File        testing.h
+ * Authors     David Ordnung, Impact
+ * License     GPLv3
+ * Web         http://dordnung.de, http://gugyclan.eu
+ * -----------------------------------------------------
+ *
+ * Copyright (C) 2013-2017 David Ordnung, Impact
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#pragma once
+
+
+// c++ libs
+#include <stdio.h>
+#include <stddef.h>
+
+
+
+// Tests and benchmarks of the parts of the client that don't need wx,
+// Steam or curl. Every test is an own program, it prints what failed and
+// exits with 1 if anything did.
+
+
+// Checks of a test, a failed one is printed and counted
+#define CHECK(condition) checkResult((condition), #condition, __FILE__, __LINE__)
+
+bool checkResult(bool passed, const char* condition, const char* file, int line);
+
+// Exit code of the test: 0 if every check passed
+int checkExit();
+
+
+
+// Seconds since an arbitrary start, for measuring
+double benchTime();
+
+// Allocations through operator new so far, and their bytes
+unsigned long long benchAllocations();
+unsigned long long benchAllocatedBytes();
+
+// Bytes allocated through operator new and not freed yet
+unsigned long long benchLiveBytes();
+
+
+// Something to measure, run() is called over and over
+class BenchCase
+{
+public:
+	virtual ~BenchCase() {}
+
+	virtual void run() = 0;
+};
+
+
+// Cost of one call of a case
+struct BenchResult
+{
+	unsigned long calls;
+
+	double nsPerCall;
+	double allocsPerCall;
+	double bytesPerCall;
+
+	BenchResult() : calls(0), nsPerCall(0), allocsPerCall(0), bytesPerCall(0) {}
+};
+
+
+// Run a case for at least the given seconds, after a warm up
+BenchResult runBench(BenchCase& bench, double seconds = 0.2);
+
+// One line per case: ns/call, allocations/call and MB/s if input bytes are given
+void printBench(const char* name, const BenchResult& result, size_t inputBytes = 0);
+
+
+#endif
@@ -30,6 +30,24 @@ distribution.
 #   include <cstddef>
 #endif
 
+// The vector scans use aligned loads which may read past the terminator
+// (never past its page); address sanitizers report those, so keep them off there
+#if defined(__SANITIZE_ADDRESS__)
+#   define TIXML_NO_SIMD
+#endif
+
+#if (defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)) && !defined(TIXML_NO_SIMD)
+#   define TIXML_SIMD
+#   if defined(_MSC_VER)
+#       include <intrin.h>
+#       include <immintrin.h>
+#       define TIXML_TARGET( x )
+#   else
+#       include <immintrin.h>
+#       define TIXML_TARGET( x ) __attribute__(( target( x ) ))
+#   endif
+#endif
+
 static const char LINE_FEED				= (char)0x0a;			// all line endings are normalized to LF
 static const char LF = LINE_FEED;
 static const char CARRIAGE_RETURN		= (char)0x0d;			// CR gets filtered out
@@ -117,14 +135,17 @@ char* StrPair::ParseText( char* p, const char* endTag, int strFlags )
 	size_t length = strlen( endTag );
 
 	// Inner loop of text parsing.
-	while ( *p ) {
-		if ( *p == endChar && strncmp( p, endTag, length ) == 0 ) {
+	for( ;; ) {
+		p = XMLUtil::FindAny( p, endChar, endChar, endChar );
+		if ( !*p ) {
+			return 0;
+		}
+		if ( strncmp( p, endTag, length ) == 0 ) {
 			Set( start, p, strFlags );
 			return p + length;
 		}
 		++p;
 	}
-	return 0;
 }
 
 
@@ -185,6 +206,12 @@ const char* StrPair::GetStr()
 			char* p = _start;	// the read pointer
 			char* q = _start;	// the write pointer
 
+			// Characters the loop below has to look at, everything
+			// in between is moved in one block. _end is terminated.
+			const char lineA = ( _flags & NEEDS_NEWLINE_NORMALIZATION ) ? CR : 0;
+			const char lineB = ( _flags & NEEDS_NEWLINE_NORMALIZATION ) ? LF : 0;
+			const char entity = ( _flags & NEEDS_ENTITY_PROCESSING ) ? '&' : 0;
+
 			while( p < _end ) {
 				if ( (_flags & NEEDS_NEWLINE_NORMALIZATION) && *p == CR ) {
 					// CR-LF pair becomes LF
@@ -242,9 +269,12 @@ const char* StrPair::GetStr()
 					}
 				}
 				else {
-					*q = *p;
-					++p;
-					++q;
+					char* next = XMLUtil::FindAny( p+1, lineA, lineB, entity );
+					if ( q != p ) {
+						memmove( q, p, next - p );
+					}
+					q += next - p;
+					p = next;
 				}
 			}
 			*q = 0;
@@ -264,6 +294,222 @@ const char* StrPair::GetStr()
 
 // --------- XMLUtil ----------- //
 
+/*
+	Scanning kernels for the hot loops of the parser: skipping whitespace
+	and looking for the next delimiter in long runs of text.
+
+	The vector versions only use aligned loads. An aligned block never
+	crosses a page boundary, so reading a few bytes past the terminator
+	can't fault; bits for bytes before the start pointer are masked off.
+*/
+static const char* SkipWhiteSpaceScalar( const char* p )
+{
+	while( XMLUtil::IsWhiteSpace( *p ) ) {
+		++p;
+	}
+	return p;
+}
+
+
+static const char* FindAnyScalar( const char* p, char a, char b, char c )
+{
+	while( *p && *p != a && *p != b && *p != c ) {
+		++p;
+	}
+	return p;
+}
+
+
+#ifdef TIXML_SIMD
+
+static inline int LowestBit( unsigned mask )
+{
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward( &index, mask );
+	return (int)index;
+#else
+	return __builtin_ctz( mask );
+#endif
+}
+
+
+TIXML_TARGET( "sse2" )
+static const char* SkipWhiteSpaceSSE2( const char* p )
+{
+	// isspace() in the lower half: ' ' and '\t' to '\r'
+	const __m128i space = _mm_set1_epi8( ' ' );
+	const __m128i tab = _mm_set1_epi8( 0x09 );
+	const __m128i range = _mm_set1_epi8( 0x0d - 0x09 );
+
+	const unsigned misalign = (unsigned)( reinterpret_cast<size_t>(p) & 15 );
+	const char* block = p - misalign;
+	unsigned mask = 0xffffU << misalign;
+
+	for( ;; ) {
+		__m128i x = _mm_load_si128( reinterpret_cast<const __m128i*>(block) );
+		__m128i y = _mm_sub_epi8( x, tab );
+		__m128i ws = _mm_or_si128( _mm_cmpeq_epi8( x, space ), _mm_cmpeq_epi8( _mm_min_epu8( y, range ), y ) );
+		mask &= ~(unsigned)_mm_movemask_epi8( ws ) & 0xffffU;
+		if ( mask ) {
+			return block + LowestBit( mask );
+		}
+		block += 16;
+		mask = 0xffffU;
+	}
+}
+
+
+TIXML_TARGET( "sse2" )
+static const char* FindAnySSE2( const char* p, char a, char b, char c )
+{
+	const __m128i va = _mm_set1_epi8( a );
+	const __m128i vb = _mm_set1_epi8( b );
+	const __m128i vc = _mm_set1_epi8( c );
+	const __m128i zero = _mm_setzero_si128();
+
+	const unsigned misalign = (unsigned)( reinterpret_cast<size_t>(p) & 15 );
+	const char* block = p - misalign;
+	unsigned mask = 0xffffU << misalign;
+
+	for( ;; ) {
+		__m128i x = _mm_load_si128( reinterpret_cast<const __m128i*>(block) );
+		__m128i hit = _mm_or_si128( _mm_or_si128( _mm_cmpeq_epi8( x, va ), _mm_cmpeq_epi8( x, vb ) ),
+									_mm_or_si128( _mm_cmpeq_epi8( x, vc ), _mm_cmpeq_epi8( x, zero ) ) );
+		mask &= (unsigned)_mm_movemask_epi8( hit );
+		if ( mask ) {
+			return block + LowestBit( mask );
+		}
+		block += 16;
+		mask = 0xffffU;
+	}
+}
+
+
+TIXML_TARGET( "avx2" )
+static const char* SkipWhiteSpaceAVX2( const char* p )
+{
+	const __m256i space = _mm256_set1_epi8( ' ' );
+	const __m256i tab = _mm256_set1_epi8( 0x09 );
+	const __m256i range = _mm256_set1_epi8( 0x0d - 0x09 );
+
+	const unsigned misalign = (unsigned)( reinterpret_cast<size_t>(p) & 31 );
+	const char* block = p - misalign;
+	unsigned mask = 0xffffffffU << misalign;
+
+	for( ;; ) {
+		__m256i x = _mm256_load_si256( reinterpret_cast<const __m256i*>(block) );
+		__m256i y = _mm256_sub_epi8( x, tab );
+		__m256i ws = _mm256_or_si256( _mm256_cmpeq_epi8( x, space ), _mm256_cmpeq_epi8( _mm256_min_epu8( y, range ), y ) );
+		mask &= ~(unsigned)_mm256_movemask_epi8( ws );
+		if ( mask ) {
+			return block + LowestBit( mask );
+		}
+		block += 32;
+		mask = 0xffffffffU;
+	}
+}
+
+
+TIXML_TARGET( "avx2" )
+static const char* FindAnyAVX2( const char* p, char a, char b, char c )
+{
+	const __m256i va = _mm256_set1_epi8( a );
+	const __m256i vb = _mm256_set1_epi8( b );
+	const __m256i vc = _mm256_set1_epi8( c );
+	const __m256i zero = _mm256_setzero_si256();
+
+	const unsigned misalign = (unsigned)( reinterpret_cast<size_t>(p) & 31 );
+	const char* block = p - misalign;
+	unsigned mask = 0xffffffffU << misalign;
+
+	for( ;; ) {
+		__m256i x = _mm256_load_si256( reinterpret_cast<const __m256i*>(block) );
+		__m256i hit = _mm256_or_si256( _mm256_or_si256( _mm256_cmpeq_epi8( x, va ), _mm256_cmpeq_epi8( x, vb ) ),
+									   _mm256_or_si256( _mm256_cmpeq_epi8( x, vc ), _mm256_cmpeq_epi8( x, zero ) ) );
+		mask &= (unsigned)_mm256_movemask_epi8( hit );
+		if ( mask ) {
+			return block + LowestBit( mask );
+		}
+		block += 32;
+		mask = 0xffffffffU;
+	}
+}
+
+
+enum SimdLevel {
+	SIMD_NONE,
+	SIMD_SSE2,
+	SIMD_AVX2
+};
+
+
+static SimdLevel DetectSimd()
+{
+#if defined(_MSC_VER)
+	int info[4];
+	__cpuid( info, 0 );
+	const int maxLeaf = info[0];
+
+	__cpuid( info, 1 );
+	const bool sse2 = ( info[3] & (1 << 26) ) != 0;
+	const bool osxsave = ( info[2] & (1 << 27) ) != 0;
+
+	if ( sse2 && osxsave && maxLeaf >= 7 && ( _xgetbv( 0 ) & 6 ) == 6 ) {
+		__cpuidex( info, 7, 0 );
+		if ( info[1] & (1 << 5) ) {
+			return SIMD_AVX2;
+		}
+	}
+	return sse2 ? SIMD_SSE2 : SIMD_NONE;
+#else
+	// Checks OS support for the AVX state as well
+	__builtin_cpu_init();
+	if ( __builtin_cpu_supports( "avx2" ) ) {
+		return SIMD_AVX2;
+	}
+	return __builtin_cpu_supports( "sse2" ) ? SIMD_SSE2 : SIMD_NONE;
+#endif
+}
+
+
+static const SimdLevel simdLevel = DetectSimd();
+
+#endif
+
+
+const char* XMLUtil::SkipWhiteSpaceRun( const char* p )
+{
+#ifdef TIXML_SIMD
+	switch( simdLevel ) {
+		case SIMD_AVX2:
+			return SkipWhiteSpaceAVX2( p );
+		case SIMD_SSE2:
+			return SkipWhiteSpaceSSE2( p );
+		default:
+			break;
+	}
+#endif
+	return SkipWhiteSpaceScalar( p );
+}
+
+
+const char* XMLUtil::FindAny( const char* p, char a, char b, char c )
+{
+#ifdef TIXML_SIMD
+	switch( simdLevel ) {
+		case SIMD_AVX2:
+			return FindAnyAVX2( p, a, b, c );
+		case SIMD_SSE2:
+			return FindAnySSE2( p, a, b, c );
+		default:
+			break;
+	}
+#endif
+	return FindAnyScalar( p, a, b, c );
+}
+
+
 const char* XMLUtil::ReadBOM( const char* p, bool* bom )
 {
 	*bom = false;
@@ -1688,6 +1934,32 @@ XMLError XMLDocument::Parse( const char* p, size_t len )
 }
 
 
+XMLError XMLDocument::ParseInSitu( char* p, size_t len )
+{
+	Clear();
+
+	if ( !p || len == 0 ) {
+		SetError( XML_ERROR_EMPTY_DOCUMENT, 0, 0 );
+		return _errorID;
+	}
+	if ( len != (size_t)(-1) ) {
+		p[len] = 0;
+	}
+
+	// The document doesn't own the buffer, so _charBuffer stays null
+	// and nothing is allocated or copied here.
+	char* start = XMLUtil::SkipWhiteSpace( p );
+	start = const_cast<char*>( XMLUtil::ReadBOM( start, &_writeBOM ) );
+	if ( !*start ) {
+		SetError( XML_ERROR_EMPTY_DOCUMENT, 0, 0 );
+		return _errorID;
+	}
+
+	ParseDeep( start, 0 );
+	return _errorID;
+}
+
+
 void XMLDocument::Print( XMLPrinter* streamer )
 {
 	XMLPrinter stdStreamer( stdout );
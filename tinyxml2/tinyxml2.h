@@ -458,17 +458,18 @@ class XMLUtil
 public:
 	// Anything in the high order range of UTF-8 is assumed to not be whitespace. This isn't
 	// correct, but simple, and usually works.
+	// Most runs are empty or a single character, longer ones go to the vectorized kernel.
 	static const char* SkipWhiteSpace( const char* p )	{
-		while( !IsUTF8Continuation(*p) && isspace( *reinterpret_cast<const unsigned char*>(p) ) ) {
-			++p;
+		if ( !IsWhiteSpace( *p ) ) {
+			return p;
+		}
+		if ( !IsWhiteSpace( *(p+1) ) ) {
+			return p+1;
 		}
-		return p;
+		return SkipWhiteSpaceRun( p+2 );
 	}
 	static char* SkipWhiteSpace( char* p )				{
-		while( !IsUTF8Continuation(*p) && isspace( *reinterpret_cast<unsigned char*>(p) ) )		{
-			++p;
-		}
-		return p;
+		return const_cast<char*>( SkipWhiteSpace( const_cast<const char*>(p) ) );
 	}
 	static bool IsWhiteSpace( char p )					{
 		return !IsUTF8Continuation(p) && isspace( static_cast<unsigned char>(p) );
@@ -507,6 +508,15 @@ public:
 		return p & 0x80;
 	}
 
+	// Scanning kernels, dispatched at runtime to SSE2/AVX2 where available.
+	// Returns the first character that isn't whitespace.
+	static const char* SkipWhiteSpaceRun( const char* p );
+	// Returns the first occurrence of a, b, c or the null terminator.
+	static const char* FindAny( const char* p, char a, char b, char c );
+	static char* FindAny( char* p, char a, char b, char c )	{
+		return const_cast<char*>( FindAny( const_cast<const char*>(p), a, b, c ) );
+	}
+
 	static const char* ReadBOM( const char* p, bool* hasBOM );
 	// p is the starting location,
 	// the UTF-8 value of the entity will be placed in value, and length filled in.
@@ -1436,6 +1446,23 @@ public:
 	*/
 	XMLError Parse( const char* xml, size_t nBytes=(size_t)(-1) );
 
+	/**
+		Parse an XML string in place, without copying it.
+		Returns XML_NO_ERROR (0) on success, or
+		an errorID.
+
+		The buffer is modified while parsing (terminators are
+		written and entities are translated in place) and all
+		nodes keep pointing into it, so it must stay valid and
+		unchanged for the lifetime of the document.
+
+		If 'nBytes' is given, the buffer must have room for
+		nBytes+1 characters; xml[nBytes] is overwritten with
+		the null terminator. If not specified, TinyXML will
+		assume 'xml' points to a null terminated string.
+	*/
+	XMLError ParseInSitu( char* xml, size_t nBytes=(size_t)(-1) );
+
 	/**
 		Load an XML file from disk.
 		Returns XML_NO_ERROR (0) on success, or
@@ -30,7 +30,7 @@
 #include "main.h"
 #include "call.h"
 #include "config.h"
-#include "tinyxml2/tinyxml2.h"
+#include "api.h"
 #include "taskbar.h"
 #include "trackers.h"
 #include "calladmin-client.h"
@@ -39,6 +39,9 @@
 // Tracker Panel
 TrackerPanel* trackerPanel = NULL;
 
+// Trackers of the last run, until the panel exists
+std::vector<std::string> lastTrackers;
+
 
 
 // Button ID's for Tracker Panel
@@ -97,6 +100,12 @@ TrackerPanel::TrackerPanel(wxNotebook* note) : wxPanel(note, wxID_ANY)
 
 	// Auto Size
 	SetSizerAndFit(sizerTop, true);
+
+
+	// The snapshot is read before the panel exists
+	restoreTrackers(lastTrackers);
+
+	lastTrackers.clear();
 }
 
 
@@ -105,7 +114,11 @@ TrackerPanel::TrackerPanel(wxNotebook* note) : wxPanel(note, wxID_ANY)
 void TrackerPanel::OnUpdate(wxCommandEvent& WXUNUSED(event))
 {
 	// Get the Trackers Page
-	getPage(refreshTrackers, page + "/trackers.php?from=20&from_type=interval&key=" + key);
+	ApiTrackersRequest request;
+
+	request.interval = 20;
+
+	getPage(refreshTrackers, buildURL((std::string)page, (std::string)key, request));
 }
 
 
@@ -126,8 +139,49 @@ void addTracker(wxString text)
 
 
 
+// Lines of the tracker list
+std::vector<std::string> getTrackers()
+{
+	if (trackerPanel == NULL)
+	{
+		return lastTrackers;
+	}
+
+	std::vector<std::string> lines;
+
+	for (unsigned int i=0; i < trackerPanel->getCount(); i++)
+	{
+		lines.push_back(trackerPanel->getTracker(i));
+	}
+
+	return lines;
+}
+
+
+// Show the trackers of the last run until they are updated
+void restoreTrackers(const std::vector<std::string>& lines)
+{
+	if (trackerPanel == NULL)
+	{
+		lastTrackers = lines;
+
+		return;
+	}
+
+	trackerPanel->delTrackers();
+
+	for (size_t i=0; i < lines.size(); i++)
+	{
+		trackerPanel->restoreTracker(lines[i]);
+	}
+}
+
+
+
+
+
 // Refresh Trackers
-void refreshTrackers(char* errors, wxString result, int WXUNUSED(x))
+void refreshTrackers(const char* errors, std::vector<char>& result, long long WXUNUSED(x))
 {
 	// Valid?
 	if (trackerPanel == NULL)
@@ -137,7 +191,7 @@ void refreshTrackers(char* errors, wxString result, int WXUNUSED(x))
 
 
 	// Log Action
-	LogAction("Got Trackers");
+	LOG(LOG_CATEGORY_NET, LOG_LEVEL_DEBUG, "Got Trackers");
 
 	wxString error = "";
 
@@ -146,103 +200,44 @@ void refreshTrackers(char* errors, wxString result, int WXUNUSED(x))
 	trackerPanel->delTrackers();
 
 
-	// Not empty?
-	if (result != "")
+	// Decode the result in place
+	ApiTrackers trackers;
+
+	// Everything good :)
+	if (decodeTrackers(errors, result, trackers) == API_OK)
 	{
-		// Everything good :)
-		if (strcmp(errors, "") == 0)
-		{
-			// Proceed XML result!
-			tinyxml2::XMLDocument doc;
-			tinyxml2::XMLNode *node;
-			tinyxml2::XMLError parseError;
+		// found someone?
+		bool found = false;
 
-			// Parse the xml data
-			parseError = doc.Parse(result);
+		// Tracker Loop
+		for (size_t i=0; i < trackers.trackerIDs.size(); i++)
+		{
+			// Build csteamid
+			CSteamID steamidTracker = CallDialog::steamIDtoCSteamID(trackers.trackerIDs[i]);
 
-			// Parsing good :)?
-			if (parseError == tinyxml2::XML_SUCCESS)
+			// Valid Tracker ID?
+			if (steamidTracker.IsValid())
 			{
-				// Goto xml child
-				node = doc.FirstChild();
-
-				// Goto CallAdmin_Trackers
-				if (node != NULL)
-				{
-					node = node->NextSibling();
-				}
-
-				// Found Trackers?
-				if (node != NULL)
-				{
-					// found someone?
-					bool found = false;
-					
-					// Tracker Loop
-					for (tinyxml2::XMLNode *node2 = node->FirstChild(); node2; node2 = node2->NextSibling())
-					{
-						// API Error?
-						if ((wxString)node2->Value() == "error")
-						{
-							error = (wxString)node2->FirstChild()->Value();
-
-							break;
-						}
-
-
-						// Search admin steamids
-						for (tinyxml2::XMLNode *node3 = node2->FirstChild(); node3; node3 = node3->NextSibling())
-						{
-							// Found steamid
-							if ((wxString)node3->Value() == "trackerID")
-							{
-								std::string steamidString = node3->FirstChild()->Value();
-
-								// Build csteamid
-								CSteamID steamidTracker = CallDialog::steamIDtoCSteamID((char*) steamidString.c_str());
-
-								// Valid Tracker ID?
-								if (steamidTracker.IsValid())
-								{
-									// Create Name Timer
-									new NameTimer(steamidTracker);
-
-									found = true;
-								}
-							}
-						}
-					}
-
-					// Have we found something?
-					if (found)
-					{
-						// We are finished :)
-						return;
-					}
-				}
-			}
-			else
-			{
-				// XML ERROR
-				error = "XML ERROR: Couldn't parse the trackers API!";
+				// Create Name Timer
+				new NameTimer(steamidTracker);
 
-				// Log Action
-				LogAction("XML Error in trackers API");
+				found = true;
 			}
 		}
-		else
-		{
-			// Curl error
-			error = errors;
 
-			// Log Action
-			LogAction("CURL Error " + error);
+		// Have we found something?
+		if (found)
+		{
+			// We are finished :)
+			return;
 		}
 	}
 	else
 	{
-		// Curl error
-		error = "Couldn't init. CURL connection";
+		error = trackers.getErrorMessage();
+
+		// Log Action
+		LOG((trackers.status == API_PARSE_ERROR) ? LOG_CATEGORY_PARSE : LOG_CATEGORY_NET, LOG_LEVEL_WARNING, "Couldn't get the Trackers").field("type", trackers.getErrorType()).field("error", trackers.getErrorText());
 	}
 
 
@@ -31,6 +31,10 @@
 // Precomp Header
 #include <wx/wxprec.h>
 
+// c++ libs
+#include <string>
+#include <vector>
+
 
 // We need WX
 #ifndef WX_PRECOMP
@@ -54,6 +58,11 @@ public:
 	void newTracker(wxString text) {trackerBox->Append(wxString::FromUTF8(text));}
 	void delTrackers() {trackerBox->Clear();}
 
+	// Lines as UTF-8
+	unsigned int getCount() {return trackerBox->GetCount();}
+	std::string getTracker(unsigned int i) {return (std::string)trackerBox->GetString(i).ToUTF8();}
+	void restoreTracker(const std::string& line) {trackerBox->Append(wxString::FromUTF8(line.c_str()));}
+
 protected:
 	void OnExit(wxCommandEvent& event);
 	void OnUpdate(wxCommandEvent& event);
@@ -64,8 +73,12 @@ protected:
 
 
 // Refresh the tracker list
-void refreshTrackers(char* error, wxString result, int x);
+void refreshTrackers(const char* error, std::vector<char>& result, long long x);
 void addTracker(wxString text);
 
+// Lines of the tracker list, to keep them over a restart
+std::vector<std::string> getTrackers();
+void restoreTrackers(const std::vector<std::string>& lines);
+
 
 #endif
\ No newline at end of file
@@ -30,6 +30,7 @@
 #include "config.h"
 #include "taskbar.h"
 #include "calladmin-client.h"
+#include "resources.h"
 
 
 
@@ -68,7 +69,7 @@ UpdateDialog::UpdateDialog() : wxDialog(NULL, wxID_ANY, "Update CallAdmin", wxDe
 	update_dialog = this;
 
 	// Action
-	LogAction("Start downloading Update");
+	LOG(LOG_CATEGORY_UPDATE, LOG_LEVEL_INFO, "Start downloading Update");
 
 
 	// Create Box
@@ -133,13 +134,7 @@ UpdateDialog::UpdateDialog() : wxDialog(NULL, wxID_ANY, "Update CallAdmin", wxDe
 
 
 	// Set Icon
-	#if defined(__WXMSW__)
-		SetIcon(wxIcon("calladmin_icon", wxBITMAP_TYPE_ICO_RESOURCE));
-	#else
-		wxLogNull nolog;
-
-		SetIcon(wxIcon(getAppPath("resources/calladmin_icon.ico"), wxBITMAP_TYPE_ICON));
-	#endif
+	SetIcon(getResourceIcon("calladmin_icon"));
 
 
 	// Show the Window
@@ -258,8 +253,10 @@ wxThread::ExitCode updateThread::Entry()
 			// File Pointer
 			FILE *fp;
 			
-			// Error
+			// Error, curl doesn't fill it for every failure
 			char ebuf[CURL_ERROR_SIZE];
+
+			ebuf[0] = '\0';
 			
 			// Path
 			wxString path = wxStandardPaths::Get().GetExecutablePath();
@@ -300,7 +297,7 @@ wxThread::ExitCode updateThread::Entry()
 			else
 			{
 				// Error ):
-				event.SetString(ebuf);
+				event.SetString((ebuf[0] != '\0') ? ebuf : curl_easy_strerror(res));
 			}
 
 			// Clean Curl